@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <gfx/ecs/ecs.hpp>
+#include <gfx/file/json.hpp>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+
+// Micro-benchmarks of the entity component system. Every benchmark is run for 10^min_exponent up to 10^max_exponent
+// entities, the best of all repetitions is reported in nanoseconds per operation.
+//
+// usage: gfx_ecs_bench [--min-exponent 3] [--max-exponent 7] [--repetitions 3] [--output results.json]
+
+namespace ecs = gfx::ecs;
+
+struct position : ecs::component<position>
+{
+    float x = 0.f, y = 0.f, z = 0.f;
+};
+
+struct velocity : ecs::component<velocity>
+{
+    float x = 1.f, y = 1.f, z = 1.f;
+};
+
+struct tag : ecs::component<tag>
+{
+    uint32_t value = 0;
+};
+
+struct move_system : ecs::system_base
+{
+    move_system() { add_component_type<position>(); }
+
+    void update(double delta, ecs::component_base** components) const override
+    {
+        auto& p = components[0]->as<position>();
+        p.x += float(delta);
+    }
+};
+
+struct integrate_system : ecs::system_base
+{
+    integrate_system()
+    {
+        add_component_type<position>();
+        add_component_type<velocity>();
+    }
+
+    void update(double delta, ecs::component_base** components) const override
+    {
+        auto&       p = components[0]->as<position>();
+        const auto& v = components[1]->as<velocity>();
+        p.x += v.x * float(delta);
+        p.y += v.y * float(delta);
+        p.z += v.z * float(delta);
+    }
+};
+
+struct counting_listener : ecs::listener
+{
+    explicit counting_listener(bool immediate)
+    {
+        add_component_id(position::id);
+        if (immediate) set_options(ecs::listener_option::immediate);
+    }
+
+    void on_add(ecs::entity e) override { ++added; }
+    void on_remove(ecs::entity e) override { ++removed; }
+
+    size_t added   = 0;
+    size_t removed = 0;
+};
+
+using clock_type = std::chrono::steady_clock;
+
+template<typename Setup, typename Run>
+double measure(int repetitions, size_t operations, Setup&& setup, Run&& run)
+{
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < repetitions; ++i)
+    {
+        auto       state = setup();
+        const auto start = clock_type::now();
+        run(state);
+        const auto end = clock_type::now();
+        best           = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+    }
+    return best / double(std::max<size_t>(operations, 1));
+}
+
+struct populated_world
+{
+    std::unique_ptr<ecs::ecs>       world = std::make_unique<ecs::ecs>();
+    std::vector<ecs::entity>        entities;
+    std::vector<ecs::entity_handle> handles;
+};
+
+populated_world populate(size_t count)
+{
+    populated_world result;
+    result.entities = result.world->create_entities(count, position{}, velocity{});
+    result.handles.assign(result.entities.begin(), result.entities.end());
+    return result;
+}
+
+nlohmann::json run_benchmarks(size_t count, int repetitions)
+{
+    nlohmann::json result;
+    result["entities"] = count;
+
+    const auto fresh = [] { return std::make_unique<ecs::ecs>(); };
+    const auto populated = [count] { return populate(count); };
+
+    result["create"] = measure(repetitions, count, fresh, [count](auto& world) {
+        for (size_t i = 0; i < count; ++i) world->create_entity(position{}, velocity{});
+    });
+    result["create_bulk"] = measure(repetitions, count, fresh, [count](auto& world) {
+        world->create_entities(count, position{}, velocity{});
+    });
+    result["destroy"] = measure(repetitions, count, populated, [](auto& state) {
+        for (const auto& e : state.entities) state.world->delete_entity(e);
+    });
+    result["destroy_bulk"] =
+            measure(repetitions, count, populated, [](auto& state) { state.world->delete_entities(state.handles); });
+
+    // Iteration runs on a world where every other entity has no velocity, so the multi-component system has to skip
+    // entities just like in a real scene.
+    {
+        auto  state = populate(count);
+        auto& world = *state.world;
+        world.create_entities(count, position{});
+
+        move_system      move;
+        integrate_system integrate;
+        ecs::system_list single_list;
+        ecs::system_list multi_list;
+        single_list.add(move);
+        multi_list.add(integrate);
+        world.update(0.0, multi_list);
+
+        const auto none = [] { return 0; };
+        result["iterate_single"] =
+                measure(repetitions, 2 * count, none, [&](int) { world.update(1.0, single_list); });
+        result["iterate_multi"] = measure(repetitions, count, none, [&](int) { world.update(1.0, multi_list); });
+    }
+
+    {
+        auto  state   = populate(count);
+        auto& world   = *state.world;
+        auto& handles = state.handles;
+        std::shuffle(handles.begin(), handles.end(), std::mt19937(42));
+
+        const ecs::ecs& view = world;
+        float           sum  = 0.f;
+        result["get_random"] = measure(repetitions, count, [] { return 0; }, [&](int) {
+            for (const auto& handle : handles) sum += view.get_component<position>(handle)->x;
+        });
+        result["get_random_mutable"] = measure(repetitions, count, [] { return 0; }, [&](int) {
+            for (const auto& handle : handles) sum += world.get_component<position>(handle)->x;
+        });
+        if (sum != 0.f) std::fprintf(stderr, "unexpected component values\n");
+
+        // One add and one remove per entity.
+        result["add_remove"] = measure(repetitions, 2 * count, [] { return 0; }, [&](int) {
+            for (const auto& handle : handles) world.add_components(handle, tag{});
+            for (const auto& handle : handles) world.remove_components<tag>(handle);
+            world.next_frame();
+            world.next_frame();
+        });
+    }
+
+    result["create_destroy"] = measure(repetitions, count, fresh, [count](auto& world) {
+        const auto entities = world->create_entities(count, position{}, velocity{});
+        for (const auto& e : entities) world->delete_entity(e);
+    });
+    // Listener overhead is the difference to the create_destroy timing.
+    for (const bool immediate : {false, true})
+    {
+        const auto setup = [] { return std::make_unique<ecs::ecs>(); };
+        counting_listener listener(immediate);
+        result[immediate ? "create_destroy_immediate_listener" : "create_destroy_listener"] =
+                measure(repetitions, count, setup, [&](auto& world) {
+                    world->add_listener(listener);
+                    const auto entities = world->create_entities(count, position{}, velocity{});
+                    world->flush_notifications();
+                    for (const auto& e : entities) world->delete_entity(e);
+                    world->flush_notifications();
+                    world->remove_listener(listener);
+                });
+        if (listener.added != listener.removed) std::fprintf(stderr, "listener missed notifications\n");
+    }
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    int         min_exponent = 3;
+    int         max_exponent = 7;
+    int         repetitions  = 3;
+    std::string output;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--min-exponent") == 0)
+            min_exponent = std::stoi(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--max-exponent") == 0)
+            max_exponent = std::stoi(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--repetitions") == 0)
+            repetitions = std::max(std::stoi(argv[i + 1]), 1);
+        else if (std::strcmp(argv[i], "--output") == 0)
+            output = argv[i + 1];
+        else
+        {
+            std::fprintf(stderr, "unknown argument %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    nlohmann::json results;
+    results["unit"]        = "ns/op";
+    results["repetitions"] = repetitions;
+    results["runs"]        = nlohmann::json::array();
+
+    size_t count = 1;
+    for (int i = 0; i < min_exponent; ++i) count *= 10;
+    for (int e = min_exponent; e <= max_exponent; ++e, count *= 10)
+    {
+        std::fprintf(stderr, "running %zu entities\n", count);
+        results["runs"].push_back(run_benchmarks(count, repetitions));
+    }
+
+    if (output.empty())
+        std::cout << results.dump(4) << '\n';
+    else
+        std::ofstream(output) << results.dump(4) << '\n';
+    return 0;
+}
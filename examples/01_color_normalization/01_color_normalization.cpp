@@ -16,11 +16,8 @@ axis_transformation principal_axis_transformation(const gfx::himage& image)
     const glm::dmat3 pomierski{0.5, -0.875, 1.5, -1.0, 0, 1.5, 0.5, 0.875, 1.5};
     const glm::dmat3 pomierski_inverse = inverse(pomierski);
 
-    const glm::dvec3 average_rgb = [&] {
-        glm::dvec4 color{0, 0, 0, 0};
-        image.each_pixel([&](const glm::uvec3& v) { color += image.load(v); });
-        return glm::dvec3(color / static_cast<double>(image.extents().count()));
-    }();
+    const gfx::image_statistics statistics  = gfx::statistics(image);
+    const glm::dvec3            average_rgb(statistics.mean);
 
     const glm::dvec3 average_pomierski = pomierski * average_rgb;
 
@@ -29,15 +26,7 @@ axis_transformation principal_axis_transformation(const gfx::himage& image)
     const glm::dmat4 translate_pomierski      = translate(-average_pomierski);
     const glm::dmat4 translate_back_pomierski = translate(main_axis_pomierski * length(average_pomierski));
 
-    const glm::dmat3 covariance_rgb = [&] {
-        glm::dmat3 matrix(0.0);
-        for (int i = 0; i < image.extents().count(); ++i)
-        {
-            const glm::dvec3 error = glm::dvec3(image.load(image.extents().subpixel(i))) - average_rgb;
-            matrix += outerProduct(error, error);
-        }
-        return matrix / static_cast<double>(image.extents().count());
-    }();
+    const glm::dmat3 covariance_rgb = statistics.covariance;
 
     const glm::dmat3 covariance_pomierski = pomierski * covariance_rgb * transpose(pomierski);
 
@@ -102,11 +91,7 @@ void executable::run()
     const gfx::sampler sampler;
 
     axis_transformation trafo   = principal_axis_transformation(picture);
-    glm::vec3           average = [&] {
-        glm::dvec4 color{0, 0, 0, 0};
-        picture.each_pixel([&](const glm::uvec3& v) { color += picture.load(v); });
-        return glm::dvec3(color / static_cast<double>(picture.extents().count()));
-    }();
+    glm::vec3           average = glm::vec3(gfx::statistics(picture).mean);
 
     gfx::image            grid(gfx::himage(gfx::rgba8unorm, "grid.jpg"));
     const gfx::image_view grid_view(gfx::imgv_type::image2d, grid);
@@ -252,11 +237,7 @@ void executable::run()
                 main_bindings.bind(1, texture_view, sampler);
 
                 trafo   = principal_axis_transformation(picture);
-                average = [&] {
-                    glm::dvec4 color{0, 0, 0, 0};
-                    picture.each_pixel([&](const glm::uvec3& v) { color += picture.load(v); });
-                    return glm::dvec3(color / static_cast<double>(picture.extents().count()));
-                }();
+                average = glm::vec3(gfx::statistics(picture).mean);
             }
         }
         ImGui::SameLine();
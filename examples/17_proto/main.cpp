@@ -95,20 +95,21 @@ void executable::run()
 	unique_mesh grass_tuft = prototypes.allocate_mesh_unique(grass_file.mesh.vertices, grass_file.mesh.indices);
 	std::array grass_meshes = { grass_tuft.get() };
 	unique_prototype grass = prototypes.allocate_prototype_unique("Grass", grass_meshes);
-	for (auto i = 0ull; i < 10000; ++i)
+	prototype_component grass_proto_component;
+	grass_proto_component.proto = grass.get();
+	grass_proto_component.properties[0].visible = true;
+	grass_proto_component.properties[0].color = glm::vec4(0.4f, 1.f, 0.15f, 1.f);
+
+	const std::vector<prototype_component> grass_protos(10000, grass_proto_component);
+	std::vector<gfx::transform_component>  grass_transforms(grass_protos.size());
+	for (auto& transform : grass_transforms)
 	{
-		prototype_component grass_proto_component;
-		grass_proto_component.proto = grass.get();
-		grass_proto_component.properties[0].visible = true;
-		grass_proto_component.properties[0].color = glm::vec4(0.4f, 1.f, 0.15f, 1.f);
-
-		gfx::transform_component transform;
 		transform.value.position = glm::vec3(200.f * dist(gen) - 100.f, 0.f, 200.f * dist(gen) - 100.f);
 		transform.value.position.y = main_terrain.terrain_height({ transform.value.position.x, transform.value.position.z });
 		transform.value.rotation = glm::angleAxis(glm::radians(dist(gen) * 180.f), glm::vec3(0, 1, 0)) * glm::angleAxis(glm::radians(90.f), glm::vec3(-1, 0, 0));
 		transform.value.scale = glm::vec3(0.2f+1.5f * dist(gen));
-		ecs.create_entity(grass_proto_component, transform);
 	}
+	ecs.create_entities(grass_protos, grass_transforms);
 
     gfx::ecs::system_list graphics_systems;
     graphics_systems.add(proto_system);
@@ -178,6 +179,7 @@ void executable::run()
         prototypes.clear_commands();
         ecs.update(context->delta(), movement_systems);
         ecs.update(context->delta(), graphics_systems);
+        ecs.next_frame();
 		prototypes.update(*current_command);
 
         mesh_sets[context->swapchain()->current_image()].bind(0, prototypes.current_commands());
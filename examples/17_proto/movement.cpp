@@ -3,8 +3,9 @@
 
 movement_system::movement_system()
 {
-    add_component_type(gfx::transform_component::id);
+    add_component_type(gfx::transform_component::id, gfx::ecs::component_flag::mutated);
     add_component_type(movement_component::id);
+    set_options(gfx::ecs::system_option::thread_safe);
 }
 
 void movement_system::update(double delta, gfx::ecs::component_base** components) const
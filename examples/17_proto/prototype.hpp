@@ -1,6 +1,7 @@
 #pragma once
 
 #include <gfx/gfx.hpp>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
@@ -180,15 +181,31 @@ public:
 		_draw_counts[_current_instance] = 0;
     }
 
+    // Thread-safe: the draw commands are assembled locally and only appended under the lock.
     void enqueue(prototype* p, const gfx::transform& t, gfx::span<prototype_mesh_property> properties)
     {
+        std::array<draw_command, prototype::max_submeshes> commands;
+        enqueue(gfx::span<const draw_command>(commands.data(), make_commands(p, t, properties, commands.data())));
+    }
+
+    void enqueue(gfx::span<const draw_command> commands)
+    {
+        std::unique_lock<std::mutex> lock(_enqueue_mutex);
+        _draw_counts[_current_instance] += commands.size();
+        _draw_stage_pre.insert(_draw_stage_pre.end(), commands.begin(), commands.end());
+    }
+
+    // Writes at most prototype::max_submeshes commands to "out" and returns how many were written.
+    ptrdiff_t make_commands(prototype* p, const gfx::transform& t, gfx::span<prototype_mesh_property> properties, draw_command* out) const
+    {
+        ptrdiff_t count = 0;
+
         int i = 0;
         for (const auto& m : p->meshes)
         {
             if (!m) break;
             if (!properties[i].visible) continue;
-			++_draw_counts[_current_instance];
-            draw_command& c           = _draw_stage_pre.emplace_back();
+            draw_command& c           = out[count++];
             c.indirect.base_index     = m->base->_base_index;
             c.indirect.base_vertex    = m->base->_base_vertex;
             c.indirect.index_count    = m->base->_index_count;
@@ -200,6 +217,7 @@ public:
 
             ++i;
         }
+        return count;
     }
 
     void update(gfx::commands& cmd)
@@ -240,6 +258,7 @@ private:
     ptrdiff_t                                _current_instance = 0;
     bool                                     _cleared          = true;
 	std::vector<draw_command>               _draw_stage_pre;
+	std::mutex                              _enqueue_mutex;
 	std::array<gfx::hbuffer<draw_command>, max_buffer_count> _draw_stages{};
 	std::array<size_t, max_buffer_count> _draw_counts {0};
     std::array<gfx::buffer<draw_command>, max_buffer_count> _draw_commands{gfx::buffer<draw_command>(gfx::buffer_usage::all),
@@ -17,14 +17,21 @@ public:
     {
         add_component_type<prototype_component>();
         add_component_type<gfx::transform_component>();
+        set_options(gfx::ecs::system_option::thread_safe);
     }
 
-    void update(double delta, gfx::ecs::component_base** components) const override
+    void update_batch(double delta, const gfx::ecs::component_batch& batch) const override
     {
-        auto& proto = components[0]->as<prototype_component>();
-        auto& trans = components[1]->as<gfx::transform_component>();
+        std::vector<prototype_manager::draw_command> commands(batch.size() * prototype::max_submeshes);
+        ptrdiff_t                                    count = 0;
+        for (auto i = 0ull; i < batch.size(); ++i)
+        {
+            auto& proto = batch.get<prototype_component>(0, i);
+            auto& trans = batch.get<gfx::transform_component>(1, i);
 
-        if (proto.proto) _manager.enqueue(proto.proto, trans.value, proto.properties);
+            if (proto.proto) count += _manager.make_commands(proto.proto, trans.value, proto.properties, commands.data() + count);
+        }
+        _manager.enqueue(gfx::span<const prototype_manager::draw_command>(commands.data(), count));
     }
 
 private:
@@ -89,6 +89,7 @@ bool executable::frame()
 		ImGui::End();
 
 		ecs.update(context->delta(), control_systems);
+		ecs.next_frame();
 
 		const gfx::u32 frame = context->swapchain()->current_image();
 		current_command      = &render_commands[frame];
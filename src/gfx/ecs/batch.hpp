@@ -0,0 +1,67 @@
+#pragma once
+
+#include "component.hpp"
+#include <cassert>
+#include <gfx/type.hpp>
+
+namespace gfx {
+inline namespace v1 {
+namespace ecs {
+class component_batch
+{
+public:
+    struct column
+    {
+        std::byte* data   = nullptr;    // First component of the batch, only set if the column is stored contiguously.
+        size_t     stride = 0;
+    };
+
+    component_batch(size_t size, size_t type_count, component_base** rows, const column* columns, uint32_t tick = 0)
+          : _size(size), _type_count(type_count), _rows(rows), _columns(columns), _tick(tick)
+    {}
+
+    size_t   size() const noexcept { return _size; }
+    size_t   type_count() const noexcept { return _type_count; }
+    uint32_t tick() const noexcept { return _tick; }
+
+    void mark_changed(size_t type_index, size_t index) const noexcept { get(type_index, index)->changed_tick = _tick; }
+
+    bool has_rows() const noexcept { return _rows != nullptr; }
+    bool contiguous(size_t type_index) const noexcept { return _columns[type_index].data != nullptr; }
+
+    component_base** row(size_t index) const noexcept
+    {
+        assert(has_rows());
+        return &_rows[index * _type_count];
+    }
+
+    component_base* get(size_t type_index, size_t index) const noexcept
+    {
+        if (contiguous(type_index))
+            return reinterpret_cast<component_base*>(_columns[type_index].data + index * _columns[type_index].stride);
+        return row(index)[type_index];
+    }
+
+    template<typename T>
+    T& get(size_t type_index, size_t index) const noexcept
+    {
+        return get(type_index, index)->template as<T>();
+    }
+
+    template<typename T>
+    gfx::span<T> span(size_t type_index) const noexcept
+    {
+        assert(contiguous(type_index) && _columns[type_index].stride == sizeof(T));
+        return gfx::span<T>(reinterpret_cast<T*>(_columns[type_index].data), static_cast<ptrdiff_t>(_size));
+    }
+
+private:
+    size_t                 _size;
+    size_t                 _type_count;
+    component_base**       _rows;
+    const column*          _columns;
+    uint32_t               _tick;
+};
+}    // namespace ecs
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,57 @@
+#include "command_buffer.hpp"
+
+namespace gfx {
+inline namespace v1 {
+namespace ecs {
+command_buffer::~command_buffer()
+{
+    clear();
+}
+
+void command_buffer::delete_entity(entity_handle handle)
+{
+    record(command_type::delete_entity, handle, nullptr, nullptr, 0);
+}
+
+bool command_buffer::empty() const
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _commands.empty();
+}
+
+void command_buffer::clear()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    destroy(_entries);
+    _commands.clear();
+}
+
+void command_buffer::destroy(std::vector<entry>& entries)
+{
+    for (const auto& e : entries)
+    {
+        if (!e.component) continue;
+        component_base::get_deleter(e.id)(e.component);
+        ::operator delete(e.component, std::align_val_t(component_base::type_alignment(e.id)));
+    }
+    entries.clear();
+}
+
+void command_buffer::record(command_type type, entity_handle handle, const component_base** components, const id_t* ids, size_t count)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _commands.push_back(command{type, handle, _entries.size(), count});
+    for (auto i = 0ull; i < count; ++i)
+    {
+        component_base* copy = nullptr;
+        if (components)
+        {
+            const auto& info = component_base::type_info(ids[i]);
+            copy             = info.creator(::operator new(info.size, std::align_val_t(info.alignment)), null_entity, components[i]);
+        }
+        _entries.push_back(entry{ids[i], copy});
+    }
+}
+}    // namespace ecs
+}    // namespace v1
+}    // namespace gfx
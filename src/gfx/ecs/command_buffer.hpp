@@ -0,0 +1,88 @@
+#pragma once
+
+#include "entity.hpp"
+#include <mutex>
+
+namespace gfx {
+inline namespace v1 {
+namespace ecs {
+// Records structural changes (entity creation and deletion, adding and removing components) so they can be requested
+// from systems running in parallel and applied later at a sync point by ecs::execute. Recording is thread-safe.
+class command_buffer
+{
+public:
+    command_buffer() = default;
+    ~command_buffer();
+
+    command_buffer(const command_buffer& other) = delete;
+    command_buffer& operator=(const command_buffer& other) = delete;
+
+    template<typename... Components, typename = std::void_t<traits::enable_if_component_t<Components>...>>
+    void create_entity(const Components&... components)
+    {
+        if constexpr (sizeof...(Components) == 0)
+            record(command_type::create_entity, null_entity, nullptr, nullptr, 0);
+        else
+        {
+            const component_base* css[]{static_cast<const component_base*>(&components)...};
+            id_t                  ids[]{components.id...};
+            record(command_type::create_entity, null_entity, css, ids, sizeof...(Components));
+        }
+    }
+
+    template<typename... Components, typename = std::void_t<traits::enable_if_component_t<Components>...>>
+    void add_components(entity_handle handle, const Components&... components)
+    {
+        const component_base* css[]{static_cast<const component_base*>(&components)...};
+        id_t                  ids[]{components.id...};
+        record(command_type::add_components, handle, css, ids, sizeof...(Components));
+    }
+
+    template<typename Component, typename... Components>
+    void remove_components(entity_handle handle)
+    {
+        id_t ids[]{Component::id, Components::id...};
+        record(command_type::remove_components, handle, nullptr, ids, 1 + sizeof...(Components));
+    }
+
+    void delete_entity(entity_handle handle);
+
+    bool empty() const;
+    void clear();
+
+private:
+    friend class ecs;
+
+    enum class command_type
+    {
+        create_entity,
+        delete_entity,
+        add_components,
+        remove_components
+    };
+
+    struct command
+    {
+        command_type  type;
+        entity_handle entity;
+        size_t        first;    // First entry in _entries.
+        size_t        count;
+    };
+
+    struct entry
+    {
+        id_t            id;
+        component_base* component;    // Recorded copy of the component, nullptr for removals.
+    };
+
+    void record(command_type type, entity_handle handle, const component_base** components, const id_t* ids, size_t count);
+    // Destroys the recorded component copies.
+    static void destroy(std::vector<entry>& entries);
+
+    mutable std::mutex   _mutex;
+    std::vector<command> _commands;
+    std::vector<entry>   _entries;
+};
+}    // namespace ecs
+}    // namespace v1
+}    // namespace gfx
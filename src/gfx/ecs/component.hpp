@@ -1,6 +1,13 @@
 #pragma once
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 namespace gfx {
@@ -10,19 +17,58 @@ enum class id_t : uint64_t
 {
 };
 struct component_base;
-using entity_handle                       = void*;
-constexpr const entity_handle null_entity = nullptr;
-using component_creator_fun = ptrdiff_t (*)(std::vector<std::byte>& memory, entity_handle entity, const component_base* base_component);
+
+// Generational entity id. The index addresses a pooled entity slot, the generation is incremented every time that slot is
+// freed, so a handle outliving its entity can be detected by comparing generations.
+struct entity_handle
+{
+    uint32_t index      = ~0u;
+    uint32_t generation = 0;
+
+    constexpr explicit operator bool() const noexcept { return index != ~0u; }
+    constexpr uint64_t value() const noexcept { return (uint64_t(generation) << 32) | index; }
+
+    friend constexpr bool operator==(const entity_handle& a, const entity_handle& b) noexcept { return a.value() == b.value(); }
+    friend constexpr bool operator!=(const entity_handle& a, const entity_handle& b) noexcept { return a.value() != b.value(); }
+    friend constexpr bool operator<(const entity_handle& a, const entity_handle& b) noexcept { return a.value() < b.value(); }
+};
+constexpr const entity_handle null_entity{};
+
+constexpr size_t max_component_types = 256;
+using component_signature            = std::bitset<max_component_types>;
+
+// Copy-constructs a component into uninitialized memory.
+using component_creator_fun = component_base* (*)(void* memory, entity_handle entity, const component_base* base_component);
+// Move-constructs a component into uninitialized memory and destroys the source.
+using component_mover_fun   = component_base* (*)(void* memory, component_base* base_component);
 using component_deleter_fun = void (*)(component_base* base_component);
 
+struct component_type_info
+{
+    component_creator_fun creator;
+    component_mover_fun   mover;
+    component_deleter_fun deleter;
+    size_t                size;
+    size_t                alignment;
+    const char*           name;                  // Implementation defined type name, used to match types in snapshots.
+    bool                  trivially_copyable;
+};
+
 struct component_base
 {
     entity_handle entity = null_entity;
+    // Change ticks of the owning ecs, set when the component is added to an entity or marked as changed.
+    uint32_t added_tick   = 0;
+    uint32_t changed_tick = 0;
 
-    static auto   get_creator(id_t id) { return std::get<component_creator_fun>(types()[static_cast<size_t>(id)]); }
-    static auto   get_deleter(id_t id) { return std::get<component_deleter_fun>(types()[static_cast<size_t>(id)]); }
-    static size_t type_size(id_t id) { return std::get<size_t>(types()[static_cast<size_t>(id)]); }
-    static bool   is_valid(id_t id) { return static_cast<size_t>(id) < types().size(); }
+    static const component_type_info& type_info(id_t id) { return types()[static_cast<size_t>(id)]; }
+    static auto                       get_creator(id_t id) { return type_info(id).creator; }
+    static auto                       get_mover(id_t id) { return type_info(id).mover; }
+    static auto                       get_deleter(id_t id) { return type_info(id).deleter; }
+    static size_t                     type_size(id_t id) { return type_info(id).size; }
+    static size_t                     type_alignment(id_t id) { return type_info(id).alignment; }
+    static bool                       is_valid(id_t id) { return static_cast<size_t>(id) < types().size(); }
+    static size_t                     type_count() { return types().size(); }
 
     template<typename T>
     T& as()
@@ -46,29 +92,37 @@ struct component_base
     }
 
 protected:
-    static id_t register_type(component_creator_fun create, component_deleter_fun deleter, size_t size)
+    static id_t register_type(const component_type_info& info)
     {
+        if (types().size() >= max_component_types) throw std::length_error("Too many component types registered.");
         const id_t id{types().size()};
-        types().emplace_back(create, deleter, size);
+        types().push_back(info);
         return id;
     }
 
 private:
-    static auto types() -> std::vector<std::tuple<component_creator_fun, component_deleter_fun, size_t>>&
+    static auto types() -> std::vector<component_type_info>&
     {
-        static std::vector<std::tuple<component_creator_fun, component_deleter_fun, size_t>> t;
+        static std::vector<component_type_info> t;
         return t;
     }
 };
 
 template<typename C>
-ptrdiff_t create(std::vector<std::byte>& memory, entity_handle entity, const component_base* base_component)
+component_base* create(void* memory, entity_handle entity, const component_base* base_component)
 {
-    const ptrdiff_t ptr = memory.size();
-    memory.resize(memory.size() + C::size);
-    C* component      = new (&memory[ptr]) C(*static_cast<const C*>(base_component));
+    C* component      = new (memory) C(*static_cast<const C*>(base_component));
     component->entity = entity;
-    return ptr;
+    return component;
+}
+
+template<typename C>
+component_base* move(void* memory, component_base* base_component)
+{
+    C* source    = static_cast<C*>(base_component);
+    C* component = new (memory) C(std::move(*source));
+    source->~C();
+    return component;
 }
 
 template<typename C>
@@ -93,7 +147,8 @@ struct component : component_base
 template<typename T>
 const size_t component<T>::size = sizeof(T);
 template<typename T>
-const id_t component<T>::id = register_type(create<T>, destroy<T>, size);
+const id_t component<T>::id = register_type(
+    {create<T>, move<T>, destroy<T>, sizeof(T), alignof(T), typeid(T).name(), std::is_trivially_copyable_v<T>});
 template<typename T>
 const component_creator_fun component<T>::creator = create<T>;
 template<typename T>
@@ -0,0 +1,165 @@
+#include "hierarchy.hpp"
+
+namespace gfx {
+inline namespace v1 {
+transform_hierarchy::topology_listener::topology_listener(bool& dirty, ecs::id_t id) : _dirty(dirty)
+{
+    add_component_id(id);
+    // Only sets a flag, so there is no reason to queue notifications.
+    set_options(ecs::listener_option::immediate);
+}
+
+transform_hierarchy::transform_hierarchy(ecs::ecs& ecs)
+      : _ecs(ecs)
+      , _transform_listener(_topology_dirty, transform_component::id)
+      , _parent_listener(_topology_dirty, parent_component::id)
+      , _query(ecs.register_query({transform_component::id, parent_component::id}, {{}, ecs::component_flag::optional}))
+{
+    _ecs.add_listener(_transform_listener);
+    _ecs.add_listener(_parent_listener);
+}
+
+transform_hierarchy::~transform_hierarchy()
+{
+    _ecs.remove_listener(_transform_listener);
+    _ecs.remove_listener(_parent_listener);
+}
+
+void transform_hierarchy::rebuild()
+{
+    const auto      entities = _query.entities();
+    const auto      count    = static_cast<size_t>(entities.size());
+    const ecs::ecs& ecs      = _ecs;
+
+    // Parent positions in query order.
+    _indices.clear();
+    for (auto i = 0ull; i < count; ++i)
+    {
+        const auto index = entities[static_cast<ptrdiff_t>(i)].index;
+        if (index >= _indices.size()) _indices.resize(index + 1, npos);
+        _indices[index] = static_cast<uint32_t>(i);
+    }
+    std::vector<uint32_t> parents(count, npos);
+    _links.clear();
+    _link_targets.clear();
+    for (auto i = 0ull; i < count; ++i)
+    {
+        const auto* p = ecs.get_component<parent_component>(entities[static_cast<ptrdiff_t>(i)]);
+        if (p)
+        {
+            _links.push_back(p);
+            _link_targets.push_back(p->parent);
+        }
+        if (p && _query.contains(p->parent)) parents[i] = _indices[p->parent.index];
+    }
+
+    // Depth of every entity, walking up each chain only until an entity of known depth is found.
+    constexpr uint32_t    unknown  = ~0u;
+    constexpr uint32_t    visiting = ~0u - 1;
+    std::vector<uint32_t> depth(count, unknown);
+    std::vector<uint32_t> chain;
+    uint32_t              max_depth = 0;
+    for (auto i = 0ull; i < count; ++i)
+    {
+        chain.clear();
+        for (auto current = static_cast<uint32_t>(i); depth[current] == unknown; current = parents[current])
+        {
+            depth[current] = visiting;
+            chain.push_back(current);
+            if (parents[current] == npos) break;
+        }
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        {
+            // Cycles are broken by treating the entity closing the cycle as a root.
+            if (parents[*it] != npos && depth[parents[*it]] == visiting) parents[*it] = npos;
+            depth[*it] = parents[*it] == npos ? 0 : depth[parents[*it]] + 1;
+        }
+        max_depth = std::max(max_depth, depth[i]);
+    }
+
+    // Counting sort by depth, so every level is a contiguous range following the level of its parents.
+    _levels.assign(max_depth + 2, 0);
+    for (const auto d : depth) ++_levels[d + 1];
+    for (auto l = 1ull; l < _levels.size(); ++l) _levels[l] += _levels[l - 1];
+
+    std::vector<uint32_t> order(count);
+    std::vector<uint32_t> position(count);
+    std::vector<size_t>   next(_levels.begin(), _levels.end() - 1);
+    for (auto i = 0ull; i < count; ++i)
+    {
+        position[i]        = static_cast<uint32_t>(next[depth[i]]++);
+        order[position[i]] = static_cast<uint32_t>(i);
+    }
+
+    _entities.resize(count);
+    _locals.resize(count);
+    _parents.resize(count);
+    for (auto i = 0ull; i < count; ++i)
+    {
+        const auto e      = entities[static_cast<ptrdiff_t>(order[i])];
+        const auto parent = parents[order[i]];
+        _entities[i]      = e;
+        _locals[i]        = ecs.get_component<transform_component>(e);
+        _parents[i]       = parent == npos ? npos : position[parent];
+        _indices[e.index] = static_cast<uint32_t>(i);
+    }
+
+    _world.resize(count);
+    _dirty.assign(count, 1);
+}
+
+void transform_hierarchy::update()
+{
+    const uint32_t since = _last_tick;
+
+    // Reassigning a parent is not a structural change, so the parents seen at the last rebuild are compared.
+    for (auto i = 0ull; i < _links.size() && !_topology_dirty; ++i)
+        if (_links[i]->parent != _link_targets[i]) _topology_dirty = true;
+    if (_topology_dirty)
+    {
+        rebuild();
+        _topology_dirty = false;
+    }
+
+    for (auto l = 0ull; l + 1 < _levels.size(); ++l)
+    {
+        const auto begin = static_cast<int64_t>(_levels[l]);
+        const auto end   = static_cast<int64_t>(_levels[l + 1]);
+
+#pragma omp parallel for schedule(static) if (end - begin > 1024)
+        for (int64_t i = begin; i < end; ++i)
+        {
+            const auto parent = _parents[i];
+            const bool dirty  = _dirty[i] || _locals[i]->changed_tick >= since || (parent != npos && _dirty[parent]);
+            _dirty[i]         = dirty;
+            if (dirty) _world[i] = parent == npos ? _locals[i]->value.matrix() : _world[parent] * _locals[i]->value.matrix();
+        }
+    }
+    std::fill(_dirty.begin(), _dirty.end(), uint8_t(0));
+    _last_tick = _ecs.tick();
+}
+
+gfx::span<const glm::mat4> transform_hierarchy::world_matrices() const noexcept
+{
+    return gfx::span<const glm::mat4>(_world.data(), static_cast<ptrdiff_t>(_world.size()));
+}
+
+gfx::span<const ecs::entity_handle> transform_hierarchy::entities() const noexcept
+{
+    return gfx::span<const ecs::entity_handle>(_entities.data(), static_cast<ptrdiff_t>(_entities.size()));
+}
+
+const glm::mat4* transform_hierarchy::world_matrix(ecs::entity_handle e) const noexcept
+{
+    const auto index = index_of(e);
+    return index == npos ? nullptr : &_world[index];
+}
+
+uint32_t transform_hierarchy::index_of(ecs::entity_handle e) const noexcept
+{
+    if (!e || e.index >= _indices.size()) return npos;
+    const auto index = _indices[e.index];
+    return index < _entities.size() && _entities[index] == e ? index : npos;
+}
+}    // namespace v1
+}    // namespace gfx
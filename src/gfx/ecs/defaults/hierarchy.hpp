@@ -0,0 +1,71 @@
+#pragma once
+
+#include "camera.hpp"
+
+namespace gfx {
+inline namespace v1 {
+// Attaches the transform of an entity to the transform of its parent entity.
+struct parent_component : ecs::component<parent_component>
+{
+    ecs::entity_handle parent = ecs::null_entity;
+};
+// Keeps hierarchies intact when they are restored from a snapshot.
+inline const bool parent_component_reference = ecs::register_entity_reference(&parent_component::parent);
+
+// Computes the world matrices of all entities with a transform_component, composing the transforms along the parent
+// hierarchy. Entities are processed level by level, each level in parallel, and only the subtrees containing a changed
+// transform are recomputed. The resulting matrices are stored contiguously.
+class transform_hierarchy
+{
+public:
+    explicit transform_hierarchy(ecs::ecs& ecs);
+    ~transform_hierarchy();
+
+    transform_hierarchy(const transform_hierarchy& other) = delete;
+    transform_hierarchy& operator=(const transform_hierarchy& other) = delete;
+
+    void update();
+
+    // World matrices of all transformed entities, ordered by hierarchy level.
+    gfx::span<const glm::mat4>          world_matrices() const noexcept;
+    gfx::span<const ecs::entity_handle> entities() const noexcept;
+    const glm::mat4*                    world_matrix(ecs::entity_handle e) const noexcept;
+
+    // Position of the entity in world_matrices(), npos if it has no transform.
+    constexpr static uint32_t npos = ~0u;
+    uint32_t                  index_of(ecs::entity_handle e) const noexcept;
+
+private:
+    struct topology_listener : ecs::listener
+    {
+        topology_listener(bool& dirty, ecs::id_t id);
+
+        void on_add_batch(gfx::span<const ecs::entity> entities) override { _dirty = true; }
+        void on_remove_batch(gfx::span<const ecs::entity> entities) override { _dirty = true; }
+        void on_add_component_batch(gfx::span<const ecs::entity> entities, ecs::id_t id) override { _dirty = true; }
+        void on_remove_component_batch(gfx::span<const ecs::entity> entities, ecs::id_t id) override { _dirty = true; }
+
+        bool& _dirty;
+    };
+
+    void rebuild();
+
+    ecs::ecs&         _ecs;
+    bool              _topology_dirty = true;
+    topology_listener _transform_listener;
+    topology_listener _parent_listener;
+    ecs::query&       _query;
+    uint32_t          _last_tick = 0;
+
+    std::vector<ecs::entity_handle>         _entities;
+    std::vector<const transform_component*> _locals;
+    std::vector<const parent_component*>    _links;      // Parent components of all entities with a parent.
+    std::vector<ecs::entity_handle>         _link_targets;
+    std::vector<uint32_t>                   _parents;    // Position of the parent, npos for roots.
+    std::vector<size_t>                     _levels;     // Offsets of the hierarchy levels in _entities.
+    std::vector<uint32_t>                   _indices;    // Position of each entity index in _entities.
+    std::vector<uint8_t>                    _dirty;
+    std::vector<glm::mat4>                  _world;
+};
+}    // namespace v1
+}    // namespace gfx
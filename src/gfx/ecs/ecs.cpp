@@ -22,90 +22,188 @@ void entity_deleter::operator()(entity* e) const
     e->_ecs->delete_entity(*e);
 }
 
-ecs::~ecs()
-{
-    for (auto&& cp : _components)
-    {
-        const size_t size    = component_base::type_size(cp.first);
-        const auto   deleter = component_base::get_deleter(cp.first);
+ecs::~ecs() = default;
 
-        for (auto i = 0ull; i < cp.second.size(); i += size) deleter(reinterpret_cast<component_base*>(&cp.second[i]));
-    }
+void ecs::add_listener(listener& l)
+{
+    _listeners.push_back(listener_entry{&l, {}});
+}
 
-    for (auto&& e : _entities) delete e;
+void ecs::remove_listener(listener& l)
+{
+    _listeners.erase(std::remove_if(_listeners.begin(), _listeners.end(), [&](const listener_entry& e) { return e.target == &l; }),
+                     _listeners.end());
 }
 
-void ecs::add_listener(listener& l)
+void ecs::flush_notifications()
 {
-    _listeners.push_back(&l);
+    std::vector<notification> pending;
+    std::vector<entity>       entities;
+    for (auto& l : _listeners)
+    {
+        // Notifications caused by the listener itself are queued for the next flush.
+        pending.swap(l.pending);
+        for (auto begin = pending.begin(); begin != pending.end();)
+        {
+            const auto end = std::find_if(begin, pending.end(), [&](const notification& n) { return n.type != begin->type || n.id != begin->id; });
+            entities.clear();
+            for (auto it = begin; it != end; ++it) entities.push_back(entity{this, it->entity});
+            deliver(*l.target, begin->type, begin->id, entities);
+            begin = end;
+        }
+        pending.clear();
+    }
 }
 
 entity ecs::create_entity(const component_base** components, const id_t* component_ids, size_t count)
 {
-    const auto e   = new indexed_entity();
-    auto       hnd = static_cast<entity_handle>(e);
-
     for (auto i = 0u; i < count; ++i)
     {
         if (!component_base::is_valid(component_ids[i]))
         {
             gfx::elog("ecs") << "Invalid component type ID detected: " << color_fg(145)
                              << static_cast<std::underlying_type_t<id_t>>(component_ids[i]);
-            delete e;
             return entity{this, null_entity};
         }
-        add_component_impl(hnd, component_ids[i], components[i]);
     }
 
-    e->first = static_cast<uint32_t>(_entities.size());
-    _entities.push_back(e);
+    const entity_handle hnd = allocate_entity();
+    // Creation is reported through on_add only, no per-component notifications are sent.
+    for (auto i = 0u; i < count; ++i)
+    {
+        storage(component_ids[i]).emplace(hnd, components[i], _tick);
+        _entities[hnd.index].signature.set(static_cast<size_t>(component_ids[i]));
+    }
+    update_queries(hnd);
 
     const entity result{this, hnd};
     for (auto& l : _listeners)
+        if (matches(*l.target, _entities[hnd.index].signature)) notify(l, notification_type::add, hnd);
+
+    return result;
+}
+
+std::vector<entity> ecs::create_entities(size_t count, const component_base** components, const size_t* strides,
+                                         const id_t* component_ids, size_t type_count)
+{
+    std::vector<entity> result;
+    component_signature signature;
+    for (auto i = 0u; i < type_count; ++i)
     {
-        if (![&] {
-                for (const auto id : l->component_ids())
-                    if (![&] {
-                            for (const auto& x : as_entity(hnd))
-                                if (id == x.first) return true;
-                            return false;
-                        }())
-                        return false;
-                return true;
-            }())
-            break;
-        l->on_add(result);
+        if (!component_base::is_valid(component_ids[i]))
+        {
+            gfx::elog("ecs") << "Invalid component type ID detected: " << color_fg(145)
+                             << static_cast<std::underlying_type_t<id_t>>(component_ids[i]);
+            return result;
+        }
+        signature.set(static_cast<size_t>(component_ids[i]));
+    }
+
+    result.reserve(count);
+    _entities.reserve(_entity_count + count);
+    uint32_t max_index = 0;
+    for (auto i = 0ull; i < count; ++i)
+    {
+        const entity_handle hnd = allocate_entity();
+        _entities[hnd.index].signature = signature;
+        max_index                      = std::max(max_index, hnd.index);
+        result.push_back(entity{this, hnd});
+    }
+
+    for (auto t = 0u; t < type_count; ++t)
+    {
+        auto& s = storage(component_ids[t]);
+        s.reserve(s.size() + count, max_index);
+
+        const auto* source = reinterpret_cast<const std::byte*>(components[t]);
+        for (auto i = 0ull; i < count; ++i)
+            s.emplace(result[i]._handle, reinterpret_cast<const component_base*>(source + i * strides[t]), _tick);
+    }
+
+    for (auto& q : _queries)
+        if (q->matches(signature))
+            for (const auto& e : result) q->insert(e._handle);
+
+    for (auto& l : _listeners)
+    {
+        if (!matches(*l.target, signature)) continue;
+        if (l.target->options().has(listener_option::immediate))
+            l.target->on_add_batch(result);
+        else
+            for (const auto& e : result) l.pending.push_back(notification{notification_type::add, {}, e._handle});
     }
 
     return result;
 }
 
-void ecs::delete_entity(entity handle)
+void ecs::delete_entities(gfx::span<const entity_handle> handles)
+{
+    for (const auto& handle : handles) delete_entity({this, handle});
+}
+
+void ecs::execute(command_buffer& commands)
 {
-    auto& e = as_entity(handle._handle);
+    // The commands are taken out of the buffer before they are applied, so listeners may record new ones into it. Those
+    // are applied by the next execute.
+    std::vector<command_buffer::command> recorded;
+    std::vector<command_buffer::entry>   recorded_entries;
+    {
+        std::unique_lock<std::mutex> lock(commands._mutex);
+        recorded.swap(commands._commands);
+        recorded_entries.swap(commands._entries);
+    }
 
-    for (auto& l : _listeners)
+    std::vector<const component_base*> components;
+    std::vector<id_t>                  ids;
+    for (const auto& c : recorded)
     {
-        if (![&] {
-                for (const auto id : l->component_ids())
-                    if (![&] {
-                            for (const auto& x : e)
-                                if (id == x.first) return true;
-                            return false;
-                        }())
-                        return false;
-                return true;
-            }())
+        const auto* const entries = recorded_entries.data() + c.first;
+        switch (c.type)
+        {
+        case command_buffer::command_type::create_entity:
+            components.clear();
+            ids.clear();
+            for (auto i = 0ull; i < c.count; ++i)
+            {
+                components.push_back(entries[i].component);
+                ids.push_back(entries[i].id);
+            }
+            create_entity(components.data(), ids.data(), c.count);
+            break;
+        case command_buffer::command_type::delete_entity: delete_entity({this, c.entity}); break;
+        case command_buffer::command_type::add_components:
+            for (auto i = 0ull; i < c.count; ++i) add_component_impl(c.entity, entries[i].id, entries[i].component);
+            break;
+        case command_buffer::command_type::remove_components:
+            for (auto i = 0ull; i < c.count; ++i) remove_component_impl(c.entity, entries[i].id);
             break;
-        l->on_remove(handle);
+        }
     }
+    command_buffer::destroy(recorded_entries);
+}
+
+command_buffer& ecs::deferred() noexcept
+{
+    return *_deferred;
+}
 
-    for (auto&& comp : e) delete_component(comp.first, comp.second);
-    const auto dst_idx = index_of(handle._handle);
-    delete _entities[dst_idx];
-    _entities[dst_idx]        = _entities[_entities.size() - 1];
-    _entities[dst_idx]->first = dst_idx;
-    _entities.pop_back();
+void ecs::delete_entity(entity handle)
+{
+    if (!valid(handle._handle)) return;
+
+    for (auto& l : _listeners)
+        if (matches(*l.target, _entities[handle._handle.index].signature)) notify(l, notification_type::remove, handle._handle);
+
+    auto& slot = _entities[handle._handle.index];
+    for (auto id = 0ull; id < _components.size(); ++id)
+        if (slot.signature.test(id)) _components[id]->remove(handle._handle, _tick);
+
+    slot.signature.reset();
+    update_queries(handle._handle);
+    slot.alive = false;
+    ++slot.generation;
+    _free_entities.push_back(handle._handle.index);
+    --_entity_count;
 }
 
 unique_entity ecs::create_entity_unique(const component_base** components, const id_t* component_ids, size_t count)
@@ -115,164 +213,311 @@ unique_entity ecs::create_entity_unique(const component_base** components, const
 
 component_base* ecs::get_component(entity_handle handle, id_t cid)
 {
-	return get_component_impl(handle, _components.at(cid), cid);
+    component_base* const c = get_component_impl(handle, cid);
+    if (c) c->changed_tick = _tick;
+    return c;
+}
+
+const component_base* ecs::get_component(entity_handle handle, id_t cid) const
+{
+    return get_component_impl(handle, cid);
+}
+
+void ecs::mark_changed(entity_handle handle, id_t cid)
+{
+    if (component_base* const c = get_component_impl(handle, cid)) c->changed_tick = _tick;
+}
+
+void ecs::next_frame()
+{
+    // Removals stay visible for two frames, so systems updated at least once per frame observe every one of them. Types
+    // whose removals were not requested by any system in that time stop being logged.
+    for (auto& s : _components)
+    {
+        if (!s || !s->logs_removals()) continue;
+        if (s->removals_requested() + 2 <= _frame)
+            s->stop_removals();
+        else
+            s->trim_removed(_frame_ticks[0]);
+    }
+    _frame_ticks[0] = _frame_ticks[1];
+    _frame_ticks[1] = _tick;
+    ++_frame;
+}
+
+uint64_t ecs::frame() const noexcept
+{
+    return _frame;
+}
+
+uint32_t ecs::tick() const noexcept
+{
+    return _tick;
+}
+
+bool ecs::has_component(entity_handle handle, id_t cid) const
+{
+    return valid(handle) && _entities[handle.index].signature.test(static_cast<size_t>(cid));
+}
+
+bool ecs::valid(entity_handle handle) const noexcept
+{
+    return handle.index < _entities.size() && _entities[handle.index].alive && _entities[handle.index].generation == handle.generation;
+}
+
+size_t ecs::entity_count() const noexcept
+{
+    return _entity_count;
+}
+
+template<typename Fun>
+void ecs::for_each_chunk(const system_base& system, size_t count, Fun&& fun)
+{
+    // Chunk boundaries only depend on the entity count and the chunk size of the system, never on the thread count.
+    const size_t  chunk_size  = system.chunk_size();
+    const int64_t chunk_count = static_cast<int64_t>((count + chunk_size - 1) / chunk_size);
+
+    if (chunk_count > 1 && system.options().has(system_option::thread_safe))
+    {
+#pragma omp parallel for schedule(static)
+        for (int64_t c = 0; c < chunk_count; ++c) fun(c * chunk_size, std::min(count, (c + 1) * chunk_size));
+    }
+    else
+    {
+        for (int64_t c = 0; c < chunk_count; ++c) fun(c * chunk_size, std::min(count, (c + 1) * chunk_size));
+    }
 }
 
 void ecs::update(double delta, system_list& list)
 {
-    std::vector<component_base*>         multi_components;
-    std::vector<std::vector<std::byte>*> component_arrays;
+    flush_notifications();
     for (int64_t i = 0; i < static_cast<int64_t>(list.size()); ++i)
     {
-        const auto& component_types = list[static_cast<uint32_t>(i)].types();
-        if (component_types.size() == 1)
+        auto&       system          = list[static_cast<uint32_t>(i)];
+        const auto& component_types = system.types();
+
+        // Changes made while the system runs are tagged with its own tick and therefore not reported to it again.
+        const uint32_t tick = _tick;
+        for (const auto id : system.removed_types())
         {
-            const auto size = component_base::type_size(component_types[0]);
-            auto&      arr  = _components[component_types[0]];
-            for (auto ci = 0ull; ci < arr.size(); ci += size)
-            {
-                auto* c = reinterpret_cast<component_base*>(&arr[ci]);
-                list[static_cast<uint32_t>(i)].update(delta, &c);
-            }
+            auto& s = storage(id);
+            s.request_removals(_frame);
+            const auto removed = s.removed_since(system._last_run);
+            if (removed.size() == 0) continue;
+
+            std::vector<entity_handle> handles(removed.size());
+            std::transform(removed.begin(), removed.end(), handles.begin(), [](const auto& r) { return r.entity; });
+            system.update_removed(delta, id, handles);
         }
-        else
+
+        const bool filtered = std::any_of(system.flags().begin(), system.flags().end(), [](const component_flags& f) {
+            return f.has(component_flag::changed) || f.has(component_flag::added) || f.has(component_flag::mutated);
+        });
+        if (component_types.size() == 1 && !filtered)
         {
-            update_multi_system(list[static_cast<uint32_t>(i)], delta, component_types, multi_components, component_arrays);
+            auto&      arr   = storage(component_types[0]);
+            const auto size  = arr.stride();
+            const auto count = arr.size();
+            for_each_chunk(system, count, [&](size_t begin, size_t end) {
+                // Batches never cross a page, so the column is always contiguous.
+                for (auto first = begin; first < end;)
+                {
+                    const auto                    last = arr.contiguous_end(first, end);
+                    const component_batch::column column{reinterpret_cast<std::byte*>(arr.at(first)), size};
+                    system.update_batch(delta, component_batch(last - first, 1, nullptr, &column, tick));
+                    first = last;
+                }
+            });
         }
+        else if (!component_types.empty())
+        {
+            update_multi_system(system, delta, component_types);
+        }
+        system._last_run = tick;
+        ++_tick;
+
+        if (!_deferred->empty()) execute(*_deferred);
     }
+    flush_notifications();
 }
 
-void ecs::delete_component(id_t id, size_t index)
+entity_handle ecs::allocate_entity()
 {
-    auto&      component_arr = _components[id];
-    const auto deleter       = component_base::get_deleter(id);
-    const auto size          = component_base::type_size(id);
-    auto       source_index  = component_arr.size() - size;
+    entity_handle hnd;
+    if (_free_entities.empty())
+    {
+        hnd.index = static_cast<uint32_t>(_entities.size());
+        _entities.emplace_back();
+    }
+    else
+    {
+        hnd.index = _free_entities.back();
+        _free_entities.pop_back();
+    }
+    auto& slot     = _entities[hnd.index];
+    slot.alive     = true;
+    hnd.generation = slot.generation;
+    ++_entity_count;
+    return hnd;
+}
 
-    const auto dst = reinterpret_cast<component_base*>(&component_arr[index]);
-    const auto src = reinterpret_cast<component_base*>(&component_arr[source_index]);
-    deleter(dst);
+query& ecs::register_query(std::vector<id_t> types, std::vector<component_flags> flags)
+{
+    flags.resize(types.size());
+    for (auto& q : _queries)
+        if (q->types() == types && q->flags() == flags) return *q;
 
-    if (index == source_index)
+    auto& q = *_queries.emplace_back(std::make_unique<query>(std::move(types), std::move(flags)));
+    for (const auto id : q.types()) q._storages.push_back(&storage(id));
+    for (auto i = 0ull; i < _entities.size(); ++i)
     {
-        component_arr.resize(source_index);
-        return;
+        const auto& slot = _entities[i];
+        if (slot.alive && q.matches(slot.signature)) q.insert(entity_handle{static_cast<uint32_t>(i), slot.generation});
     }
+    return q;
+}
 
-    memcpy(dst, src, size);
+void ecs::update_queries(entity_handle e)
+{
+    const auto& signature = _entities[e.index].signature;
+    for (auto& q : _queries)
+    {
+        if (signature.any() && q->matches(signature))
+            q->insert(e);
+        else
+            q->erase(e);
+    }
+}
 
-    auto& components = as_entity(src->entity);
-    if (const auto it = std::find_if(std::execution::seq, components.begin(), components.end(),
-                                     [&](const auto& p) { return p.first == id && p.second == source_index; });
-        it != components.end())
-    { it->second = static_cast<uint32_t>(index); } component_arr.resize(source_index);
+component_storage& ecs::storage(id_t id)
+{
+    const auto index = static_cast<size_t>(id);
+    if (index >= _components.size()) _components.resize(index + 1);
+    if (!_components[index]) _components[index] = std::make_unique<component_storage>(id);
+    return *_components[index];
+}
+
+component_storage* ecs::find_storage(id_t id) const noexcept
+{
+    const auto index = static_cast<size_t>(id);
+    return index < _components.size() ? _components[index].get() : nullptr;
 }
 
 bool ecs::remove_component_impl(entity_handle e, id_t component_id)
 {
-    auto& components = as_entity(e);
-    if (const auto it =
-            std::find_if(std::execution::seq, components.begin(), components.end(), [&](const auto& p) { return p.first == component_id; });
-        it != components.end())
-    {
-        for (auto& l : _listeners)
-            for (const auto id : l->component_ids())
-                if (id == component_id)
-                {
-                    l->on_remove_component({this, e}, id);
-                    break;
-                }
+    if (!has_component(e, component_id)) return false;
 
-        const auto src_index = components.size() - 1;
-        const auto dst_index = std::distance(components.begin(), it);
-        delete_component(it->first, it->second);
-        components[dst_index] = components[src_index];
-        components.pop_back();
-        return true;
-    }
-    return false;
+    for (auto& l : _listeners)
+        if (l.target->signature().test(static_cast<size_t>(component_id)))
+            notify(l, notification_type::remove_component, e, component_id);
+
+    _components[static_cast<size_t>(component_id)]->remove(e, _tick);
+    _entities[e.index].signature.reset(static_cast<size_t>(component_id));
+    update_queries(e);
+    return true;
 }
 
 void ecs::add_component_impl(entity_handle e, id_t component_id, const component_base* component)
 {
-    auto       ent    = as_entity_ptr(e);
-    const auto create = component_base::get_creator(component_id);
-    ent->second.emplace_back(component_id, static_cast<uint32_t>(create(_components[component_id], e, component)));
+    if (!valid(e)) return;
+
+    storage(component_id).emplace(e, component, _tick);
+    _entities[e.index].signature.set(static_cast<size_t>(component_id));
+    update_queries(e);
     for (auto& l : _listeners)
-        for (const auto id : l->component_ids())
-            if (id == component_id)
-            {
-                l->on_remove_component({this, e}, id);
-                break;
-            }
+        if (l.target->signature().test(static_cast<size_t>(component_id)))
+            notify(l, notification_type::add_component, e, component_id);
 }
 
-component_base* ecs::get_component_impl(entity_handle e, std::vector<std::byte>& carr, id_t component_id)
+component_base* ecs::get_component_impl(entity_handle e, id_t component_id) const
 {
-    auto& components = as_entity(e);
-    if (const auto it =
-            std::find_if(std::execution::seq, components.begin(), components.end(), [&](const auto& p) { return p.first == component_id; });
-        it != components.end())
-    { return reinterpret_cast<component_base*>(&carr[it->second]); } return nullptr;
+    const auto s = find_storage(component_id);
+    return s ? s->get(e) : nullptr;
 }
 
-void ecs::update_multi_system(system_base& system, double delta, const std::vector<id_t>& types, std::vector<component_base*>& components,
-                              std::vector<std::vector<std::byte>*>& component_arrays)
+bool ecs::matches(const listener& l, const component_signature& signature) noexcept
 {
-    const auto& system_flags = system.flags();
+    return (signature & l.signature()) == l.signature();
+}
 
-    components.resize(std::max(types.size(), components.size()));
-    component_arrays.resize(std::max(component_arrays.size(), components.size()));
-    for (auto i = 0ull; i < types.size(); ++i) component_arrays[i] = &_components[types[i]];
-
-    const auto min_index = [&]() -> ptrdiff_t {
-        const auto d = std::distance(
-            types.begin(), std::min_element(std::execution::seq, types.begin(), types.end(), [&](const id_t& a, const id_t& b) {
-                const auto sa    = component_base::type_size(a);
-                const auto sb    = component_base::type_size(b);
-                const auto a_opt = (system_flags[std::distance(types.data(), &a)] & component_flag::optional) == component_flag::optional;
-                const auto b_opt = (system_flags[std::distance(types.data(), &b)] & component_flag::optional) == component_flag::optional;
-
-                if (a_opt) return false;
-                if (b_opt) return true;
-                return (_components.at(a).size() / sa < _components.at(b).size() / sb);
-            }));
-        if (static_cast<unsigned long long>(d) == types.size()) return 0ll;
-        return d;
-    }();
-
-    const auto size = component_base::type_size(types[min_index]);
-    for (auto ci = 0ull; ci < component_arrays[min_index]->size(); ci += size)
+void ecs::notify(listener_entry& l, notification_type type, entity_handle e, id_t id)
+{
+    if (l.target->options().has(listener_option::immediate))
     {
-        components[min_index]     = reinterpret_cast<component_base*>(&(*component_arrays[min_index])[ci]);
-        const auto& parent_entity = components[min_index]->entity;
-
-        if ([&]() -> bool {
-                for (auto j = 0ll; j < static_cast<int64_t>(types.size()); ++j)
-                {
-                    if (j == min_index) continue;
-                    components[j] = get_component_impl(parent_entity, *component_arrays[j], types[j]);
-                    if (!components[j] && (system_flags[j] & component_flag::optional) != component_flag::optional) return false;
-                }
-                return true;
-            }())
-            system.update(delta, components.data());
+        const entity ent{this, e};
+        deliver(*l.target, type, id, gfx::span<const entity>(&ent, 1));
+    }
+    else
+    {
+        l.pending.push_back(notification{type, id, e});
     }
 }
 
-indexed_entity* ecs::as_entity_ptr(entity_handle handle)
+void ecs::deliver(listener& l, notification_type type, id_t id, gfx::span<const entity> entities)
 {
-    return static_cast<indexed_entity*>(handle);
+    switch (type)
+    {
+    case notification_type::add: l.on_add_batch(entities); break;
+    case notification_type::remove: l.on_remove_batch(entities); break;
+    case notification_type::add_component: l.on_add_component_batch(entities, id); break;
+    case notification_type::remove_component: l.on_remove_component_batch(entities, id); break;
+    }
 }
 
-uint32_t ecs::index_of(entity_handle handle)
+void ecs::update_multi_system(system_base& system, double delta, const std::vector<id_t>& types)
 {
-    return as_entity_ptr(handle)->first;
-}
+    const auto& system_flags = system.flags();
+    const auto  last_run     = system._last_run;
+    const auto  tick         = _tick;
+
+    // Systems are only identified by their address, so a cached query is checked against the types and flags, in case
+    // the system was replaced by another one at the same address.
+    query*& cached = _system_queries[&system];
+    if (!cached || cached->types() != types || cached->flags() != system_flags) cached = &register_query(types, system_flags);
+    const query& q        = *cached;
+    const auto   entities = q.entities();
+
+    for_each_chunk(system, static_cast<size_t>(entities.size()), [&](size_t begin, size_t end) {
+        std::vector<component_base*> rows((end - begin) * types.size());
+        size_t                       matched = 0;
+        for (auto ci = begin; ci < end; ++ci)
+        {
+            component_base** components = &rows[matched * types.size()];
+            const auto       e          = entities[static_cast<ptrdiff_t>(ci)];
+
+            if ([&]() -> bool {
+                    for (auto j = 0ull; j < types.size(); ++j)
+                    {
+                        // Required components are guaranteed to exist, only the filters remain to be checked.
+                        components[j] = q.get(j, e);
+                        if (!components[j]) continue;
+                        if (system_flags[j].has(component_flag::changed) && components[j]->changed_tick <= last_run) return false;
+                        if (system_flags[j].has(component_flag::added) && components[j]->added_tick <= last_run) return false;
+                    }
+                    return true;
+                }())
+            {
+                for (auto j = 0ull; j < types.size(); ++j)
+                    if (components[j] && system_flags[j].has(component_flag::mutated)) components[j]->changed_tick = tick;
+                ++matched;
+            }
+        }
+        if (matched == 0) return;
 
-entity_info& ecs::as_entity(entity_handle handle)
-{
-    return as_entity_ptr(handle)->second;
+        // Columns are contiguous if the components of all matched entities follow each other in their storage, which is
+        // usually the case for entities created together.
+        std::vector<component_batch::column> columns(types.size());
+        for (auto j = 0ull; j < types.size(); ++j)
+        {
+            const auto stride     = q._storages[j]->stride();
+            const auto first      = reinterpret_cast<uintptr_t>(rows[j]);
+            bool       contiguous = first != 0;
+            for (auto i = 1ull; contiguous && i < matched; ++i)
+                contiguous = reinterpret_cast<uintptr_t>(rows[i * types.size() + j]) == first + i * stride;
+            if (contiguous) columns[j] = component_batch::column{reinterpret_cast<std::byte*>(rows[j]), stride};
+        }
+        system.update_batch(delta, component_batch(matched, types.size(), rows.data(), columns.data(), tick));
+    });
 }
 }    // namespace ecs
 }    // namespace v1
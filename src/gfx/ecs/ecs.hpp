@@ -1,11 +1,16 @@
 #pragma once
 
+#include "command_buffer.hpp"
 #include "entity.hpp"
 #include "listener.hpp"
+#include "query.hpp"
+#include "snapshot.hpp"
+#include "storage.hpp"
 #include "system.hpp"
+#include <cassert>
 #include <execution>
+#include <memory>
 #include <unordered_map>
-#include <cassert>
 
 namespace gfx {
 inline namespace v1 {
@@ -16,14 +21,17 @@ class ecs
 
 public:
     ecs()                 = default;
-    ecs(const ecs& other) = default;
+    ecs(const ecs& other) = delete;
     ecs(ecs&& other)      = default;
-    ecs& operator=(const ecs& other) = default;
+    ecs& operator=(const ecs& other) = delete;
     ecs& operator=(ecs&& other) = default;
 
     ~ecs();
 
     void add_listener(listener& l);
+    void remove_listener(listener& l);
+    // Delivers all queued listener notifications, called at the beginning and the end of ecs::update.
+    void flush_notifications();
 
     entity create_entity(const component_base** components, const id_t* component_ids, size_t count);
     void   delete_entity(entity handle);
@@ -36,6 +44,26 @@ public:
     template<typename... Components, typename = std::void_t<traits::enable_if_component_t<Components>...>>
     unique_entity create_entity_unique(const Components&... components);
 
+    // Creates count entities sharing one component signature with a single reservation per component storage.
+    // components[i] points to the source of the first entity, the sources of the following entities are strides[i] bytes
+    // apart. A stride of zero copies the same component into every entity.
+    std::vector<entity> create_entities(size_t count, const component_base** components, const size_t* strides,
+                                        const id_t* component_ids, size_t type_count);
+
+    template<typename... Components, typename = std::void_t<traits::enable_if_component_t<Components>...>>
+    std::vector<entity> create_entities(size_t count, const Components&... components);
+
+    template<typename... Components, typename = std::void_t<traits::enable_if_component_t<Components>...>>
+    std::vector<entity> create_entities(const std::vector<Components>&... components);
+
+    void delete_entities(gfx::span<const entity_handle> handles);
+
+    // Applies and clears all commands recorded in the buffer.
+    void execute(command_buffer& commands);
+
+    // Commands recorded here are executed after each system update in ecs::update.
+    command_buffer& deferred() noexcept;
+
     template<typename... Component>
     void add_components(entity_handle handle, const Component&... component);
 
@@ -45,25 +73,103 @@ public:
     template<typename Component>
     Component* get_component(entity_handle handle);
 	
-	component_base* get_component(entity_handle handle, id_t cid);
+    template<typename Component>
+    const Component* get_component(entity_handle handle) const;
+
+    // Mutable access marks the component as changed.
+    component_base*       get_component(entity_handle handle, id_t cid);
+    const component_base* get_component(entity_handle handle, id_t cid) const;
+
+    template<typename Component>
+    void mark_changed(entity_handle handle);
+    void mark_changed(entity_handle handle, id_t cid);
+
+    template<typename Component>
+    bool has_component(entity_handle handle) const;
+    bool has_component(entity_handle handle, id_t cid) const;
+
+    bool   valid(entity_handle handle) const noexcept;
+    size_t entity_count() const noexcept;
 
     void update(double delta, system_list& list);
 
+    // Writes all entities and their components to a versioned binary snapshot.
+    void save_snapshot(std::ostream& out) const;
+    void save_snapshot(snapshot_writer& out) const;
+    // Creates all entities of a snapshot in addition to the existing ones and returns them in snapshot order. Entity
+    // handles referenced by components are remapped to the new entities. Nothing is created from truncated or corrupt
+    // snapshots.
+    std::vector<entity> load_snapshot(std::istream& in);
+    std::vector<entity> load_snapshot(gfx::span<const std::byte> data);
+    std::vector<entity> load_snapshot(snapshot_reader& in);
+    // Deletes all entities.
+    void clear();
+
+    // Returns the query matching the given component types, creating it if none is registered yet. The query stays
+    // valid for the lifetime of the ecs and is kept up to date on every structural change.
+    query& register_query(std::vector<id_t> types, std::vector<component_flags> flags = {});
+
+    // Advances the frame counter. Component removals reported to systems are kept for two frames.
+    void     next_frame();
+    uint64_t frame() const noexcept;
+    // Change tick given to components modified right now. It is incremented after every system update.
+    uint32_t tick() const noexcept;
+
 private:
-    std::unordered_map<id_t, std::vector<std::byte>> _components;
-    std::vector<indexed_entity*>                     _entities;
-    std::vector<listener*>                           _listeners;
-
-    void            delete_component(id_t id, size_t index);
-    bool            remove_component_impl(entity_handle e, id_t component_id);
-    void            add_component_impl(entity_handle e, id_t component_id, const component_base* component);
-    component_base* get_component_impl(entity_handle e, std::vector<std::byte>& carr, id_t component_id);
-    void update_multi_system(system_base& system, double delta, const std::vector<id_t>& types, std::vector<component_base*>& components,
-                             std::vector<std::vector<std::byte>*>& component_arrays);
-
-    static indexed_entity* as_entity_ptr(entity_handle handle);
-    static uint32_t        index_of(entity_handle handle);
-    static entity_info&    as_entity(entity_handle handle);
+    enum class notification_type : uint8_t
+    {
+        add,
+        remove,
+        add_component,
+        remove_component
+    };
+
+    struct notification
+    {
+        notification_type type;
+        id_t              id;
+        entity_handle     entity;
+    };
+
+    struct listener_entry
+    {
+        listener*                 target;
+        std::vector<notification> pending;
+    };
+
+    struct entity_slot
+    {
+        uint32_t            generation = 0;
+        bool                alive      = false;
+        component_signature signature;
+    };
+
+    std::vector<std::unique_ptr<component_storage>> _components;
+    std::vector<entity_slot>                        _entities;
+    std::vector<uint32_t>                           _free_entities;
+    size_t                                          _entity_count = 0;
+    std::vector<listener_entry>                     _listeners;
+    std::unique_ptr<command_buffer>                 _deferred = std::make_unique<command_buffer>();
+    std::vector<std::unique_ptr<query>>             _queries;
+    std::unordered_map<const system_base*, query*>  _system_queries;    // Queries of the updated multi-component systems.
+    uint32_t                                        _tick     = 1;
+    uint32_t                                        _frame_ticks[2]{0, 0};
+    uint64_t                                        _frame = 0;
+
+    entity_handle      allocate_entity();
+    component_storage& storage(id_t id);
+    void               update_queries(entity_handle e);
+    component_storage* find_storage(id_t id) const noexcept;
+    bool               remove_component_impl(entity_handle e, id_t component_id);
+    void               add_component_impl(entity_handle e, id_t component_id, const component_base* component);
+    component_base*    get_component_impl(entity_handle e, id_t component_id) const;
+    void               update_multi_system(system_base& system, double delta, const std::vector<id_t>& types);
+    void               notify(listener_entry& l, notification_type type, entity_handle e, id_t id = {});
+    void               deliver(listener& l, notification_type type, id_t id, gfx::span<const entity> entities);
+    static bool        matches(const listener& l, const component_signature& signature) noexcept;
+
+    template<typename Fun>
+    static void for_each_chunk(const system_base& system, size_t count, Fun&& fun);
 };
 }    // namespace ecs
 }    // namespace v1
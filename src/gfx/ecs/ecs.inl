@@ -15,11 +15,23 @@ bool entity::remove()
     return (_ecs->remove_component_impl(_handle, Component::id) && ... && _ecs->remove_component_impl(_handle, Components::id));
 }
 
+template<typename Component>
+bool entity::has() const
+{
+    return _ecs->has_component(_handle, std::decay_t<Component>::id);
+}
+
+template<typename Component>
+void entity::mark_changed()
+{
+    _ecs->mark_changed(_handle, std::decay_t<Component>::id);
+}
+
 template<typename Component>
 std::decay_t<Component>* entity::get()
 {
 	using type = std::decay_t<Component>;
-    auto* const c = static_cast<type*>(_ecs->get_component_impl(_handle, _ecs->_components[type::id], type::id));
+    auto* const c = static_cast<type*>(_ecs->get_component(_handle, type::id));
 	assert(c);
 	return c;
 }
@@ -27,7 +39,7 @@ template<typename Component>
 const std::decay_t<Component>* entity::get() const
 {
 	using type = const std::decay_t<Component>;
-	auto* const c = static_cast<type*>(_ecs->get_component_impl(_handle, _ecs->_components[type::id], type::id));
+	auto* const c = static_cast<type*>(_ecs->get_component_impl(_handle, type::id));
 	assert(c);
 	return c;
 }
@@ -51,6 +63,33 @@ unique_entity ecs::create_entity_unique(const Components&... components)
     return unique_entity(new entity(create_entity(components...)));
 }
 
+template<typename... Components, typename>
+std::vector<entity> ecs::create_entities(size_t count, const Components&... components)
+{
+    if constexpr (sizeof...(Components) == 0)
+        return create_entities(count, nullptr, nullptr, nullptr, 0);
+    else
+    {
+        const component_base* css[]{static_cast<const component_base*>(&components)...};
+        size_t                strides[sizeof...(Components)]{};
+        id_t                  ids[]{components.id...};
+        return create_entities(count, css, strides, ids, sizeof...(Components));
+    }
+}
+
+template<typename... Components, typename>
+std::vector<entity> ecs::create_entities(const std::vector<Components>&... components)
+{
+    static_assert(sizeof...(Components) != 0, "At least one component vector is required to deduce the entity count.");
+    const size_t count = std::get<0>(std::forward_as_tuple(components...)).size();
+    assert(((components.size() == count) && ...));
+
+    const component_base* css[]{static_cast<const component_base*>(components.data())...};
+    size_t                strides[]{sizeof(Components)...};
+    id_t                  ids[]{Components::id...};
+    return create_entities(count, css, strides, ids, sizeof...(Components));
+}
+
 template<typename... Component>
 void ecs::add_components(entity_handle handle, const Component&... component)
 {
@@ -68,6 +107,24 @@ Component* ecs::get_component(entity_handle handle)
 {
     return static_cast<Component*>(get_component(handle, Component::id));
 }
+
+template<typename Component>
+const Component* ecs::get_component(entity_handle handle) const
+{
+    return static_cast<const Component*>(get_component(handle, Component::id));
+}
+
+template<typename Component>
+void ecs::mark_changed(entity_handle handle)
+{
+    mark_changed(handle, Component::id);
+}
+
+template<typename Component>
+bool ecs::has_component(entity_handle handle) const
+{
+    return has_component(handle, Component::id);
+}
 }    // namespace ecs
 }    // namespace v1
 }    // namespace gfx
\ No newline at end of file
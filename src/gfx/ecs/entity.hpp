@@ -7,9 +7,6 @@
 namespace gfx {
 inline namespace v1 {
 namespace ecs {
-using entity_info    = std::vector<std::pair<id_t, uint32_t>>;
-using indexed_entity = std::pair<uint32_t, entity_info>;
-
 namespace traits {
 template<typename T>
 struct is_component : std::is_convertible<std::decay_t<T>&, component_base&>
@@ -38,6 +35,10 @@ public:
     void add(const Component&... component);
     template<typename Component, typename... Components>
     bool remove();
+    template<typename Component>
+    bool has() const;
+    template<typename Component>
+    void mark_changed();
     template<typename Component>
 	std::decay_t<Component>* get();
 	template<typename Component>
@@ -50,7 +51,7 @@ private:
     entity(ecs* e, entity_handle hnd);
 
     ecs*          _ecs    = nullptr;
-    entity_handle _handle = nullptr;
+    entity_handle _handle = null_entity;
 };
 
 struct entity_deleter
@@ -1,10 +1,20 @@
 #pragma once
 
 #include "entity.hpp"
+#include <gfx/data/flags.hpp>
+#include <gfx/type.hpp>
 
 namespace gfx {
 inline namespace v1 {
 namespace ecs {
+enum class listener_option : uint32_t
+{
+    // Notifications are delivered as soon as the structural change happens instead of being queued until the next
+    // ecs::flush_notifications. Use it if the listener must access components before they are removed.
+    immediate = 1 << 0,
+};
+using listener_options = gfx::flags<uint32_t, listener_option>;
+
 class listener
 {
 public:
@@ -20,13 +30,41 @@ public:
     virtual void on_add_component(entity e, id_t id) {}
     virtual void on_remove_component(entity e, id_t id) {}
 
-    const std::vector<id_t>& component_ids() const noexcept { return _component_ids; }
+    // Queued notifications are delivered as consecutive runs of the same event. The default implementations forward
+    // every entity to the single-entity callbacks above, override them to handle a whole run at once.
+    virtual void on_add_batch(gfx::span<const entity> entities)
+    {
+        for (const auto& e : entities) on_add(e);
+    }
+    virtual void on_remove_batch(gfx::span<const entity> entities)
+    {
+        for (const auto& e : entities) on_remove(e);
+    }
+    virtual void on_add_component_batch(gfx::span<const entity> entities, id_t id)
+    {
+        for (const auto& e : entities) on_add_component(e, id);
+    }
+    virtual void on_remove_component_batch(gfx::span<const entity> entities, id_t id)
+    {
+        for (const auto& e : entities) on_remove_component(e, id);
+    }
+
+    const std::vector<id_t>&   component_ids() const noexcept { return _component_ids; }
+    const component_signature& signature() const noexcept { return _signature; }
+    const listener_options&    options() const noexcept { return _options; }
 
 protected:
-    void add_component_id(id_t id) { _component_ids.push_back(id); }
+    void add_component_id(id_t id)
+    {
+        _component_ids.push_back(id);
+        _signature.set(static_cast<size_t>(id));
+    }
+    void set_options(listener_options options) { _options = options; }
 
 private:
-    std::vector<id_t> _component_ids;
+    std::vector<id_t>   _component_ids;
+    component_signature _signature;
+    listener_options    _options;
 };
 }    // namespace ecs
 }    // namespace v1
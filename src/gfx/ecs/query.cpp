@@ -0,0 +1,73 @@
+#include "query.hpp"
+
+namespace gfx {
+inline namespace v1 {
+namespace ecs {
+query::query(std::vector<id_t> types, std::vector<component_flags> flags) : _types(std::move(types)), _flags(std::move(flags))
+{
+    _flags.resize(_types.size());
+    for (auto i = 0ull; i < _types.size(); ++i)
+        if (!_flags[i].has(component_flag::optional)) _signature.set(static_cast<size_t>(_types[i]));
+}
+
+const std::vector<id_t>& query::types() const noexcept
+{
+    return _types;
+}
+
+const std::vector<component_flags>& query::flags() const noexcept
+{
+    return _flags;
+}
+
+const component_signature& query::signature() const noexcept
+{
+    return _signature;
+}
+
+gfx::span<const entity_handle> query::entities() const noexcept
+{
+    return gfx::span<const entity_handle>(_entities.data(), static_cast<ptrdiff_t>(_entities.size()));
+}
+
+size_t query::size() const noexcept
+{
+    return _entities.size();
+}
+
+bool query::matches(const component_signature& signature) const noexcept
+{
+    return (signature & _signature) == _signature;
+}
+
+bool query::contains(entity_handle e) const noexcept
+{
+    return e.index < _positions.size() && _positions[e.index] != component_storage::npos
+           && _entities[_positions[e.index]] == e;
+}
+
+component_base* query::get(size_t type_index, entity_handle e) const noexcept
+{
+    return _storages[type_index]->get(e);
+}
+
+void query::insert(entity_handle e)
+{
+    if (contains(e)) return;
+    if (e.index >= _positions.size()) _positions.resize(e.index + 1, component_storage::npos);
+    _positions[e.index] = static_cast<uint32_t>(_entities.size());
+    _entities.push_back(e);
+}
+
+void query::erase(entity_handle e)
+{
+    if (!contains(e)) return;
+    const auto position                   = _positions[e.index];
+    _entities[position]                   = _entities.back();
+    _positions[_entities[position].index] = position;
+    _positions[e.index]                   = component_storage::npos;
+    _entities.pop_back();
+}
+}    // namespace ecs
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "storage.hpp"
+#include "system.hpp"
+
+namespace gfx {
+inline namespace v1 {
+namespace ecs {
+// Persistent list of all entities owning a set of component types. Queries are registered at and owned by an ecs,
+// which keeps their matches up to date on every structural change, so iterating them needs no per-frame setup.
+class query
+{
+public:
+    query(std::vector<id_t> types, std::vector<component_flags> flags);
+
+    query(const query& other) = delete;
+    query& operator=(const query& other) = delete;
+
+    const std::vector<id_t>&            types() const noexcept;
+    const std::vector<component_flags>& flags() const noexcept;
+    // Signature of all non-optional component types.
+    const component_signature&     signature() const noexcept;
+    gfx::span<const entity_handle> entities() const noexcept;
+    size_t                         size() const noexcept;
+
+    bool matches(const component_signature& signature) const noexcept;
+    bool contains(entity_handle e) const noexcept;
+
+    // Component of the given type index, nullptr if e does not own an optional component.
+    component_base* get(size_t type_index, entity_handle e) const noexcept;
+
+private:
+    friend class ecs;
+
+    void insert(entity_handle e);
+    void erase(entity_handle e);
+
+    std::vector<id_t>               _types;
+    std::vector<component_flags>    _flags;
+    component_signature             _signature;
+    std::vector<component_storage*> _storages;
+    std::vector<entity_handle>      _entities;
+    std::vector<uint32_t>           _positions;    // Position of each entity index in _entities.
+};
+}    // namespace ecs
+}    // namespace v1
+}    // namespace gfx
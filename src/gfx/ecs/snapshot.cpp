@@ -0,0 +1,484 @@
+#include "ecs.hpp"
+#include <cstring>
+#include <gfx/log.hpp>
+#include <istream>
+#include <ostream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gfx {
+inline namespace v1 {
+namespace ecs {
+namespace {
+// Limits the type names read from a snapshot, so that corrupt lengths fail instead of allocating.
+constexpr uint32_t max_name_length = 4096;
+// Entity handles are read in chunks, so that the entity count of a corrupt snapshot cannot allocate more memory than
+// the snapshot provides.
+constexpr size_t handle_chunk = 65536;
+
+std::vector<component_serializer>& serializers()
+{
+    static std::vector<component_serializer> s;
+    return s;
+}
+
+std::vector<std::pair<id_t (*)(), entity_reference_fun>>& pending_references()
+{
+    static std::vector<std::pair<id_t (*)(), entity_reference_fun>> r;
+    return r;
+}
+
+component_serializer& serializer_slot(id_t id)
+{
+    auto& s = serializers();
+    if (static_cast<size_t>(id) >= s.size()) s.resize(static_cast<size_t>(id) + 1);
+    return s[static_cast<size_t>(id)];
+}
+
+// Moves the references registered before their ids were known to their serializers.
+void resolve_references()
+{
+    auto& pending = pending_references();
+    for (auto& r : pending) serializer_slot(r.first()).references.push_back(std::move(r.second));
+    pending.clear();
+}
+
+component_serializer& serializer(id_t id)
+{
+    resolve_references();
+    return serializer_slot(id);
+}
+
+class stream_writer : public snapshot_writer
+{
+public:
+    using snapshot_writer::write;
+
+    explicit stream_writer(std::ostream& out) : _out(out) {}
+    void write(const void* data, size_t size) override { _out.write(static_cast<const char*>(data), size); }
+
+private:
+    std::ostream& _out;
+};
+
+class buffer_writer : public snapshot_writer
+{
+public:
+    using snapshot_writer::write;
+
+    void write(const void* data, size_t size) override
+    {
+        const auto* bytes = static_cast<const std::byte*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    std::vector<std::byte> buffer;
+};
+
+class stream_reader : public snapshot_reader
+{
+public:
+    using snapshot_reader::read;
+
+    explicit stream_reader(std::istream& in) : _in(in) {}
+    bool read(void* data, size_t size) override { return bool(_in.read(static_cast<char*>(data), size)); }
+    bool skip(size_t size) override { return bool(_in.ignore(size)); }
+
+private:
+    std::istream& _in;
+};
+
+// Forwards to another reader and remembers whether any read failed, including the ones of serializers.
+class checked_reader : public snapshot_reader
+{
+public:
+    using snapshot_reader::read;
+
+    explicit checked_reader(snapshot_reader& in) : _in(in) {}
+    bool read(void* data, size_t size) override { return _ok = _ok && _in.read(data, size); }
+    bool skip(size_t size) override { return _ok = _ok && _in.skip(size); }
+    bool ok() const noexcept { return _ok; }
+
+private:
+    snapshot_reader& _in;
+    bool             _ok = true;
+};
+
+class memory_reader : public snapshot_reader
+{
+public:
+    using snapshot_reader::read;
+
+    explicit memory_reader(gfx::span<const std::byte> data) : _data(data) {}
+    bool read(void* data, size_t size) override
+    {
+        if (_offset + size > static_cast<size_t>(_data.size())) return false;
+        memcpy(data, _data.data() + _offset, size);
+        _offset += size;
+        return true;
+    }
+    bool skip(size_t size) override
+    {
+        if (_offset + size > static_cast<size_t>(_data.size())) return false;
+        _offset += size;
+        return true;
+    }
+
+private:
+    gfx::span<const std::byte> _data;
+    size_t                     _offset = 0;
+};
+
+id_t find_type(const std::string& name)
+{
+    for (auto i = 0ull; i < component_base::type_count(); ++i)
+        if (name == component_base::type_info(id_t(i)).name) return id_t(i);
+    return id_t(component_base::type_count());
+}
+}    // namespace
+
+const component_serializer* find_serializer(id_t id)
+{
+    resolve_references();
+    const auto& s = serializers();
+    return static_cast<size_t>(id) < s.size() ? &s[static_cast<size_t>(id)] : nullptr;
+}
+
+bool register_serializer(id_t id, component_save_fun save, component_load_fun load)
+{
+    auto& s = serializer(id);
+    s.save  = save;
+    s.load  = load;
+    return true;
+}
+
+bool register_entity_reference(id_t id, entity_reference_fun reference)
+{
+    serializer(id).references.push_back(std::move(reference));
+    return true;
+}
+
+bool register_entity_reference(id_t (*id)(), entity_reference_fun reference)
+{
+    pending_references().emplace_back(id, std::move(reference));
+    return true;
+}
+
+mapped_snapshot::mapped_snapshot(const std::filesystem::path& path)
+{
+#if defined(_WIN32)
+    _file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_file == INVALID_HANDLE_VALUE)
+    {
+        _file = nullptr;
+        return;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(_file, &size);
+    _mapping = CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!_mapping) return;
+    _data = static_cast<const std::byte*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (_data) _size = static_cast<size_t>(size.QuadPart);
+#else
+    _file = open(path.c_str(), O_RDONLY);
+    if (_file < 0) return;
+    struct stat info;
+    if (fstat(_file, &info) != 0 || info.st_size == 0) return;
+    void* const data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, _file, 0);
+    if (data == MAP_FAILED) return;
+    _data = static_cast<const std::byte*>(data);
+    _size = static_cast<size_t>(info.st_size);
+#endif
+}
+
+mapped_snapshot::~mapped_snapshot()
+{
+#if defined(_WIN32)
+    if (_data) UnmapViewOfFile(_data);
+    if (_mapping) CloseHandle(_mapping);
+    if (_file) CloseHandle(_file);
+#else
+    if (_data) munmap(const_cast<std::byte*>(_data), _size);
+    if (_file >= 0) close(_file);
+#endif
+}
+
+gfx::span<const std::byte> mapped_snapshot::data() const noexcept
+{
+    return gfx::span<const std::byte>(_data, static_cast<ptrdiff_t>(_size));
+}
+
+mapped_snapshot::operator bool() const noexcept
+{
+    return _data != nullptr;
+}
+
+void ecs::save_snapshot(std::ostream& out) const
+{
+    stream_writer writer(out);
+    save_snapshot(writer);
+}
+
+void ecs::save_snapshot(snapshot_writer& out) const
+{
+    out.write(snapshot_magic);
+    out.write(snapshot_version);
+
+    std::vector<uint64_t> handles;
+    handles.reserve(_entity_count);
+    for (auto i = 0ull; i < _entities.size(); ++i)
+        if (_entities[i].alive) handles.push_back(entity_handle{static_cast<uint32_t>(i), _entities[i].generation}.value());
+    out.write(uint64_t(handles.size()));
+    out.write(handles.data(), handles.size() * sizeof(uint64_t));
+
+    std::vector<const component_storage*> stored;
+    for (const auto& s : _components)
+    {
+        if (!s || s->size() == 0) continue;
+        const auto& info = component_base::type_info(s->id());
+        const auto* ser  = find_serializer(s->id());
+        if (!info.trivially_copyable && !(ser && ser->save))
+        {
+            gfx::wlog("ecs") << "Skipping component type without serializer in snapshot: " << info.name;
+            continue;
+        }
+        stored.push_back(s.get());
+    }
+    out.write(uint32_t(stored.size()));
+
+    for (const auto* s : stored)
+    {
+        const auto& info = component_base::type_info(s->id());
+        const auto* ser  = find_serializer(s->id());
+        const bool  bulk = info.trivially_copyable && !(ser && ser->save);
+
+        const auto name_length = static_cast<uint32_t>(strlen(info.name));
+        out.write(name_length);
+        out.write(info.name, name_length);
+        out.write(uint64_t(info.size));
+        out.write(uint8_t(bulk));
+        out.write(uint64_t(s->size()));
+
+        if (bulk)
+        {
+            // Trivially copyable components are dumped page by page, including their entity handles.
+            out.write(uint64_t(s->size() * s->stride()));
+            for (auto first = 0ull; first < s->size();)
+            {
+                const auto last = s->contiguous_end(first, s->size());
+                out.write(s->at(first), (last - first) * s->stride());
+                first = last;
+            }
+        }
+        else
+        {
+            buffer_writer buffer;
+            for (auto i = 0ull; i < s->size(); ++i)
+            {
+                buffer.write(s->at(i)->entity.value());
+                ser->save(buffer, s->at(i));
+            }
+            out.write(uint64_t(buffer.buffer.size()));
+            out.write(buffer.buffer.data(), buffer.buffer.size());
+        }
+    }
+}
+
+std::vector<entity> ecs::load_snapshot(std::istream& in)
+{
+    stream_reader reader(in);
+    return load_snapshot(reader);
+}
+
+std::vector<entity> ecs::load_snapshot(gfx::span<const std::byte> data)
+{
+    memory_reader reader(data);
+    return load_snapshot(reader);
+}
+
+std::vector<entity> ecs::load_snapshot(snapshot_reader& source)
+{
+    std::vector<entity> result;
+    checked_reader      in(source);
+
+    uint32_t magic   = 0;
+    uint32_t version = 0;
+    if (!in.read(magic) || !in.read(version) || magic != snapshot_magic)
+    {
+        gfx::elog("ecs") << "Invalid snapshot.";
+        return result;
+    }
+    if (version != snapshot_version)
+    {
+        gfx::elog("ecs") << "Unsupported snapshot version " << version << ", expected " << snapshot_version;
+        return result;
+    }
+
+    uint64_t              entity_count = 0;
+    std::vector<uint64_t> handles;
+    in.read(entity_count);
+    while (in.ok() && handles.size() < entity_count)
+    {
+        const auto first = handles.size();
+        handles.resize(first + static_cast<size_t>(std::min<uint64_t>(entity_count - first, handle_chunk)));
+        in.read(handles.data() + first, (handles.size() - first) * sizeof(uint64_t));
+    }
+    if (!in.ok())
+    {
+        gfx::elog("ecs") << "Truncated snapshot.";
+        return result;
+    }
+
+    // Every entity of the snapshot gets a new handle, the table maps old entity indices to them.
+    std::vector<entity_handle> remap_table;
+    std::vector<uint32_t>      old_generations;
+    uint32_t                   max_index = 0;
+    result.reserve(handles.size());
+    for (const auto value : handles)
+    {
+        const entity_handle old{static_cast<uint32_t>(value), static_cast<uint32_t>(value >> 32)};
+        if (old.index >= remap_table.size())
+        {
+            remap_table.resize(old.index + 1, null_entity);
+            old_generations.resize(old.index + 1);
+        }
+        const auto hnd              = allocate_entity();
+        remap_table[old.index]      = hnd;
+        old_generations[old.index]  = old.generation;
+        max_index                   = std::max(max_index, hnd.index);
+        result.push_back(entity{this, hnd});
+    }
+    const auto remap = [&](entity_handle old) {
+        return old.index < remap_table.size() && old_generations[old.index] == old.generation ? remap_table[old.index] : null_entity;
+    };
+
+    // Nothing of the snapshot is visible before the end, so a failed load removes the new entities again without any
+    // notifications.
+    const auto fail = [&](const char* reason) {
+        gfx::elog("ecs") << "Failed to load snapshot: " << reason;
+        for (auto it = result.rbegin(); it != result.rend(); ++it)
+        {
+            auto& slot = _entities[it->_handle.index];
+            for (auto id = 0ull; id < _components.size(); ++id)
+                if (slot.signature.test(id)) _components[id]->discard(it->_handle);
+            slot.signature.reset();
+            slot.alive = false;
+            ++slot.generation;
+            _free_entities.push_back(it->_handle.index);
+            --_entity_count;
+        }
+        result.clear();
+        return result;
+    };
+
+    uint32_t type_count = 0;
+    if (!in.read(type_count)) return fail("truncated component types");
+    for (auto t = 0u; t < type_count; ++t)
+    {
+        uint32_t    name_length = 0;
+        std::string name;
+        uint64_t    size    = 0;
+        uint8_t     bulk    = 0;
+        uint64_t    count   = 0;
+        uint64_t    payload = 0;
+        if (!in.read(name_length) || name_length > max_name_length) return fail("invalid component type name");
+        name.resize(name_length);
+        if (!in.read(name.data(), name_length) || !in.read(size) || !in.read(bulk) || !in.read(count) || !in.read(payload))
+            return fail("truncated component type");
+        // Every entity owns at most one component of each type.
+        if (count > handles.size()) return fail("invalid component count");
+
+        const auto  id  = find_type(name);
+        const auto* ser = component_base::is_valid(id) ? find_serializer(id) : nullptr;
+        if (!component_base::is_valid(id) || component_base::type_size(id) != size
+            || (bulk ? !component_base::type_info(id).trivially_copyable : !(ser && ser->load)))
+        {
+            gfx::wlog("ecs") << "Skipping incompatible component type in snapshot: " << name;
+            if (!in.skip(payload)) return fail("truncated components");
+            continue;
+        }
+
+        auto&      s          = storage(id);
+        const auto references = ser ? ser->references : std::vector<entity_reference_fun>{};
+        const auto attach     = [&](component_base* c) {
+            for (const auto& r : references) r(c) = remap(r(c));
+            c->added_tick   = _tick;
+            c->changed_tick = _tick;
+            _entities[c->entity.index].signature.set(static_cast<size_t>(id));
+        };
+
+        if (bulk)
+        {
+            if (payload != count * s.stride()) return fail("invalid component payload");
+            const auto first = s.append_uninitialized(count, max_index);
+            const auto end   = first + count;
+            for (auto begin = first; begin < end && in.ok();)
+            {
+                const auto last = s.contiguous_end(begin, end);
+                in.read(s.at(begin), (last - begin) * s.stride());
+                begin = last;
+            }
+            if (!in.ok())
+            {
+                s.discard_uninitialized(count);
+                return fail("truncated components");
+            }
+
+            // Components of entities missing in the snapshot and repeated components are dropped by compacting the array.
+            auto kept = first;
+            for (auto i = first; i < end; ++i)
+            {
+                component_base* const c = s.at(i);
+                c->entity               = remap(c->entity);
+                if (!c->entity || s.contains(c->entity)) continue;
+                if (kept != i) memcpy(s.at(kept), c, s.stride());
+                attach(s.at(kept));
+                s.link(kept++);
+            }
+            s.discard_uninitialized(end - kept);
+        }
+        else
+        {
+            const auto& info   = component_base::type_info(id);
+            void* const memory = ::operator new(info.size, std::align_val_t(info.alignment));
+            bool        loaded = true;
+            for (auto i = 0ull; i < count && loaded; ++i)
+            {
+                uint64_t              old       = 0;
+                component_base* const component = in.read(old) ? ser->load(in, memory) : nullptr;
+                loaded                          = component && in.ok();
+                const auto hnd = remap(entity_handle{static_cast<uint32_t>(old), static_cast<uint32_t>(old >> 32)});
+                if (loaded && hnd) attach(s.emplace(hnd, component, _tick));
+                if (component) info.deleter(component);
+            }
+            ::operator delete(memory, std::align_val_t(info.alignment));
+            if (!loaded) return fail("truncated components");
+        }
+    }
+
+    for (const auto& e : result)
+    {
+        update_queries(e._handle);
+        for (auto& l : _listeners)
+            if (matches(*l.target, _entities[e._handle.index].signature)) notify(l, notification_type::add, e._handle);
+    }
+    return result;
+}
+
+void ecs::clear()
+{
+    for (auto i = 0ull; i < _entities.size(); ++i)
+        if (_entities[i].alive) delete_entity({this, entity_handle{static_cast<uint32_t>(i), _entities[i].generation}});
+}
+}    // namespace ecs
+}    // namespace v1
+}    // namespace gfx
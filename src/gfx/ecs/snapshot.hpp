@@ -0,0 +1,98 @@
+#pragma once
+
+#include "component.hpp"
+#include <filesystem>
+#include <functional>
+#include <gfx/type.hpp>
+#include <iosfwd>
+
+namespace gfx {
+inline namespace v1 {
+namespace ecs {
+constexpr uint32_t snapshot_magic   = 0x53434547;    // "GECS"
+constexpr uint32_t snapshot_version = 1;
+
+class snapshot_writer
+{
+public:
+    virtual ~snapshot_writer()                              = default;
+    virtual void write(const void* data, size_t size) = 0;
+
+    template<typename T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write(&value, sizeof(T));
+    }
+};
+
+class snapshot_reader
+{
+public:
+    virtual ~snapshot_reader()                  = default;
+    virtual bool read(void* data, size_t size) = 0;
+    virtual bool skip(size_t size)             = 0;
+
+    template<typename T>
+    bool read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return read(&value, sizeof(T));
+    }
+};
+
+// Serializers are required for all component types which are not trivially copyable. The load function constructs a
+// component read from the snapshot in uninitialized memory. Failed reads make the whole snapshot fail to load.
+using component_save_fun = void (*)(snapshot_writer& out, const component_base* component);
+using component_load_fun = component_base* (*)(snapshot_reader& in, void* memory);
+// Returns a reference to an entity handle stored in a component.
+using entity_reference_fun = std::function<entity_handle&(component_base* component)>;
+
+struct component_serializer
+{
+    component_save_fun                save = nullptr;
+    component_load_fun                load = nullptr;
+    std::vector<entity_reference_fun> references;
+};
+
+const component_serializer* find_serializer(id_t id);
+bool                        register_serializer(id_t id, component_save_fun save, component_load_fun load);
+// Entity handles stored in components are remapped to the newly created entities when a snapshot is loaded.
+bool register_entity_reference(id_t id, entity_reference_fun reference);
+// The id is only requested when serializers are looked up, so references can be registered during static
+// initialization, when the ids of the component types might not be assigned yet.
+bool register_entity_reference(id_t (*id)(), entity_reference_fun reference);
+
+template<typename T>
+bool register_entity_reference(entity_handle T::*member)
+{
+    return register_entity_reference(+[]() { return T::id; },
+                                     [member](component_base* c) -> entity_handle& { return static_cast<T*>(c)->*member; });
+}
+
+// Read-only memory mapping of a snapshot file, which can be loaded without any intermediate copies.
+class mapped_snapshot
+{
+public:
+    explicit mapped_snapshot(const std::filesystem::path& path);
+    ~mapped_snapshot();
+
+    mapped_snapshot(const mapped_snapshot& other) = delete;
+    mapped_snapshot& operator=(const mapped_snapshot& other) = delete;
+
+    gfx::span<const std::byte> data() const noexcept;
+    explicit                   operator bool() const noexcept;
+
+private:
+    const std::byte* _data = nullptr;
+    size_t           _size = 0;
+#if defined(_WIN32)
+    void* _file    = nullptr;
+    void* _mapping = nullptr;
+#else
+    int _file = -1;
+#endif
+};
+}    // namespace ecs
+}    // namespace v1
+}    // namespace gfx
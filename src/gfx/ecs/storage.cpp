@@ -0,0 +1,196 @@
+#include "storage.hpp"
+#include <algorithm>
+
+namespace gfx {
+inline namespace v1 {
+namespace ecs {
+component_storage::component_storage(id_t id)
+      : _id(id)
+      , _stride(component_base::type_size(id))
+      , _alignment(component_base::type_alignment(id))
+      , _page_shift(0)
+      , _creator(component_base::get_creator(id))
+      , _mover(component_base::get_mover(id))
+      , _deleter(component_base::get_deleter(id))
+{
+    // Power-of-two page capacities turn index lookups into a shift and a mask.
+    while ((size_t(2) << _page_shift) * _stride <= page_size) ++_page_shift;
+}
+
+component_storage::~component_storage()
+{
+    clear();
+    release_pages(0);
+}
+
+id_t component_storage::id() const noexcept
+{
+    return _id;
+}
+
+size_t component_storage::size() const noexcept
+{
+    return _size;
+}
+
+size_t component_storage::stride() const noexcept
+{
+    return _stride;
+}
+
+size_t component_storage::page_capacity() const noexcept
+{
+    return size_t(1) << _page_shift;
+}
+
+size_t component_storage::contiguous_end(size_t index, size_t end) const noexcept
+{
+    return std::min(end, ((index >> _page_shift) + 1) << _page_shift);
+}
+
+bool component_storage::contains(entity_handle e) const noexcept
+{
+    return e.index < _sparse.size() && _sparse[e.index] != npos && at(_sparse[e.index])->entity == e;
+}
+
+component_base* component_storage::get(entity_handle e) noexcept
+{
+    return contains(e) ? at(_sparse[e.index]) : nullptr;
+}
+
+component_base* component_storage::at(size_t index) const noexcept
+{
+    return reinterpret_cast<component_base*>(_pages[index >> _page_shift] + (index & (page_capacity() - 1)) * _stride);
+}
+
+void component_storage::reserve(size_t count, uint32_t max_index)
+{
+    const size_t pages = (count + page_capacity() - 1) >> _page_shift;
+    _pages.reserve(pages);
+    while (_pages.size() < pages)
+        _pages.push_back(static_cast<std::byte*>(::operator new(page_capacity() * _stride, std::align_val_t(_alignment))));
+    if (max_index >= _sparse.size()) _sparse.resize(max_index + 1, npos);
+}
+
+// A replaced component is only erased after the new one is constructed, as the source may be the replaced component or
+// the last one, which the erase moves.
+component_base* component_storage::emplace(entity_handle e, const component_base* component, uint32_t tick)
+{
+    const uint32_t previous = contains(e) ? _sparse[e.index] : npos;
+
+    reserve(_size + 1, e.index);
+    component_base* result = _creator(at(_size), e, component);
+    result->added_tick     = tick;
+    result->changed_tick   = tick;
+    _sparse[e.index]       = static_cast<uint32_t>(_size++);
+    if (previous != npos)
+    {
+        erase(previous);
+        result = at(previous);
+    }
+    return result;
+}
+
+bool component_storage::remove(entity_handle e, uint32_t tick)
+{
+    if (!contains(e)) return false;
+    erase(_sparse[e.index]);
+    if (_log_removals) _removed.push_back(removal{e, tick});
+    return true;
+}
+
+bool component_storage::discard(entity_handle e)
+{
+    if (!contains(e)) return false;
+    erase(_sparse[e.index]);
+    return true;
+}
+
+size_t component_storage::append_uninitialized(size_t count, uint32_t max_index)
+{
+    reserve(_size + count, max_index);
+    const size_t first = _size;
+    _size += count;
+    return first;
+}
+
+void component_storage::link(size_t index)
+{
+    _sparse[at(index)->entity.index] = static_cast<uint32_t>(index);
+}
+
+void component_storage::discard_uninitialized(size_t count)
+{
+    _size -= std::min(count, _size);
+}
+
+void component_storage::erase(uint32_t index)
+{
+    const auto last = static_cast<uint32_t>(_size - 1);
+
+    component_base* const dst = at(index);
+    _sparse[dst->entity.index] = npos;
+    _deleter(dst);
+    if (index != last)
+    {
+        const auto moved             = _mover(dst, at(last));
+        _sparse[moved->entity.index] = index;
+    }
+    --_size;
+}
+
+void component_storage::clear()
+{
+    for (auto i = 0ull; i < _size; ++i) _deleter(at(i));
+    _size = 0;
+    _sparse.clear();
+    _removed.clear();
+}
+
+void component_storage::shrink_to_fit()
+{
+    release_pages((_size + page_capacity() - 1) >> _page_shift);
+}
+
+void component_storage::release_pages(size_t keep)
+{
+    for (auto i = keep; i < _pages.size(); ++i) ::operator delete(_pages[i], std::align_val_t(_alignment));
+    _pages.resize(std::min(keep, _pages.size()));
+}
+
+void component_storage::request_removals(uint64_t frame) noexcept
+{
+    _log_removals       = true;
+    _removals_requested = frame;
+}
+
+void component_storage::stop_removals() noexcept
+{
+    _log_removals = false;
+    _removed.clear();
+}
+
+bool component_storage::logs_removals() const noexcept
+{
+    return _log_removals;
+}
+
+uint64_t component_storage::removals_requested() const noexcept
+{
+    return _removals_requested;
+}
+
+gfx::span<const component_storage::removal> component_storage::removed_since(uint32_t tick) const noexcept
+{
+    const auto it = std::upper_bound(_removed.begin(), _removed.end(), tick, [](uint32_t t, const removal& r) { return t < r.tick; });
+    return gfx::span<const removal>(_removed.data() + std::distance(_removed.begin(), it), std::distance(it, _removed.end()));
+}
+
+void component_storage::trim_removed(uint32_t tick)
+{
+    const auto it = std::upper_bound(_removed.begin(), _removed.end(), tick, [](uint32_t t, const removal& r) { return t < r.tick; });
+    _removed.erase(_removed.begin(), it);
+}
+}    // namespace ecs
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "component.hpp"
+#include <gfx/type.hpp>
+
+namespace gfx {
+inline namespace v1 {
+namespace ecs {
+// Sparse set holding all components of one type. The sparse array maps entity indices to positions in the densely packed
+// component array, which makes lookup, insertion and removal O(1).
+// The dense array is split into fixed-size pages which are never reallocated, so growing the storage does not move
+// existing components. Removing a component moves the last one into the gap.
+class component_storage
+{
+public:
+    constexpr static uint32_t npos      = ~0u;
+    constexpr static size_t   page_size = 16384;
+
+    struct removal
+    {
+        entity_handle entity;
+        uint32_t      tick;
+    };
+
+    explicit component_storage(id_t id);
+    ~component_storage();
+
+    component_storage(const component_storage& other) = delete;
+    component_storage& operator=(const component_storage& other) = delete;
+
+    id_t   id() const noexcept;
+    size_t size() const noexcept;
+    size_t stride() const noexcept;
+    // Number of components stored contiguously in one page.
+    size_t page_capacity() const noexcept;
+    // End of the contiguous run of components starting at index, clamped to end.
+    size_t contiguous_end(size_t index, size_t end) const noexcept;
+
+    bool            contains(entity_handle e) const noexcept;
+    component_base* get(entity_handle e) noexcept;
+    component_base* at(size_t index) const noexcept;
+
+    // Preallocates room for count components and sparse entries up to max_index, so a following batch of emplace calls
+    // does not allocate.
+    void            reserve(size_t count, uint32_t max_index);
+    component_base* emplace(entity_handle e, const component_base* component, uint32_t tick);
+    bool            remove(entity_handle e, uint32_t tick);
+    // Removes a component without logging the removal, for components that never became visible.
+    bool            discard(entity_handle e);
+    void            clear();
+    // Appends count uninitialized components and returns the index of the first one. Each of them has to be
+    // constructed and then registered with link(...).
+    size_t append_uninitialized(size_t count, uint32_t max_index);
+    void   link(size_t index);
+    // Drops the last count components without destroying them, only valid for trivially copyable types.
+    void discard_uninitialized(size_t count);
+    // Releases pages that are not used anymore.
+    void shrink_to_fit();
+
+    // Removals are only logged while a system tracks them. Each request keeps the log enabled for the given frame, so
+    // that ecs::next_frame can stop logging and drop the log once no system asked for it anymore.
+    void     request_removals(uint64_t frame) noexcept;
+    void     stop_removals() noexcept;
+    bool     logs_removals() const noexcept;
+    uint64_t removals_requested() const noexcept;
+    // Entities that lost their component after the given tick, in removal order.
+    gfx::span<const removal> removed_since(uint32_t tick) const noexcept;
+    // Forgets all removals up to and including the given tick.
+    void trim_removed(uint32_t tick);
+
+private:
+    id_t                    _id;
+    size_t                  _stride;
+    size_t                  _alignment;
+    size_t                  _page_shift;
+    component_creator_fun   _creator;
+    component_mover_fun     _mover;
+    component_deleter_fun   _deleter;
+    std::vector<uint32_t>   _sparse;
+    std::vector<std::byte*> _pages;    // Used pages first, followed by free pages kept for reuse.
+    size_t                  _size = 0;
+    std::vector<removal>    _removed;
+    bool                    _log_removals       = false;
+    uint64_t                _removals_requested = 0;
+
+    void erase(uint32_t index);
+    void release_pages(size_t keep);
+};
+}    // namespace ecs
+}    // namespace v1
+}    // namespace gfx
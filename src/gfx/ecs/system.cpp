@@ -9,8 +9,42 @@ void system_base::add_component_type(id_t id, component_flags flags)
     _component_flags.push_back(flags);
 }
 
+void system_base::set_options(system_options options)
+{
+    _options = options;
+}
+
+void system_base::set_chunk_size(size_t size)
+{
+    _chunk_size = std::max<size_t>(size, 1);
+}
+
+void system_base::track_removed(id_t id)
+{
+    _removed_types.push_back(id);
+}
+
 void system_base::update(double delta, component_base** components) const {}
 
+void system_base::update_removed(double delta, id_t id, gfx::span<const entity_handle> entities) const {}
+
+void system_base::update_batch(double delta, const component_batch& batch) const
+{
+    if (batch.has_rows())
+    {
+        for (auto i = 0ull; i < batch.size(); ++i) update(delta, batch.row(i));
+    }
+    else
+    {
+        std::vector<component_base*> components(batch.type_count());
+        for (auto i = 0ull; i < batch.size(); ++i)
+        {
+            for (auto t = 0ull; t < batch.type_count(); ++t) components[t] = batch.get(t, i);
+            update(delta, components.data());
+        }
+    }
+}
+
 const std::vector<id_t>& system_base::types() const
 {
     return _component_types;
@@ -21,6 +55,26 @@ const std::vector<component_flags>& system_base::flags() const
     return _component_flags;
 }
 
+const system_options& system_base::options() const noexcept
+{
+    return _options;
+}
+
+size_t system_base::chunk_size() const noexcept
+{
+    return _chunk_size;
+}
+
+const std::vector<id_t>& system_base::removed_types() const noexcept
+{
+    return _removed_types;
+}
+
+uint32_t system_base::last_run() const noexcept
+{
+    return _last_run;
+}
+
 void system_list::add(system_base& system)
 {
     _systems.push_back(std::ref(system));
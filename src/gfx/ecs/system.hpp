@@ -1,5 +1,6 @@
 #pragma once
 
+#include "batch.hpp"
 #include "component.hpp"
 #include <algorithm>
 #include <execution>
@@ -11,12 +12,31 @@ namespace ecs {
 enum class component_flag : uint32_t
 {
     optional = 1 << 0,
+    // Only entities whose component was changed or added since the last run of the system are matched.
+    changed = 1 << 1,
+    // Only entities whose component was added since the last run of the system are matched.
+    added = 1 << 2,
+    // Every matched component is marked as changed when the system is updated.
+    mutated = 1 << 3,
 };
 using component_flags = gfx::flags<uint32_t, component_flag>;
 
+enum class system_option : uint32_t
+{
+    // The system may be updated from multiple threads at once, each one working on a distinct chunk of entities.
+    thread_safe = 1 << 0,
+};
+using system_options = gfx::flags<uint32_t, system_option>;
+
+class ecs;
+class query;
 class system_base
 {
+    friend class ecs;
+
 public:
+    constexpr static size_t default_chunk_size = 1024;
+
     virtual ~system_base()                = default;
     system_base()                         = default;
     system_base(const system_base& other) = default;
@@ -25,17 +45,35 @@ public:
     system_base& operator=(system_base&& other) = default;
 
     virtual void                        update(double delta, component_base** components) const;
+    // Called once per chunk of matched entities. The default implementation forwards every entity to update(...),
+    // override it to process a whole chunk at once.
+    virtual void                        update_batch(double delta, const component_batch& batch) const;
+    // Called before the update with all entities that lost a component registered with track_removed(...) since the
+    // last run of the system. Removals are logged from the first update of a system tracking them on, and only as long
+    // as one is updated at least every other frame.
+    virtual void                        update_removed(double delta, id_t id, gfx::span<const entity_handle> entities) const;
     const std::vector<id_t>&            types() const;
     const std::vector<component_flags>& flags() const;
+    const system_options&               options() const noexcept;
+    size_t                              chunk_size() const noexcept;
+    const std::vector<id_t>&            removed_types() const noexcept;
+    uint32_t                            last_run() const noexcept;
 
 protected:
     template<typename T, typename = std::enable_if_t<std::is_convertible_v<T, component<T>>>>
 	void add_component_type(component_flags flags = {}) { add_component_type(T::id, flags); }
     void add_component_type(id_t id, component_flags flags = {});
+    void set_options(system_options options);
+    void set_chunk_size(size_t size);
+    void track_removed(id_t id);
 
 private:
     std::vector<id_t>            _component_types;
     std::vector<component_flags> _component_flags;
+    system_options               _options;
+    size_t                       _chunk_size = default_chunk_size;
+    std::vector<id_t>            _removed_types;
+    uint32_t                     _last_run    = 0;
 };
 
 using system = system_base;
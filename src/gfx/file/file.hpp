@@ -14,7 +14,9 @@
 //#endif
 //#endif
 
+#include <cstdlib>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
 #include <variant>
@@ -103,7 +105,23 @@ struct image_info
 using image_data = std::variant<std::vector<float>, std::vector<uint16_t>, std::vector<uint8_t>>;
 struct image_file : file
 {
+    struct free_deleter
+    {
+        void operator()(void* d) const { free(d); }
+    };
+    // Pixels as decoded by stb_image, before they are copied into image_file::data. Reading them through a
+    // host_image_view avoids the copy. Files which cannot be decoded throw a std::runtime_error.
+    struct decoded
+    {
+        uint32_t                           width        = 0;
+        uint32_t                           height       = 0;
+        uint16_t                           channels     = 0;
+        bits                               channel_bits = bits::b8;
+        std::unique_ptr<void, free_deleter> pixels;
+    };
+
     static image_info info(const files::path& path) noexcept;
+    static decoded    decode(const files::path& path, bits channel_bits, uint16_t channels);
     static void       save_png(const files::path& path, uint32_t width, uint32_t height, uint16_t channels, const uint8_t* data);
     static void       save_bmp(const files::path& path, uint32_t width, uint32_t height, uint16_t channels, const uint8_t* data);
     static void       save_tga(const files::path& path, uint32_t width, uint32_t height, uint16_t channels, const uint8_t* data);
@@ -9,6 +9,7 @@
 #include "stb_image.h"
 #include "stb_image_write.h"
 #include <algorithm>
+#include <stdexcept>
 
 namespace gfx
 {
@@ -39,7 +40,7 @@ void image_file::save_hdr(const files::path& path, uint32_t width, uint32_t heig
 
 image_info image_file::info(const files::path& path) noexcept
 {
-    int w, h, c;
+    int w = 0, h = 0, c = 0;
     stbi_info(gfx::file(path).path.string().c_str(), &w, &h, &c);
     image_info info;
     info.width    = uint32_t(w);
@@ -48,54 +49,64 @@ image_info image_file::info(const files::path& path) noexcept
     return info;
 }
 
-image_file::image_file(const files::path& path, bits channel_bits, uint16_t channels)
-        : file(path)
-        , channel_bits(channel_bits)
+image_file::decoded image_file::decode(const files::path& path, bits channel_bits, uint16_t channels)
 {
-    assert(std::clamp<uint16_t>(channels, 1, 4) == channels && "Invalid channel count.");
-    struct deleter
-    {
-        void operator()(void* d) { free(d); }
-    };
-
     stbi_hdr_to_ldr_gamma(1.f);
     stbi_hdr_to_ldr_scale(1.f);
     stbi_ldr_to_hdr_gamma(1.f);
     stbi_ldr_to_hdr_scale(1.f);
 
-    int w, h;
+    const std::string name = gfx::file(path).path.string();
+    int               w = 0, h = 0;
+    decoded           result;
+    switch(channel_bits)
+    {
+    case bits::b8: result.pixels.reset(stbi_load(name.c_str(), &w, &h, nullptr, channels)); break;
+    case bits::b16: result.pixels.reset(stbi_load_16(name.c_str(), &w, &h, nullptr, channels)); break;
+    case bits::b32: result.pixels.reset(stbi_loadf(name.c_str(), &w, &h, nullptr, channels)); break;
+    }
+    if (!result.pixels) throw std::runtime_error("Cannot decode image file " + name + ": " + stbi_failure_reason());
+    assert(std::clamp<uint16_t>(channels, 1, 4) == channels && "Invalid channel count.");
+    result.width        = uint32_t(w);
+    result.height       = uint32_t(h);
+    result.channels     = channels;
+    result.channel_bits = channel_bits;
+    return result;
+}
+
+image_file::image_file(const files::path& path, bits channel_bits, uint16_t channels)
+        : file(path)
+        , channel_bits(channel_bits)
+{
+    const decoded d     = decode(file::path, channel_bits, channels);
+    const size_t  count = size_t(d.width) * d.height * channels;
     switch(channel_bits)
     {
     case bits::b8:
     {
-        std::unique_ptr<void, deleter> data(stbi_load(file::path.string().c_str(), &w, &h, nullptr, channels));
-        uint8_t*                       ptr = static_cast<uint8_t*>(data.get());
-        this->channels                     = channels;
-        this->data                         = std::vector<uint8_t>(ptr, ptr + w * h * channels);
-        _raw                               = std::get<std::vector<uint8_t>>(this->data).data();
+        const auto* ptr = static_cast<const uint8_t*>(d.pixels.get());
+        this->data      = std::vector<uint8_t>(ptr, ptr + count);
+        _raw            = std::get<std::vector<uint8_t>>(this->data).data();
     }
     break;
     case bits::b16:
     {
-        std::unique_ptr<void, deleter> data(stbi_load_16(file::path.string().c_str(), &w, &h, nullptr, channels));
-        uint16_t*                      ptr = static_cast<uint16_t*>(data.get());
-        this->channels                     = channels;
-        this->data                         = std::vector<uint16_t>(ptr, ptr + w * h * channels);
-        _raw                               = std::get<std::vector<uint16_t>>(this->data).data();
+        const auto* ptr = static_cast<const uint16_t*>(d.pixels.get());
+        this->data      = std::vector<uint16_t>(ptr, ptr + count);
+        _raw            = std::get<std::vector<uint16_t>>(this->data).data();
     }
     break;
     case bits::b32:
     {
-        std::unique_ptr<void, deleter> data(stbi_loadf(file::path.string().c_str(), &w, &h, nullptr, channels));
-        float*                         ptr = static_cast<float*>(data.get());
-        this->channels                     = channels;
-        this->data                         = std::vector<float>(ptr, ptr + w * h * channels);
-        _raw                               = std::get<std::vector<float>>(this->data).data();
+        const auto* ptr = static_cast<const float*>(d.pixels.get());
+        this->data      = std::vector<float>(ptr, ptr + count);
+        _raw            = std::get<std::vector<float>>(this->data).data();
     }
     break;
     }
-    width  = uint32_t(w);
-    height = uint32_t(h);
+    this->channels = channels;
+    width          = d.width;
+    height         = d.height;
 }
 
 image_file::image_file(image_file&& other) noexcept
@@ -17,17 +17,24 @@
 #include <gfx/graphics/binding_layout.hpp>
 #include <gfx/graphics/binding_set.hpp>
 #include <gfx/graphics/command_list.hpp>
+#include <gfx/graphics/compressed_image.hpp>
 #include <gfx/graphics/device_buffer.hpp>
 #include <gfx/graphics/device_image.hpp>
+#include <gfx/graphics/features.hpp>
 #include <gfx/graphics/fence.hpp>
 #include <gfx/graphics/formats.hpp>
 #include <gfx/graphics/framebuffer.hpp>
 #include <gfx/graphics/host_buffer.hpp>
 #include <gfx/graphics/host_image.hpp>
+#include <gfx/graphics/host_image_pyramid.hpp>
+#include <gfx/graphics/host_image_view.hpp>
+#include <gfx/graphics/image_statistics.hpp>
 #include <gfx/graphics/image_view.hpp>
+#include <gfx/graphics/mapped_image.hpp>
 #include <gfx/graphics/pipeline.hpp>
 #include <gfx/graphics/sampler.hpp>
 #include <gfx/graphics/shader.hpp>
+#include <gfx/graphics/summed_area_table.hpp>
 #include <gfx/graphics/swapchain.hpp>
 
 // Includes for gfx/data:
@@ -56,4 +63,5 @@
 
 // Includes for gfx/ecs:
 #include <gfx/ecs/ecs.hpp>
-#include <gfx/ecs/defaults/camera.hpp>
\ No newline at end of file
+#include <gfx/ecs/defaults/camera.hpp>
+#include <gfx/ecs/defaults/hierarchy.hpp>
\ No newline at end of file
@@ -0,0 +1,698 @@
+#include "block_compression.hpp"
+#include <cfloat>
+
+namespace gfx {
+inline namespace v1 {
+namespace detail {
+namespace {
+constexpr std::array<int, 4>  weights2{0, 21, 43, 64};
+constexpr std::array<int, 8>  weights3{0, 9, 18, 27, 37, 46, 55, 64};
+constexpr std::array<int, 16> weights4{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+glm::ivec4 interpolate(const glm::ivec4& a, const glm::ivec4& b, const int weight)
+{
+    return ((64 - weight) * a + weight * b + 32) / 64;
+}
+
+uint64_t read_bytes(const std::byte* data, const size_t count)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < count; ++i) value |= std::to_integer<uint64_t>(data[i]) << (8 * i);
+    return value;
+}
+
+void write_bytes(std::byte* data, const uint64_t value, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i) data[i] = std::byte((value >> (8 * i)) & 0xff);
+}
+
+// BC6H and BC7 blocks are sequences of bit fields starting at the lowest bit.
+class bit_writer
+{
+public:
+    explicit bit_writer(std::byte* data) : _data(data) {}
+
+    void write(const uint32_t value, const uint32_t bits)
+    {
+        for (uint32_t i = 0; i < bits; ++i, ++_position)
+            if ((value >> i) & 1) _data[_position >> 3] |= std::byte(1 << (_position & 7));
+    }
+
+private:
+    std::byte* _data;
+    uint32_t   _position = 0;
+};
+
+class bit_reader
+{
+public:
+    explicit bit_reader(const std::byte* data) : _data(data) {}
+
+    int read(const uint32_t bits)
+    {
+        int value = 0;
+        for (uint32_t i = 0; i < bits; ++i, ++_position)
+            value |= ((std::to_integer<int>(_data[_position >> 3]) >> (_position & 7)) & 1) << i;
+        return value;
+    }
+
+private:
+    const std::byte* _data;
+    uint32_t         _position = 0;
+};
+
+int refinements(const compression_quality quality)
+{
+    switch (quality)
+    {
+    case compression_quality::fast: return 0;
+    case compression_quality::normal: return 1;
+    default: return 4;
+    }
+}
+
+struct endpoints
+{
+    glm::vec4 a;
+    glm::vec4 b;
+};
+
+// Endpoints on the principal axis of the masked channels which span the projections of all pixels. The fast quality
+// takes the diagonal of the bounding box instead, mirrored on channels which correlate negatively with the widest one,
+// which is also where the power iteration starts so that it does not start orthogonal to the principal axis.
+endpoints fit_endpoints(const glm::vec4* pixels, const size_t count, const glm::vec4& mask, const compression_quality quality)
+{
+    if (count == 0) return {glm::vec4(0), glm::vec4(0)};
+
+    glm::vec4 mean(0);
+    glm::vec4 low(FLT_MAX);
+    glm::vec4 high(-FLT_MAX);
+    for (size_t i = 0; i < count; ++i) {
+        const glm::vec4 p = pixels[i] * mask;
+        mean += p;
+        low  = glm::min(low, p);
+        high = glm::max(high, p);
+    }
+    mean /= float(count);
+
+    float covariance[4][4] = {};
+    for (size_t i = 0; i < count; ++i) {
+        const glm::vec4 d = pixels[i] * mask - mean;
+        for (int r = 0; r < 4; ++r)
+            for (int c = 0; c < 4; ++c) covariance[r][c] += d[r] * d[c];
+    }
+
+    glm::vec4 axis   = high - low;
+    int       widest = 0;
+    for (int c = 1; c < 4; ++c)
+        if (axis[c] > axis[widest]) widest = c;
+    for (int c = 0; c < 4; ++c)
+        if (covariance[widest][c] < 0.f) axis[c] = -axis[c];
+
+    if (quality != compression_quality::fast) {
+        for (int iteration = 0; iteration < 8; ++iteration) {
+            glm::vec4 next(0);
+            for (int r = 0; r < 4; ++r)
+                for (int c = 0; c < 4; ++c) next[r] += covariance[r][c] * axis[c];
+            const float length = std::max(std::max(std::abs(next.x), std::abs(next.y)), std::max(std::abs(next.z), std::abs(next.w)));
+            if (length < 1e-20f) break;
+            axis = next / length;
+        }
+    }
+
+    const float length2 = glm::dot(axis, axis);
+    if (length2 < 1e-20f) return {mean, mean};
+    float t_min = FLT_MAX;
+    float t_max = -FLT_MAX;
+    for (size_t i = 0; i < count; ++i) {
+        const float t = glm::dot(pixels[i] * mask - mean, axis) / length2;
+        t_min         = std::min(t_min, t);
+        t_max         = std::max(t_max, t);
+    }
+    return {mean + axis * t_min, mean + axis * t_max};
+}
+
+// Least-squares endpoints for pixels at the positions t between them. Pixels with a negative position are ignored.
+bool refine_endpoints(const glm::vec4* pixels, const float* t, const size_t count, endpoints& e)
+{
+    float     aa = 0.f;
+    float     ab = 0.f;
+    float     bb = 0.f;
+    glm::vec4 x(0);
+    glm::vec4 y(0);
+    for (size_t i = 0; i < count; ++i) {
+        if (t[i] < 0.f) continue;
+        const float s = 1.f - t[i];
+        aa += s * s;
+        ab += s * t[i];
+        bb += t[i] * t[i];
+        x += s * pixels[i];
+        y += t[i] * pixels[i];
+    }
+    const float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f) return false;
+    e.a = (bb * x - ab * y) / determinant;
+    e.b = (aa * y - ab * x) / determinant;
+    return true;
+}
+
+// Selects the nearest of the palette entries for a pixel and returns the squared error.
+float select_index(const glm::vec4& pixel, const glm::vec4* palette, const size_t entries, const glm::vec4& mask, uint8_t& index)
+{
+    float best = FLT_MAX;
+    for (size_t e = 0; e < entries; ++e) {
+        const glm::vec4 d        = (pixel - palette[e]) * mask;
+        const float     distance = glm::dot(d, d);
+        if (distance < best) {
+            best  = distance;
+            index = uint8_t(e);
+        }
+    }
+    return best;
+}
+
+// Quantized endpoints, an index per pixel and the squared error of a block.
+struct encoded_block
+{
+    glm::ivec4              e0{0};
+    glm::ivec4              e1{0};
+    glm::ivec2              pbits{0};    // BC7 mode 6 only.
+    std::array<uint8_t, 16> indices{};
+    float                   error = FLT_MAX;
+};
+
+// Alternates between encoding the endpoints with the codec and refitting them to the positions of the selected palette
+// entries, and returns the encoding with the lowest error.
+template<typename Codec>
+encoded_block encode_endpoints(const Codec& codec, const block_pixels& pixels, endpoints e, const compression_quality quality)
+{
+    encoded_block best;
+    for (int i = 0;; ++i) {
+        const encoded_block current = codec.encode(e, pixels);
+        if (current.error < best.error) best = current;
+        if (i == refinements(quality)) break;
+
+        std::array<float, 16> t;
+        for (size_t p = 0; p < 16; ++p) t[p] = codec.position(current, p);
+        if (!refine_endpoints(pixels.data(), t.data(), 16, e)) break;
+    }
+    return best;
+}
+
+// Swaps the endpoints if the index of the first pixel has its highest bit set, which is implied to be zero. All weight
+// tables are symmetric, so the block decodes to the same values.
+void flip_anchor(encoded_block& block, const int max_index)
+{
+    if (block.indices[0] <= max_index / 2) return;
+    std::swap(block.e0, block.e1);
+    std::swap(block.pbits.x, block.pbits.y);
+    for (auto& index : block.indices) index = uint8_t(max_index - index);
+}
+
+uint16_t pack_565(const glm::vec4& c)
+{
+    const glm::ivec3 q(glm::round(glm::clamp(glm::vec3(c), 0.f, 1.f) * glm::vec3(31, 63, 31)));
+    return uint16_t((q.r << 11) | (q.g << 5) | q.b);
+}
+
+glm::ivec4 unpack_565(const uint16_t c)
+{
+    const int r = c >> 11;
+    const int g = (c >> 5) & 63;
+    const int b = c & 31;
+    return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255};
+}
+
+// The colors of a BC1 block. With three colors, the last entry is transparent black.
+std::array<glm::vec4, 4> bc1_palette(const uint16_t c0, const uint16_t c1, const bool four_colors)
+{
+    const glm::ivec4         a = unpack_565(c0);
+    const glm::ivec4         b = unpack_565(c1);
+    std::array<glm::vec4, 4> palette;
+    palette[0] = glm::vec4(a) / 255.f;
+    palette[1] = glm::vec4(b) / 255.f;
+    if (four_colors) {
+        palette[2] = glm::vec4((2 * a + b) / 3) / 255.f;
+        palette[3] = glm::vec4((a + 2 * b) / 3) / 255.f;
+    } else {
+        palette[2] = glm::vec4((a + b) / 2) / 255.f;
+        palette[3] = glm::vec4(0);
+    }
+    return palette;
+}
+
+struct bc1_codec
+{
+    glm::vec4 mask{1, 1, 1, 0};
+    bool      transparent;         // Pixels with an alpha below one half use the transparent entry.
+    bool      four_colors_only;    // BC3 color blocks have four colors regardless of the endpoint order.
+
+    bool four_colors(const encoded_block& block) const { return four_colors_only || block.e0.x > block.e1.x; }
+
+    encoded_block encode(const endpoints& e, const block_pixels& pixels) const
+    {
+        encoded_block result;
+        result.e0.x = pack_565(e.a);
+        result.e1.x = pack_565(e.b);
+        if (transparent ? result.e0.x > result.e1.x : result.e0.x < result.e1.x) std::swap(result.e0, result.e1);
+
+        const bool four    = four_colors(result);
+        const auto palette = bc1_palette(uint16_t(result.e0.x), uint16_t(result.e1.x), four);
+        result.error       = 0.f;
+        for (size_t i = 0; i < 16; ++i) {
+            if (transparent && pixels[i].a < 0.5f)
+                result.indices[i] = 3;
+            else
+                result.error += select_index(pixels[i], palette.data(), four ? 4 : 3, mask, result.indices[i]);
+        }
+        return result;
+    }
+
+    float position(const encoded_block& block, const size_t pixel) const
+    {
+        const bool four = four_colors(block);
+        switch (block.indices[pixel])
+        {
+        case 0: return 0.f;
+        case 1: return 1.f;
+        case 2: return four ? 1.f / 3.f : 0.5f;
+        default: return four ? 2.f / 3.f : -1.f;
+        }
+    }
+};
+
+void encode_bc1(const block_pixels& pixels, const compression_quality quality, const bool four_colors_only, std::byte* block)
+{
+    const bool transparent = !four_colors_only && std::any_of(pixels.begin(), pixels.end(), [](const glm::vec4& p) { return p.a < 0.5f; });
+    const bc1_codec codec{glm::vec4(1, 1, 1, 0), transparent, four_colors_only};
+
+    block_pixels opaque;
+    size_t       count = 0;
+    for (const auto& p : pixels)
+        if (!transparent || p.a >= 0.5f) opaque[count++] = p;
+    const encoded_block result = encode_endpoints(codec, pixels, fit_endpoints(opaque.data(), count, codec.mask, quality), quality);
+
+    uint32_t indices = 0;
+    for (size_t i = 0; i < 16; ++i) indices |= uint32_t(result.indices[i]) << (2 * i);
+    write_bytes(block, uint64_t(result.e0.x), 2);
+    write_bytes(block + 2, uint64_t(result.e1.x), 2);
+    write_bytes(block + 4, indices, 4);
+}
+
+void decode_bc1(const std::byte* block, const bool four_colors_only, block_pixels& pixels)
+{
+    const auto     c0      = uint16_t(read_bytes(block, 2));
+    const auto     c1      = uint16_t(read_bytes(block + 2, 2));
+    const auto     palette = bc1_palette(c0, c1, four_colors_only || c0 > c1);
+    const uint64_t indices = read_bytes(block + 4, 4);
+    for (size_t i = 0; i < 16; ++i) pixels[i] = palette[(indices >> (2 * i)) & 3];
+}
+
+// The values of a BC4 block. If the first endpoint is not greater, there are four interpolated values, zero and one.
+std::array<glm::vec4, 8> bc4_palette(const int channel, const int r0, const int r1)
+{
+    std::array<float, 8> values{r0 / 255.f, r1 / 255.f};
+    if (r0 > r1) {
+        for (int i = 2; i < 8; ++i) values[i] = ((8 - i) * r0 + (i - 1) * r1) / (7 * 255.f);
+    } else {
+        for (int i = 2; i < 6; ++i) values[i] = ((6 - i) * r0 + (i - 1) * r1) / (5 * 255.f);
+        values[6] = 0.f;
+        values[7] = 1.f;
+    }
+    std::array<glm::vec4, 8> palette;
+    for (size_t i = 0; i < 8; ++i) palette[i][channel] = values[i];
+    return palette;
+}
+
+struct bc4_codec
+{
+    glm::vec4 mask;
+    int       channel;
+    bool      six_values;
+
+    encoded_block encode(const endpoints& e, const block_pixels& pixels) const
+    {
+        encoded_block result;
+        result.e0.x = int(std::round(glm::clamp(e.a[channel], 0.f, 1.f) * 255.f));
+        result.e1.x = int(std::round(glm::clamp(e.b[channel], 0.f, 1.f) * 255.f));
+        if (six_values ? result.e0.x > result.e1.x : result.e0.x < result.e1.x) std::swap(result.e0, result.e1);
+
+        const auto palette = bc4_palette(channel, result.e0.x, result.e1.x);
+        result.error       = 0.f;
+        for (size_t i = 0; i < 16; ++i) result.error += select_index(pixels[i], palette.data(), 8, mask, result.indices[i]);
+        return result;
+    }
+
+    float position(const encoded_block& block, const size_t pixel) const
+    {
+        const int index = block.indices[pixel];
+        if (index < 2) return float(index);
+        if (block.e0.x > block.e1.x) return (index - 1) / 7.f;
+        return index < 6 ? (index - 1) / 5.f : -1.f;
+    }
+};
+
+void encode_bc4(const block_pixels& pixels, const int channel, const compression_quality quality, std::byte* block)
+{
+    glm::vec4 mask(0);
+    mask[channel] = 1.f;
+    bc4_codec     codec{mask, channel, false};
+    encoded_block best = encode_endpoints(codec, pixels, fit_endpoints(pixels.data(), 16, mask, quality), quality);
+
+    // The six-value mode spends two entries on zero and one and interpolates between the other values.
+    if (quality == compression_quality::high) {
+        block_pixels inner;
+        size_t       count = 0;
+        for (const auto& p : pixels)
+            if (p[channel] > 0.5f / 255.f && p[channel] < 254.5f / 255.f) inner[count++] = p;
+        codec.six_values         = true;
+        const encoded_block six = encode_endpoints(codec, pixels, fit_endpoints(inner.data(), count, mask, quality), quality);
+        if (six.error < best.error) best = six;
+    }
+
+    uint64_t indices = 0;
+    for (size_t i = 0; i < 16; ++i) indices |= uint64_t(best.indices[i]) << (3 * i);
+    block[0] = std::byte(best.e0.x);
+    block[1] = std::byte(best.e1.x);
+    write_bytes(block + 2, indices, 6);
+}
+
+void decode_bc4(const std::byte* block, const int channel, block_pixels& pixels)
+{
+    const auto     palette = bc4_palette(channel, std::to_integer<int>(block[0]), std::to_integer<int>(block[1]));
+    const uint64_t indices = read_bytes(block + 2, 6);
+    for (size_t i = 0; i < 16; ++i) pixels[i][channel] = palette[(indices >> (3 * i)) & 7][channel];
+}
+
+// Expands BC7 endpoint components to eight bits by repeating their highest bits.
+glm::ivec4 expand_bits(const glm::ivec4& c, const int bits)
+{
+    if (bits >= 8) return c;
+    glm::ivec4 result;
+    for (int i = 0; i < 4; ++i) result[i] = (c[i] << (8 - bits)) | (c[i] >> (2 * bits - 8));
+    return result;
+}
+
+// One set of BC7 endpoints, either with a p-bit per endpoint appended to seven bits (mode 6), or expanded from the given
+// number of bits (colors and alpha of mode 5).
+struct bc7_codec
+{
+    glm::vec4  mask;
+    const int* weights;
+    size_t     entries;
+    int        bits;
+    bool       has_pbits;
+    glm::ivec2 forced_pbits{-1};    // The p-bits are chosen per endpoint if negative.
+
+    glm::ivec4 value(const glm::ivec4& code, const int pbit) const { return has_pbits ? code * 2 + pbit : expand_bits(code, bits); }
+
+    void quantize(const glm::vec4& v, const int forced_pbit, glm::ivec4& code, int& pbit) const
+    {
+        const glm::vec4 c = glm::clamp(v, 0.f, 1.f) * 255.f;
+        if (!has_pbits) {
+            code = glm::ivec4(glm::round(c * (float((1 << bits) - 1) / 255.f)));
+            pbit = 0;
+            return;
+        }
+        float best = FLT_MAX;
+        for (int p = 0; p < 2; ++p) {
+            if (forced_pbit >= 0 && p != forced_pbit) continue;
+            const glm::ivec4 q     = glm::clamp(glm::ivec4(glm::round((c - float(p)) / 2.f)), 0, 127);
+            const glm::vec4  d     = (glm::vec4(q * 2 + p) - c) * mask;
+            const float      error = glm::dot(d, d);
+            if (error < best) {
+                best = error;
+                code = q;
+                pbit = p;
+            }
+        }
+    }
+
+    encoded_block encode(const endpoints& e, const block_pixels& pixels) const
+    {
+        encoded_block result;
+        quantize(e.a, forced_pbits.x, result.e0, result.pbits.x);
+        quantize(e.b, forced_pbits.y, result.e1, result.pbits.y);
+
+        const glm::ivec4          v0 = value(result.e0, result.pbits.x);
+        const glm::ivec4          v1 = value(result.e1, result.pbits.y);
+        std::array<glm::vec4, 16> palette;
+        for (size_t i = 0; i < entries; ++i) palette[i] = glm::vec4(interpolate(v0, v1, weights[i])) / 255.f;
+        result.error = 0.f;
+        for (size_t i = 0; i < 16; ++i) result.error += select_index(pixels[i], palette.data(), entries, mask, result.indices[i]);
+        return result;
+    }
+
+    float position(const encoded_block& block, const size_t pixel) const { return weights[block.indices[pixel]] / 64.f; }
+};
+
+void write_bc7_mode6(encoded_block b, std::byte* block)
+{
+    flip_anchor(b, 15);
+    bit_writer writer(block);
+    writer.write(1 << 6, 7);
+    for (int c = 0; c < 4; ++c) {
+        writer.write(b.e0[c], 7);
+        writer.write(b.e1[c], 7);
+    }
+    writer.write(b.pbits.x, 1);
+    writer.write(b.pbits.y, 1);
+    for (size_t i = 0; i < 16; ++i) writer.write(b.indices[i], i == 0 ? 3 : 4);
+}
+
+void write_bc7_mode5(encoded_block color, encoded_block alpha, std::byte* block)
+{
+    flip_anchor(color, 3);
+    flip_anchor(alpha, 3);
+    bit_writer writer(block);
+    writer.write(1 << 5, 6);
+    writer.write(0, 2);    // No channel rotation.
+    for (int c = 0; c < 3; ++c) {
+        writer.write(color.e0[c], 7);
+        writer.write(color.e1[c], 7);
+    }
+    writer.write(alpha.e0.a, 8);
+    writer.write(alpha.e1.a, 8);
+    for (size_t i = 0; i < 16; ++i) writer.write(color.indices[i], i == 0 ? 1 : 2);
+    for (size_t i = 0; i < 16; ++i) writer.write(alpha.indices[i], i == 0 ? 1 : 2);
+}
+
+// Encodes with mode 6, which interpolates RGBA endpoints with 4-bit indices. The high quality also searches all
+// p-bit combinations and tries mode 5, which has separate endpoints and indices for the colors and alpha.
+void encode_bc7(const block_pixels& pixels, const compression_quality quality, std::byte* block)
+{
+    bc7_codec       mode6{glm::vec4(1), weights4.data(), 16, 7, true};
+    const endpoints initial = fit_endpoints(pixels.data(), 16, mode6.mask, quality);
+    encoded_block   best    = encode_endpoints(mode6, pixels, initial, quality);
+    if (quality != compression_quality::high) {
+        write_bc7_mode6(best, block);
+        return;
+    }
+
+    for (int p = 0; p < 4; ++p) {
+        mode6.forced_pbits            = glm::ivec2(p & 1, p >> 1);
+        const encoded_block candidate = encode_endpoints(mode6, pixels, initial, quality);
+        if (candidate.error < best.error) best = candidate;
+    }
+
+    const bc7_codec     color_codec{glm::vec4(1, 1, 1, 0), weights2.data(), 4, 7, false};
+    const bc7_codec     alpha_codec{glm::vec4(0, 0, 0, 1), weights2.data(), 4, 8, false};
+    const encoded_block color = encode_endpoints(color_codec, pixels, fit_endpoints(pixels.data(), 16, color_codec.mask, quality), quality);
+    const encoded_block alpha = encode_endpoints(alpha_codec, pixels, fit_endpoints(pixels.data(), 16, alpha_codec.mask, quality), quality);
+    if (color.error + alpha.error < best.error)
+        write_bc7_mode5(color, alpha, block);
+    else
+        write_bc7_mode6(best, block);
+}
+
+std::array<int, 16> read_indices(bit_reader& reader, const int bits)
+{
+    std::array<int, 16> indices;
+    for (size_t i = 0; i < 16; ++i) indices[i] = reader.read(i == 0 ? bits - 1 : bits);
+    return indices;
+}
+
+// Decodes the modes without partitions, 4 to 6. Blocks without a mode decode to zero like on the GPU.
+bool decode_bc7(const std::byte* block, block_pixels& pixels)
+{
+    bit_reader reader(block);
+    int        mode = 0;
+    while (mode < 8 && reader.read(1) == 0) ++mode;
+    if (mode == 8) {
+        pixels.fill(glm::vec4(0));
+        return true;
+    }
+    if (mode < 4 || mode > 6) return false;
+
+    const int  rotation    = mode == 6 ? 0 : reader.read(2);
+    const int  index_mode  = mode == 4 ? reader.read(1) : 0;
+    const int  color_bits  = mode == 4 ? 5 : 7;
+    const int  alpha_bits  = mode == 4 ? 6 : (mode == 5 ? 8 : 7);
+    glm::ivec4 e0;
+    glm::ivec4 e1;
+    for (int c = 0; c < 4; ++c) {
+        e0[c] = reader.read(c < 3 ? color_bits : alpha_bits);
+        e1[c] = reader.read(c < 3 ? color_bits : alpha_bits);
+    }
+    if (mode == 6) {
+        e0 = e0 * 2 + reader.read(1);
+        e1 = e1 * 2 + reader.read(1);
+    } else {
+        const glm::ivec4 color0 = expand_bits(e0, color_bits);
+        const glm::ivec4 color1 = expand_bits(e1, color_bits);
+        e0                      = glm::ivec4(glm::ivec3(color0), expand_bits(e0, alpha_bits).a);
+        e1                      = glm::ivec4(glm::ivec3(color1), expand_bits(e1, alpha_bits).a);
+    }
+
+    // Mode 6 has one set of 4-bit indices, mode 5 one set of 2-bit indices each for colors and alpha. Mode 4 has a set
+    // of 2-bit and one of 3-bit indices, the index mode selects which one the colors use.
+    const int                 primary_bits   = mode == 6 ? 4 : 2;
+    const std::array<int, 16> primary        = read_indices(reader, primary_bits);
+    const int                 secondary_bits = mode == 4 ? 3 : 2;
+    const std::array<int, 16> secondary      = mode == 6 ? primary : read_indices(reader, secondary_bits);
+    const int*                weights_of[]   = {nullptr, nullptr, weights2.data(), weights3.data(), weights4.data()};
+
+    const bool swap                = index_mode == 1;
+    const auto& color_indices      = swap ? secondary : primary;
+    const auto& alpha_indices      = mode == 6 ? primary : (swap ? primary : secondary);
+    const int*  color_weights      = weights_of[swap ? secondary_bits : primary_bits];
+    const int*  alpha_weights      = weights_of[mode == 6 ? primary_bits : (swap ? primary_bits : secondary_bits)];
+    for (size_t i = 0; i < 16; ++i) {
+        glm::ivec4 value = interpolate(e0, e1, color_weights[color_indices[i]]);
+        value.a          = interpolate(e0, e1, alpha_weights[alpha_indices[i]]).a;
+        if (rotation != 0) std::swap(value.a, value[rotation - 1]);
+        pixels[i] = glm::vec4(value) / 255.f;
+    }
+    return true;
+}
+
+// BC6H interpolates the bits of unsigned half floats scaled by 64/31, the decoder scales the result back.
+float bc6h_value(const float v)
+{
+    return glm::packHalf1x16(v > 0.f ? std::min(v, 65504.f) : 0.f) * (64.f / 31.f);
+}
+
+int bc6h_unquantize(const int q)
+{
+    if (q == 0) return 0;
+    if (q == 1023) return 0xffff;
+    return ((q << 16) + 0x8000) >> 10;
+}
+
+glm::ivec4 bc6h_unquantize(const glm::ivec4& q)
+{
+    return {bc6h_unquantize(q.x), bc6h_unquantize(q.y), bc6h_unquantize(q.z), 0};
+}
+
+// Mode 11 of BC6H, one region with 10-bit endpoints and 4-bit indices.
+struct bc6h_codec
+{
+    glm::vec4 mask{1, 1, 1, 0};
+
+    encoded_block encode(const endpoints& e, const block_pixels& pixels) const
+    {
+        encoded_block result;
+        result.e0 = glm::clamp(glm::ivec4(glm::round((e.a - 32.f) / 64.f)), 0, 1023);
+        result.e1 = glm::clamp(glm::ivec4(glm::round((e.b - 32.f) / 64.f)), 0, 1023);
+
+        const glm::ivec4          v0 = bc6h_unquantize(result.e0);
+        const glm::ivec4          v1 = bc6h_unquantize(result.e1);
+        std::array<glm::vec4, 16> palette;
+        for (size_t i = 0; i < 16; ++i) palette[i] = glm::vec4(interpolate(v0, v1, weights4[i]));
+        result.error = 0.f;
+        for (size_t i = 0; i < 16; ++i) result.error += select_index(pixels[i], palette.data(), 16, mask, result.indices[i]);
+        return result;
+    }
+
+    float position(const encoded_block& block, const size_t pixel) const { return weights4[block.indices[pixel]] / 64.f; }
+};
+
+void encode_bc6h(const block_pixels& pixels, const compression_quality quality, std::byte* block)
+{
+    block_pixels values;
+    for (size_t i = 0; i < 16; ++i)
+        values[i] = glm::vec4(bc6h_value(pixels[i].r), bc6h_value(pixels[i].g), bc6h_value(pixels[i].b), 0.f);
+
+    const bc6h_codec codec;
+    encoded_block    result = encode_endpoints(codec, values, fit_endpoints(values.data(), 16, codec.mask, quality), quality);
+    flip_anchor(result, 15);
+
+    bit_writer writer(block);
+    writer.write(0b00011, 5);
+    for (int c = 0; c < 3; ++c) writer.write(result.e0[c], 10);
+    for (int c = 0; c < 3; ++c) writer.write(result.e1[c], 10);
+    for (size_t i = 0; i < 16; ++i) writer.write(result.indices[i], i == 0 ? 3 : 4);
+}
+
+bool decode_bc6h(const std::byte* block, block_pixels& pixels)
+{
+    bit_reader reader(block);
+    if (reader.read(5) != 0b00011) return false;
+
+    glm::ivec4 e0(0);
+    glm::ivec4 e1(0);
+    for (int c = 0; c < 3; ++c) e0[c] = reader.read(10);
+    for (int c = 0; c < 3; ++c) e1[c] = reader.read(10);
+    e0 = bc6h_unquantize(e0);
+    e1 = bc6h_unquantize(e1);
+
+    const std::array<int, 16> indices = read_indices(reader, 4);
+    for (size_t i = 0; i < 16; ++i) {
+        const glm::ivec4 value = interpolate(e0, e1, weights4[indices[i]]);
+        for (int c = 0; c < 3; ++c) pixels[i][c] = glm::unpackHalf1x16(uint16_t((value[c] * 31) >> 6));
+        pixels[i].a = 1.f;
+    }
+    return true;
+}
+}    // namespace
+
+void encode_block(const format fmt, const block_pixels& pixels, const compression_quality quality, std::byte* block)
+{
+    std::fill_n(block, format_element_size(fmt), std::byte(0));
+    if (fmt == bc6hf) {
+        encode_bc6h(pixels, quality, block);
+        return;
+    }
+
+    block_pixels clamped;
+    for (size_t i = 0; i < 16; ++i) clamped[i] = glm::clamp(pixels[i], 0.f, 1.f);
+    switch (fmt)
+    {
+    case bc1unorm: encode_bc1(clamped, quality, false, block); break;
+    case bc3unorm:
+        encode_bc4(clamped, 3, quality, block);
+        encode_bc1(clamped, quality, true, block + 8);
+        break;
+    case bc4unorm: encode_bc4(clamped, 0, quality, block); break;
+    case bc5unorm:
+        encode_bc4(clamped, 0, quality, block);
+        encode_bc4(clamped, 1, quality, block + 8);
+        break;
+    case bc7unorm: encode_bc7(clamped, quality, block); break;
+    default: break;
+    }
+}
+
+bool decode_block(const format fmt, const std::byte* block, block_pixels& pixels)
+{
+    pixels.fill(glm::vec4(0, 0, 0, 1));
+    switch (fmt)
+    {
+    case bc1unorm: decode_bc1(block, false, pixels); return true;
+    case bc3unorm:
+        decode_bc1(block + 8, true, pixels);
+        decode_bc4(block, 3, pixels);
+        return true;
+    case bc4unorm: decode_bc4(block, 0, pixels); return true;
+    case bc5unorm:
+        decode_bc4(block, 0, pixels);
+        decode_bc4(block + 8, 1, pixels);
+        return true;
+    case bc6hf: return decode_bc6h(block, pixels);
+    case bc7unorm: return decode_bc7(block, pixels);
+    default: return false;
+    }
+}
+}    // namespace detail
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,17 @@
+#pragma once
+#include "compressed_image.hpp"
+#include <array>
+
+namespace gfx {
+inline namespace v1 {
+namespace detail {
+// The pixels of a 4x4 block, row by row.
+using block_pixels = std::array<glm::vec4, 16>;
+
+// Encodes a block into format_element_size(fmt) bytes. Values are clamped to the range of the format.
+void encode_block(format fmt, const block_pixels& pixels, compression_quality quality, std::byte* block);
+// Decodes a block, or returns false if it uses a BC6H or BC7 mode which is not supported.
+bool decode_block(format fmt, const std::byte* block, block_pixels& pixels);
+}    // namespace detail
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,123 @@
+#include "compressed_image.hpp"
+#include "block_compression.hpp"
+
+namespace gfx {
+inline namespace v1 {
+namespace {
+format decompressed_format(const format fmt)
+{
+    switch (fmt)
+    {
+    case bc4unorm: return r8unorm;
+    case bc5unorm: return rg8unorm;
+    case bc6hf: return rgb16f;
+    default: return rgba8unorm;
+    }
+}
+}    // namespace
+
+compressed_image::compressed_image(const format fmt, const extent& size)
+      : _format(fmt)
+      , _extent(size)
+      , _blocks((size.width + 3) / 4, (size.height + 3) / 4, size.depth)
+      , _storage(format_element_size(fmt) * _blocks.count())
+{
+    if (!is_block_compressed(fmt)) throw std::invalid_argument("Compressed images need a block-compressed format.");
+}
+
+compressed_image::compressed_image(const host_image& image, const format fmt, const compression_quality quality)
+      : compressed_image(fmt, image.extents())
+{
+    if (!has_value_type<glm::vec4>(image.pixel_format()))
+        throw std::invalid_argument("Only images of normalized and floating-point formats can be compressed.");
+
+    const size_t  block_size = format_element_size(fmt);
+    const int64_t block_rows = int64_t(_blocks.height) * _blocks.depth;
+#pragma omp parallel
+    {
+        std::vector<glm::vec4> rows(4 * size_t(_extent.width));
+        detail::block_pixels   pixels;
+#pragma omp for schedule(static)
+        for (int64_t r = 0; r < block_rows; ++r) {
+            const auto by = uint32_t(r % _blocks.height);
+            const auto z  = uint32_t(r / _blocks.height);
+            for (uint32_t y = 0; y < 4; ++y)
+                image.load_row({0, std::min(4 * by + y, _extent.height - 1), z}, _extent.width, &rows[y * _extent.width]);
+
+            for (uint32_t bx = 0; bx < _blocks.width; ++bx) {
+                for (uint32_t i = 0; i < 16; ++i) pixels[i] = rows[(i / 4) * _extent.width + std::min(4 * bx + i % 4, _extent.width - 1)];
+                detail::encode_block(fmt, pixels, quality, _storage.data() + block_size * (size_t(r) * _blocks.width + bx));
+            }
+        }
+    }
+}
+
+compressed_image::compressed_image(const compressed_image& o) : compressed_image(o.pixel_format(), o.extents())
+{
+    memcpy(storage().data(), o.storage().data(), o.storage().size());
+}
+
+compressed_image& compressed_image::operator=(const compressed_image& o)
+{
+    _format = o._format;
+    _extent = o._extent;
+    _blocks = o._blocks;
+    _storage.resize(o.storage().size());
+    memcpy(storage().data(), o.storage().data(), o.storage().size());
+    return *this;
+}
+
+host_image compressed_image::decompressed() const
+{
+    host_image    result(decompressed_format(_format), _extent);
+    const size_t  block_size  = format_element_size(_format);
+    const int64_t block_rows  = int64_t(_blocks.height) * _blocks.depth;
+    const size_t  row_size    = 4 * size_t(_blocks.width);
+    bool          unsupported = false;
+#pragma omp parallel
+    {
+        std::vector<glm::vec4> rows(4 * row_size);
+        detail::block_pixels   pixels;
+#pragma omp for schedule(static) reduction(|| : unsupported)
+        for (int64_t r = 0; r < block_rows; ++r) {
+            const auto by = uint32_t(r % _blocks.height);
+            const auto z  = uint32_t(r / _blocks.height);
+            for (uint32_t bx = 0; bx < _blocks.width; ++bx) {
+                if (!detail::decode_block(_format, _storage.data() + block_size * (size_t(r) * _blocks.width + bx), pixels))
+                    unsupported = true;
+                for (uint32_t i = 0; i < 16; ++i) rows[(i / 4) * row_size + 4 * bx + i % 4] = pixels[i];
+            }
+            for (uint32_t y = 0; y < 4 && 4 * by + y < _extent.height; ++y)
+                result.store_row({0, 4 * by + y, z}, _extent.width, &rows[y * row_size]);
+        }
+    }
+    if (unsupported) throw std::invalid_argument("The image contains BC6H or BC7 blocks of modes which cannot be decoded.");
+    return result;
+}
+
+host_buffer<std::byte>& compressed_image::storage() noexcept
+{
+    return _storage;
+}
+
+const host_buffer<std::byte>& compressed_image::storage() const noexcept
+{
+    return _storage;
+}
+
+const extent& compressed_image::extents() const noexcept
+{
+    return _extent;
+}
+
+const extent& compressed_image::blocks() const noexcept
+{
+    return _blocks;
+}
+
+format compressed_image::pixel_format() const noexcept
+{
+    return _format;
+}
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,46 @@
+#pragma once
+#include "host_image.hpp"
+
+namespace gfx {
+inline namespace v1 {
+enum class compression_quality
+{
+    fast,      // Endpoints on the bounding box diagonal.
+    normal,    // Endpoints on the principal axis, refined once by least squares.
+    high       // Several refinements and additional BC4 and BC7 modes.
+};
+
+// An image of a block-compressed format, stored as 4x4 blocks row by row and slice by slice. Images are encoded
+// from host images in parallel, and can be decoded again to verify them on the CPU.
+class compressed_image
+{
+public:
+    // Fills the image with blocks of zeros.
+    compressed_image(format fmt, const extent& size);
+    // Encodes an image of a normalized or floating-point format. BC6H keeps positive half float values, all other
+    // formats clamp to [0, 1]. Blocks at the border repeat the last row and column of the image.
+    compressed_image(const host_image& image, format fmt, compression_quality quality = compression_quality::normal);
+
+    compressed_image(const compressed_image& o);
+    compressed_image& operator       =(const compressed_image& o);
+    compressed_image(compressed_image&& o) = default;
+    compressed_image& operator=(compressed_image&& o) = default;
+
+    // Decodes all blocks into an image of rgba8unorm, or r8unorm, rg8unorm and rgb16f for BC4, BC5 and BC6H.
+    host_image decompressed() const;
+
+    host_buffer<std::byte>&       storage() noexcept;
+    const host_buffer<std::byte>& storage() const noexcept;
+
+    const extent& extents() const noexcept;
+    const extent& blocks() const noexcept;
+    format        pixel_format() const noexcept;
+
+private:
+    format                 _format;
+    extent                 _extent;
+    extent                 _blocks;
+    host_buffer<std::byte> _storage;
+};
+}    // namespace v1
+}    // namespace gfx
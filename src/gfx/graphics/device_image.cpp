@@ -19,12 +19,27 @@ std::unique_ptr<detail::device_image_implementation> detail::device_image_implem
 }
 void device_image::img_reference::operator<<(const host_image& image) const
 {
-    _img._implementation->fill_from(image, _level, _layer);
+    if (image.layout() != image_layout::linear)
+        _img._implementation->fill_from(image.with_layout(image_layout::linear), _level, _layer);
+    else
+        _img._implementation->fill_from(image, _level, _layer);
 }
 void device_image::img_reference::operator>>(const host_image& image) const
 {
+    if (image.layout() != image_layout::linear)
+        throw std::invalid_argument("Device images can only be downloaded into linear host images.");
     _img._implementation->fill_to(image, _level, _layer);
 }
+void device_image::img_reference::operator<<(const host_image_pyramid& pyramid) const
+{
+    _img._implementation->fill_from(pyramid, _layer);
+}
+void device_image::img_reference::operator<<(const compressed_image& image) const
+{
+    if (image.pixel_format() != _img.pixel_format())
+        throw std::invalid_argument("Compressed images can only be uploaded into device images of the same format.");
+    _img._implementation->fill_from(image, _level, _layer);
+}
 
 void device_image::generate_mipmaps()
 {
@@ -72,6 +87,19 @@ device_image::device_image(const host_image& image, uint32_t levels)
     generate_mipmaps();
 }
 
+device_image::device_image(const host_image_pyramid& pyramid)
+      : device_image(pyramid.extents().depth > 1 ? img_type::image3d : img_type::image2d, pyramid.pixel_format(), pyramid.extents(),
+                     pyramid.levels())
+{
+    layer(0) << pyramid;
+}
+
+device_image::device_image(const compressed_image& image)
+      : device_image(image.extents().depth > 1 ? img_type::image3d : img_type::image2d, image.pixel_format(), image.extents(), 1u)
+{
+    level(0) << image;
+}
+
 device_image::img_reference device_image::operator[](uint32_t layer)
 {
     return img_reference(0, layer, *this);
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "compressed_image.hpp"
 #include "host_image.hpp"
+#include "host_image_pyramid.hpp"
 #include "implementation.hpp"
 #include <gfx/api.hpp>
 #include "sampler.hpp"
@@ -19,6 +21,8 @@ public:
     virtual ~device_image_implementation() = default;
     virtual void     initialize(uint32_t layer_dimensions, format format, const extent& size, uint32_t levels, sample_count samples) = 0;
     virtual void     fill_from(const host_image& image, uint32_t level, uint32_t layer)                                              = 0;
+    virtual void     fill_from(const host_image_pyramid& pyramid, uint32_t layer)                                                    = 0;
+    virtual void     fill_from(const compressed_image& image, uint32_t level, uint32_t layer)                                        = 0;
     virtual void     fill_to(const host_image& image, uint32_t level, uint32_t layer)                                                = 0;
     virtual std::any api_handle()                                                                                                    = 0;
     virtual void     generate_mipmaps()                                                                                              = 0;
@@ -47,6 +51,10 @@ public:
 
         void operator<<(const host_image& image) const;
         void operator>>(const host_image& image) const;
+        // Uploads all levels of the pyramid into the layer in a single transfer.
+        void operator<<(const host_image_pyramid& pyramid) const;
+        // Uploads the blocks as they are, the device image needs the same format.
+        void operator<<(const compressed_image& image) const;
 
 		image_view view(imgv_type type);
 
@@ -61,6 +69,11 @@ public:
     device_image(img_type type, format format, const extent& size, uint32_t levels);
     device_image(img_type type, format format, const extent& size, sample_count samples);
     device_image(const host_image& image, uint32_t levels = max_levels);
+    // Creates a 3D image if the pyramid has a depth, a 2D image otherwise, with the levels of the pyramid.
+    explicit device_image(const host_image_pyramid& pyramid);
+    // Creates a 3D image if the compressed image has a depth, a 2D image otherwise. It has a single level, compressed
+    // mipmaps cannot be generated on the device.
+    explicit device_image(const compressed_image& image);
 
 	device_image(device_image&&) = default;
 	device_image& operator=(device_image&&) = default;
@@ -0,0 +1,235 @@
+#include "features.hpp"
+#include "image_resampling.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace gfx {
+inline namespace v1 {
+namespace {
+// Pixels per side of the tiles which are processed by one task. The buffers of a tile with its borders stay in the L2
+// cache for the usual window and suppression radii.
+constexpr uint32_t tile_size = 64;
+
+// Buffers of one thread, which are reused for all of its tiles. The structure tensor is kept in three planes, so that
+// the loops over a row run over consecutive floats and vectorize.
+struct tile_buffers
+{
+    std::vector<glm::vec4>            pixels;
+    std::vector<float>                luminance;
+    std::vector<float>                smoothed;       // One row of luminance smoothed along y, for the Sobel operator.
+    std::vector<float>                difference;     // One row of luminance differences along y.
+    std::array<std::vector<float>, 3> tensor;        // xx, xy and yy
+    std::array<std::vector<float>, 3> horizontal;    // The tensor after the horizontal pass of the Gaussian.
+    std::array<std::vector<float>, 3> window;        // One row of the tensor after both passes.
+    std::vector<float>                response;
+};
+
+class tile_detector
+{
+public:
+    tile_detector(const detail::row_loader& loader, const feature_options& options)
+          : _loader(loader)
+          , _options(options)
+          , _size(loader.extents())
+          , _margin(options.window_radius + options.suppression_radius)
+          , _weights(2 * options.window_radius + 1)
+    {
+        const float r = float(options.window_radius);
+        for (size_t i = 0; i < _weights.size(); ++i) _weights[i] = std::exp(-(float(i) - r) * (float(i) - r) / (2 * options.sigma * options.sigma));
+        const float sum = std::accumulate(_weights.begin(), _weights.end(), 0.f);
+        for (float& w : _weights) w /= sum;
+    }
+
+    // Appends the features of the tile from origin to origin + tile_size.
+    void detect(const glm::uvec2& origin, tile_buffers& b, std::vector<feature>& features) const
+    {
+        const uint32_t width    = std::min(tile_size, _size.width - origin.x);
+        const uint32_t height   = std::min(tile_size, _size.height - origin.y);
+        const uint32_t s        = _options.suppression_radius;
+        const uint32_t g        = _options.window_radius;
+        const uint32_t tensor_w = width + 2 * _margin;
+        const uint32_t tensor_h = height + 2 * _margin;
+        const uint32_t out_w    = width + 2 * s;
+        const uint32_t out_h    = height + 2 * s;
+
+        load_luminance(glm::ivec2(origin) - int(_margin) - 1, tensor_w + 2, tensor_h + 2, b);
+
+        // The Sobel operator is applied separably. Shifted reads go through shifted pointers instead of x + k, which
+        // could wrap around and keeps the loops from vectorizing.
+        for (auto& plane : b.tensor) plane.resize(size_t(tensor_w) * tensor_h);
+        b.smoothed.resize(tensor_w + 2);
+        b.difference.resize(tensor_w + 2);
+        for (uint32_t y = 0; y < tensor_h; ++y) {
+            const float* above      = &b.luminance[size_t(y) * (tensor_w + 2)];
+            const float* row        = above + tensor_w + 2;
+            const float* below      = row + tensor_w + 2;
+            float*       smoothed   = b.smoothed.data();
+            float*       difference = b.difference.data();
+            for (uint32_t x = 0; x < tensor_w + 2; ++x) {
+                smoothed[x]   = above[x] + 2 * row[x] + below[x];
+                difference[x] = below[x] - above[x];
+            }
+
+            const float* right = smoothed + 2;
+            const float* next  = difference + 1;
+            const float* last  = difference + 2;
+            float*       xx    = &b.tensor[0][size_t(y) * tensor_w];
+            float*       xy    = &b.tensor[1][size_t(y) * tensor_w];
+            float*       yy    = &b.tensor[2][size_t(y) * tensor_w];
+            for (uint32_t x = 0; x < tensor_w; ++x) {
+                const float dx = right[x] - smoothed[x];
+                const float dy = difference[x] + 2 * next[x] + last[x];
+                xx[x]          = dx * dx;
+                xy[x]          = dx * dy;
+                yy[x]          = dy * dy;
+            }
+        }
+
+        for (int c = 0; c < 3; ++c) {
+            b.horizontal[c].assign(size_t(out_w) * tensor_h, 0.f);
+            for (uint32_t y = 0; y < tensor_h; ++y) {
+                const float* in  = &b.tensor[c][size_t(y) * tensor_w];
+                float*       out = &b.horizontal[c][size_t(y) * out_w];
+                for (uint32_t k = 0; k <= 2 * g; ++k) {
+                    const float  w       = _weights[k];
+                    const float* shifted = in + k;
+                    for (uint32_t x = 0; x < out_w; ++x) out[x] += w * shifted[x];
+                }
+            }
+        }
+
+        b.response.resize(size_t(out_w) * out_h);
+        for (uint32_t y = 0; y < out_h; ++y) {
+            for (int c = 0; c < 3; ++c) {
+                b.window[c].assign(out_w, 0.f);
+                float* out = b.window[c].data();
+                for (uint32_t k = 0; k <= 2 * g; ++k) {
+                    const float  w  = _weights[k];
+                    const float* in = &b.horizontal[c][size_t(y + k) * out_w];
+                    for (uint32_t x = 0; x < out_w; ++x) out[x] += w * in[x];
+                }
+            }
+            respond(b.window, out_w, &b.response[size_t(y) * out_w]);
+        }
+
+        suppress(origin, width, height, out_w, b.response, features);
+    }
+
+private:
+    // Loads the luminance of count_x * count_y pixels from start, clamping the coordinates to the image.
+    void load_luminance(const glm::ivec2& start, const uint32_t count_x, const uint32_t count_y, tile_buffers& b) const
+    {
+        const int first = std::max(start.x, 0);
+        const int last  = std::min(start.x + int(count_x), int(_size.width));
+        b.pixels.resize(size_t(last - first));
+        b.luminance.resize(size_t(count_x) * count_y);
+        for (uint32_t y = 0; y < count_y; ++y) {
+            const int row = std::clamp(start.y + int(y), 0, int(_size.height) - 1);
+            _loader.load(row, uint32_t(first), uint32_t(last - first), b.pixels.data());
+            float* luminance = &b.luminance[size_t(y) * count_x];
+            for (uint32_t x = 0; x < count_x; ++x) {
+                const glm::vec4& p = b.pixels[size_t(std::clamp(start.x + int(x), first, last - 1) - first)];
+                luminance[x]       = 0.2126f * p.r + 0.7152f * p.g + 0.0722f * p.b;
+            }
+        }
+    }
+
+    void respond(const std::array<std::vector<float>, 3>& tensor, const uint32_t count, float* response) const
+    {
+        const float* xx = tensor[0].data();
+        const float* xy = tensor[1].data();
+        const float* yy = tensor[2].data();
+        if (_options.response == corner_response::harris) {
+            const float k = _options.harris_k;
+            for (uint32_t x = 0; x < count; ++x) response[x] = xx[x] * yy[x] - xy[x] * xy[x] - k * (xx[x] + yy[x]) * (xx[x] + yy[x]);
+        } else {
+            for (uint32_t x = 0; x < count; ++x) {
+                const float d = xx[x] - yy[x];
+                response[x]   = 0.5f * (xx[x] + yy[x] - std::sqrt(d * d + 4 * xy[x] * xy[x]));
+            }
+        }
+    }
+
+    // Keeps the pixels of the tile whose responses exceed the threshold and their neighbors within the image. Of equal
+    // neighbors, the first one in row order is kept.
+    void suppress(const glm::uvec2& origin, const uint32_t width, const uint32_t height, const uint32_t stride,
+                  const std::vector<float>& response, std::vector<feature>& features) const
+    {
+        const int s = int(_options.suppression_radius);
+        for (uint32_t y = 0; y < height; ++y) {
+            const int min_y = -std::min(s, int(origin.y + y));
+            const int max_y = std::min(s, int(_size.height - 1 - origin.y - y));
+            for (uint32_t x = 0; x < width; ++x) {
+                const float* center = &response[size_t(y + s) * stride + x + s];
+                if (!(*center > _options.threshold)) continue;
+
+                const int min_x   = -std::min(s, int(origin.x + x));
+                const int max_x   = std::min(s, int(_size.width - 1 - origin.x - x));
+                bool      maximum = true;
+                for (int dy = min_y; dy <= max_y && maximum; ++dy)
+                    for (int dx = min_x; dx <= max_x && maximum; ++dx) {
+                        const float other = center[dy * int(stride) + dx];
+                        maximum           = other < *center || (other == *center && (dy > 0 || (dy == 0 && dx >= 0)));
+                    }
+                if (maximum) features.push_back({origin + glm::uvec2(x, y), *center});
+            }
+        }
+    }
+
+    const detail::row_loader& _loader;
+    const feature_options&    _options;
+    extent                    _size;
+    uint32_t                  _margin;
+    std::vector<float>        _weights;
+};
+
+template<typename Image>
+std::vector<feature> detect(const Image& image, const feature_options& options)
+{
+    if (!has_value_type<glm::vec4>(image.pixel_format()))
+        throw std::invalid_argument("Features are only detected in images of normalized and floating-point formats.");
+    if (!(options.sigma > 0.f)) throw std::invalid_argument("The Gaussian window of the structure tensor needs a positive sigma.");
+
+    const detail::row_loader loader(image, color_space::linear);
+    const tile_detector      detector(loader, options);
+    const extent&            size    = image.extents();
+    const int64_t            tiles_x = (int64_t(size.width) + tile_size - 1) / tile_size;
+    const int64_t            tiles   = tiles_x * ((int64_t(size.height) + tile_size - 1) / tile_size);
+
+    std::vector<feature> features;
+#pragma omp parallel
+    {
+        tile_buffers         buffers;
+        std::vector<feature> local;
+#pragma omp for schedule(static)
+        for (int64_t t = 0; t < tiles; ++t) detector.detect(glm::uvec2(t % tiles_x, t / tiles_x) * tile_size, buffers, local);
+#pragma omp critical
+        features.insert(features.end(), local.begin(), local.end());
+    }
+
+    // Positions break ties, so the result does not depend on the order in which the threads finished.
+    const auto stronger = [](const feature& a, const feature& b) {
+        if (a.response != b.response) return a.response > b.response;
+        return a.position.y != b.position.y ? a.position.y < b.position.y : a.position.x < b.position.x;
+    };
+    if (options.max_features != 0 && features.size() > options.max_features) {
+        std::nth_element(features.begin(), features.begin() + options.max_features, features.end(), stronger);
+        features.resize(options.max_features);
+    }
+    std::sort(features.begin(), features.end(), stronger);
+    return features;
+}
+}    // namespace
+
+std::vector<feature> detect_features(const host_image& image, const feature_options& options)
+{
+    return detect(image, options);
+}
+
+std::vector<feature> detect_features(const host_image_view& image, const feature_options& options)
+{
+    return detect(image, options);
+}
+}    // namespace v1
+}    // namespace gfx
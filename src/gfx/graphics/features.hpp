@@ -0,0 +1,40 @@
+#pragma once
+#include "host_image.hpp"
+
+namespace gfx {
+inline namespace v1 {
+enum class corner_response
+{
+    harris,        // det(M) - k * trace(M)^2 of the structure tensor M.
+    shi_tomasi     // The smaller eigenvalue of the structure tensor.
+};
+
+struct feature_options
+{
+    corner_response response = corner_response::harris;
+    float           harris_k = 0.05f;
+    // The structure tensor is weighted by a Gaussian with sigma, cut off window_radius pixels from its center.
+    float           sigma         = 1.f;
+    uint32_t        window_radius = 2;
+    // Features have a response above the threshold and above all other responses at most suppression_radius pixels
+    // away on each axis.
+    float           threshold          = 0.f;
+    uint32_t        suppression_radius = 2;
+    // Keeps only the features with the strongest responses, or all of them for zero.
+    size_t          max_features = 0;
+};
+
+struct feature
+{
+    glm::uvec2 position;
+    float      response;
+};
+
+// Detects corners in the Rec. 709 luminance of the first slice of an image, extended by repeating its border pixels.
+// Tiles of the image are processed in parallel, each running Sobel gradients, the structure tensor, the separable
+// Gaussian, the response and the non-maximum suppression on small buffers of its own, so no intermediate image of the
+// full size is allocated. The features are sorted by descending response.
+std::vector<feature> detect_features(const host_image& image, const feature_options& options = {});
+std::vector<feature> detect_features(const host_image_view& image, const feature_options& options = {});
+}    // namespace v1
+}    // namespace gfx
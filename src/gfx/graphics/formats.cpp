@@ -21,6 +21,7 @@ size_t format_element_size(format fmt)
     case r16i:
     case r16f:
     case r5g6b5unorm:
+    case rgb5a1unorm:
     case d16unorm: return 2;
     case rgb8unorm:
     case rgb8snorm:
@@ -38,7 +39,6 @@ size_t format_element_size(format fmt)
     case r32u:
     case r32i:
     case r32f:
-    case rgb5a1unorm:
     case rgb10a2snorm:
     case rgb10a2unorm:
     case r11g11b10f:
@@ -66,8 +66,31 @@ size_t format_element_size(format fmt)
     case rgba32u:
     case rgba32i:
     case rgba32f: return 16;
+    case bgr8unorm: return 3;
+    case bgra8unorm: return 4;
+    case bc1unorm:
+    case bc4unorm: return 8;
+    case bc3unorm:
+    case bc5unorm:
+    case bc6hf:
+    case bc7unorm: return 16;
+    default: break;
     }
     return 1;
 }
+
+bool is_block_compressed(format fmt)
+{
+    switch (fmt)
+    {
+    case bc1unorm:
+    case bc3unorm:
+    case bc4unorm:
+    case bc5unorm:
+    case bc6hf:
+    case bc7unorm: return true;
+    default: return false;
+    }
+}
 }    // namespace v1
 }    // namespace gfx
\ No newline at end of file
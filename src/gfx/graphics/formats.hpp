@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 namespace gfx {
 inline namespace v1 {
 enum format
@@ -82,9 +84,19 @@ enum format
 	bgr8unorm,
 	bgra8unorm,
 
+    // block-compressed formats, stored in 4x4 blocks by compressed_image
+    bc1unorm,    // RGB with one bit of alpha, 8 bytes per block
+    bc3unorm,    // RGBA, 16 bytes per block
+    bc4unorm,    // R, 8 bytes per block
+    bc5unorm,    // RG, 16 bytes per block
+    bc6hf,       // RGB of unsigned half floats, 16 bytes per block
+    bc7unorm,    // RGBA, 16 bytes per block
+
 	unspecified = ~0u,
 };
 
+// The size of a pixel, or of a whole block for block-compressed formats.
 size_t format_element_size(format fmt);
+bool   is_block_compressed(format fmt);
 }    // namespace v1
 }    // namespace gfx
\ No newline at end of file
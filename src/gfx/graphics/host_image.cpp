@@ -1,25 +1,61 @@
 #include "host_image.hpp"
+#include "image_resampling.hpp"
+#include "pixel_conversion.hpp"
 
 namespace gfx {
 inline namespace v1 {
-host_image::host_image(const format fmt, const extent& size)
+namespace {
+glm::uvec3 tile_shift(const image_layout layout, const extent& size)
+{
+    if (layout == image_layout::linear) return glm::uvec3(0);
+    return size.depth > 1 ? glm::uvec3(2) : glm::uvec3(3, 3, 0);
+}
+
+extent tile_count(const extent& size, const glm::uvec3& shift)
+{
+    const glm::uvec3 count = (size.vec + (glm::uvec3(1) << shift) - 1u) >> shift;
+    return {count.x, count.y, count.z};
+}
+
+// Normalized and floating-point images are converted from a view of the file in one pass, integer images take the
+// values of the file as they are.
+host_image load_image(const format fmt, const image_file& file)
+{
+    if (has_value_type<glm::vec4>(fmt)) return host_image_view(file).converted(fmt);
+    host_image image(fmt, extent{file.width, file.height});
+    image.update(file);
+    return image;
+}
+
+host_image load_image(const format fmt, const std::filesystem::path& file)
+{
+    const image_file::decoded decoded = image_file::decode(file, bits::b32, image_file::info(file).channels);
+    if (has_value_type<glm::vec4>(fmt)) return host_image_view(decoded).converted(fmt);
+    host_image image(fmt, extent{decoded.width, decoded.height});
+    image.update(data_format(decoded.channels), static_cast<const float*>(decoded.pixels.get()));
+    return image;
+}
+}    // namespace
+
+host_image::host_image(const format fmt, const extent& size, const image_layout layout)
       : _format(fmt)
       , _extent(size)
+      , _layout(layout)
+      , _tile_shift(tile_shift(layout, size))
+      , _tiles(tile_count(size, _tile_shift))
       , _storage_element_size(format_element_size(fmt))
-      , _storage(_storage_element_size * _extent.count())
-      , _write_unorm(get_write_unorm_fun())
-{}
-
-host_image::host_image(const format format, const image_file& file) : host_image(format, extent{file.width, file.height})
+      , _storage(_storage_element_size * (_tiles.count() << (_tile_shift.x + _tile_shift.y + _tile_shift.z)))
 {
-    update(file);
+    if (is_block_compressed(fmt)) throw std::invalid_argument("Block-compressed formats are stored in compressed images.");
 }
 
-host_image::host_image(const format fmt, const std::filesystem::path& file)
-      : host_image(fmt, image_file(file, bits::b32, image_file::info(file).channels))
-{}
+host_image::host_image(const format format, const image_file& file) : host_image(load_image(format, file)) {}
+
+host_image::host_image(const format fmt, const std::filesystem::path& file) : host_image(load_image(fmt, file)) {}
+
+host_image::host_image(const host_image_view& view) : host_image(view.converted(view.pixel_format())) {}
 
-host_image::host_image(const host_image& o) : host_image(o.pixel_format(), o.extents())
+host_image::host_image(const host_image& o) : host_image(o.pixel_format(), o.extents(), o.layout())
 {
     memcpy(storage().data(), o.storage().data(), o.storage().size());
 }
@@ -28,43 +64,89 @@ host_image& host_image::operator=(const host_image& o)
 {
     _format               = o._format;
     _extent               = o._extent;
+    _layout               = o._layout;
+    _tile_shift           = o._tile_shift;
+    _tiles                = o._tiles;
     _storage_element_size = format_element_size(_format);
-    _storage.resize(_storage_element_size * _extent.count());
-    _write_unorm = get_write_unorm_fun();
+    _storage.resize(o.storage().size());
     memcpy(storage().data(), o.storage().data(), o.storage().size());
     return *this;
 }
 
+host_image_view host_image::view() const
+{
+    return host_image_view(*this);
+}
+
+host_image_view host_image::view(const glm::uvec3& offset, const extent& size) const
+{
+    return view().subview(offset, size);
+}
+
+// Linear images are converted through their view. Tiled images are converted tile by tile if there is a conversion
+// kernel, and through a linear copy otherwise.
 host_image host_image::converted(const format fmt) const
 {
-    host_image n(fmt, _extent);
+    if (_layout == image_layout::linear) return view().converted(fmt);
+    if (fmt == _format) return *this;
+
+    const auto fast_convert = find_pixel_conversion(_format, fmt);
+    if (!fast_convert) return with_layout(image_layout::linear).view().converted(fmt).with_layout(_layout);
+
+    host_image    n(fmt, _extent, _layout);
+    const size_t  tile_size = size_t(1) << (_tile_shift.x + _tile_shift.y + _tile_shift.z);
+    const int64_t tiles     = int64_t(_storage.size() / _storage_element_size / tile_size);
 #pragma omp parallel for schedule(static)
-    for (int64_t p = 0; p < static_cast<int64_t>(_extent.count()); ++p) {
-        const int64_t z = p / (_extent.width * _extent.height);
-        const int64_t t = p % (_extent.width * _extent.height);
-        const int64_t x = t % _extent.width;
-        const int64_t y = t / _extent.width;
-        n.store({x, y, z}, load({x, y, z}));
+    for (int64_t t = 0; t < tiles; ++t) {
+        const size_t offset = size_t(t) * tile_size;
+        fast_convert(_storage.data() + offset * _storage_element_size, n._storage.data() + offset * n._storage_element_size, tile_size);
     }
     return n;
 }
 
+host_image host_image::with_layout(const image_layout layout) const
+{
+    host_image n(_format, _extent, layout);
+    if (layout == _layout) {
+        memcpy(n.storage().data(), storage().data(), storage().size());
+        return n;
+    }
+
+    // Pixels are copied as bytes, so this works for all formats.
+    const int64_t rows = int64_t(_extent.height) * _extent.depth;
+#pragma omp parallel for schedule(static)
+    for (int64_t r = 0; r < rows; ++r) {
+        const glm::uvec3 start(0, uint32_t(r % _extent.height), uint32_t(r / _extent.height));
+        for_each_run(start, _extent.width, [&](const size_t index, const uint32_t offset, const uint32_t length) {
+            const glm::uvec3 run_start(offset, start.y, start.z);
+            n.for_each_run(run_start, length, [&](const size_t n_index, const uint32_t n_offset, const uint32_t n_length) {
+                memcpy(n._storage.data() + _storage_element_size * n_index, _storage.data() + _storage_element_size * (index + n_offset),
+                       _storage_element_size * n_length);
+            });
+        });
+    }
+    return n;
+}
+
+host_image host_image::resized(const extent& size, const resample_filter filter, const color_space space) const
+{
+    if (size == _extent && has_value_type<glm::vec4>(_format)) return *this;
+    return detail::resized_image(*this, size, filter, space, _layout);
+}
+
 void host_image::flip_vertically()
 {
-    const auto fmt_size = _storage_element_size;
-    for (int d = 0; d < static_cast<int>(_extent.depth); ++d) {
-        for (int x = 0; x < static_cast<int>(_extent.width); ++x) {
-            for (int hy = 0; hy < static_cast<int>(_extent.height / 2); ++hy) {
-                const int     other   = _extent.height - 1 - hy;
-                const int64_t offset1 = fmt_size * _extent.linear({x, hy, d});
-                const int64_t offset2 = fmt_size * _extent.linear({x, other, d});
-
-                std::byte buf[32]{};
-                memcpy(buf, _storage.data() + offset1, fmt_size);
-                memcpy(_storage.data() + offset1, _storage.data() + offset2, fmt_size);
-                memcpy(_storage.data() + offset2, buf, fmt_size);
-            }
-        }
+    const int64_t half = _extent.height / 2;
+#pragma omp parallel for schedule(static)
+    for (int64_t r = 0; r < half * static_cast<int64_t>(_extent.depth); ++r) {
+        const auto y = static_cast<uint32_t>(r % half);
+        const auto z = static_cast<uint32_t>(r / half);
+        // Tiles have the same width in every row, so the runs of both rows cover the same columns.
+        for_each_run({0, y, z}, _extent.width, [&](const size_t index, const uint32_t offset, const uint32_t length) {
+            std::byte* upper = _storage.data() + _storage_element_size * index;
+            std::byte* lower = _storage.data() + _storage_element_size * pixel_index({offset, _extent.height - 1 - y, z});
+            std::swap_ranges(upper, upper + _storage_element_size * length, lower);
+        });
     }
 }
 
@@ -93,12 +175,23 @@ format host_image::pixel_format() const noexcept
     return _format;
 }
 
+image_layout host_image::layout() const noexcept
+{
+    return _layout;
+}
+
 glm::vec4 host_image::load_bilinear(const glm::vec3& pixel) const
 {
     const auto       frac = fract(pixel);
     const glm::ivec3 p00  = _extent.clamp(floor(pixel));
     const glm::ivec3 p11  = _extent.clamp(ceil(pixel));
 
+    if (_extent.depth == 1) {
+        const auto m0y = mix(load({p00.x, p00.y, 0}), load({p00.x, p11.y, 0}), frac.y);
+        const auto m1y = mix(load({p11.x, p00.y, 0}), load({p11.x, p11.y, 0}), frac.y);
+        return mix(m0y, m1y, frac.x);
+    }
+
     const auto c000 = load(p00);
     const auto c001 = load({p00.x, p00.y, p11.z});
     const auto c010 = load({p00.x, p11.y, p00.z});
@@ -119,235 +212,89 @@ glm::vec4 host_image::load_bilinear(const glm::vec3& pixel) const
     return mix(m0yz, m1yz, frac.x);
 }
 
-glm::vec4 host_image::load(glm::uvec3 pixel) const
+template<typename T>
+void host_image::load_row(const glm::uvec3& start, const uint32_t count, T* values) const
 {
-	pixel = _extent.clamp(pixel);
-    const size_t index = (_extent.width * _extent.height * pixel.z + _extent.width * pixel.y + pixel.x) * _storage_element_size;
-
-    switch (_format)
-    {
-    case r8unorm: return glm::vec4(*reinterpret_cast<const uint8_t*>(&_storage[index]), 0, 0, 255) / 255.f;
-    case r8snorm: return glm::vec4(*reinterpret_cast<const int8_t*>(&_storage[index]), 0, 0, 255) / 255.f;
-    case rg8unorm: return glm::vec4(*reinterpret_cast<const glm::u8vec2*>(&_storage[index]), 0, 255) / 255.f;
-    case rg8snorm: return glm::vec4(*reinterpret_cast<const glm::i8vec2*>(&_storage[index]), 0, 255) / 255.f;
-    case rgb8unorm: return glm::vec4(*reinterpret_cast<const glm::u8vec3*>(&_storage[index]), 255) / 255.f;
-    case rgb8snorm: return glm::vec4(*reinterpret_cast<const glm::i8vec3*>(&_storage[index]), 255) / 255.f;
-    case rgba8unorm: return glm::vec4(*reinterpret_cast<const glm::u8vec4*>(&_storage[index])) / 255.f;
-    case rgba8snorm: return glm::vec4(*reinterpret_cast<const glm::i8vec4*>(&_storage[index])) / 255.f;
-	case bgra8unorm: return [&]() {
-		glm::vec4 rgba = glm::vec4(*reinterpret_cast<const glm::i8vec4*>(&_storage[index])) / 255.f;
-		return glm::vec4(rgba.b, rgba.g, rgba.r, rgba.a);
-	}();
-	case bgr8unorm: return [&]() {
-		glm::vec4 rgba = glm::vec4(*reinterpret_cast<const glm::i8vec3*>(&_storage[index]), 255.f) / 255.f;
-		return glm::vec4(rgba.b, rgba.g, rgba.r, rgba.a);
-	}();
-    case r16unorm:
-        return glm::vec4(*reinterpret_cast<const uint16_t*>(&_storage[index]), 0, 0, std::numeric_limits<uint16_t>::max())
-               / float(std::numeric_limits<uint16_t>::max());
-    case r16snorm:
-        return glm::vec4(*reinterpret_cast<const int16_t*>(&_storage[index]), 0, 0, std::numeric_limits<uint16_t>::max())
-               / float(std::numeric_limits<uint16_t>::max());
-    case rg16unorm:
-        return glm::vec4(*reinterpret_cast<const glm::u16vec2*>(&_storage[index]), 0, std::numeric_limits<uint16_t>::max())
-               / float(std::numeric_limits<uint16_t>::max());
-    case rg16snorm:
-        return glm::vec4(*reinterpret_cast<const glm::i16vec2*>(&_storage[index]), 0, std::numeric_limits<uint16_t>::max())
-               / float(std::numeric_limits<uint16_t>::max());
-    case rgb16unorm:
-        return glm::vec4(*reinterpret_cast<const glm::u16vec3*>(&_storage[index]), std::numeric_limits<uint16_t>::max())
-               / float(std::numeric_limits<uint16_t>::max());
-    case rgb16snorm:
-        return glm::vec4(*reinterpret_cast<const glm::i16vec3*>(&_storage[index]), std::numeric_limits<uint16_t>::max())
-               / float(std::numeric_limits<uint16_t>::max());
-    case rgba16unorm:
-        return glm::vec4(*reinterpret_cast<const glm::u16vec4*>(&_storage[index])) / float(std::numeric_limits<uint16_t>::max());
-    case rgba16snorm:
-        return glm::vec4(*reinterpret_cast<const glm::i16vec4*>(&_storage[index])) / float(std::numeric_limits<uint16_t>::max());
-
-    case r5g6b5unorm: return glm::vec4(glm::unpackUnorm1x5_1x6_1x5(*reinterpret_cast<const uint16_t*>(&_storage[index])), 1);
-    case rgb5a1unorm: return glm::vec4(glm::unpackUnorm3x5_1x1(*reinterpret_cast<const uint16_t*>(&_storage[index])));
-
-    case rgb10a2snorm: return glm::vec4(glm::unpackSnorm3x10_1x2(*reinterpret_cast<const uint32_t*>(&_storage[index])));
-    case rgb10a2unorm: return glm::vec4(glm::unpackUnorm3x10_1x2(*reinterpret_cast<const uint32_t*>(&_storage[index])));
-
-    case r11g11b10f: return glm::vec4(glm::unpackF2x11_1x10(*reinterpret_cast<const uint32_t*>(&_storage[index])), 1.f);
-    case rgb9e5: return glm::vec4(glm::unpackF3x9_E1x5(*reinterpret_cast<const uint32_t*>(&_storage[index])), 1.f);
+    // The kernel is selected once, the runs only call it.
+    void (*load_run)(const std::byte* run, uint32_t length, T* values) = nullptr;
+    const bool has_kernel = dispatch_format(_format, [&](auto kernel) {
+        using kernel_type = decltype(kernel);
+        if constexpr (std::is_same_v<typename kernel_type::value_type, T>)
+            load_run = [](const std::byte* run, const uint32_t length, T* values) {
+                for (uint32_t i = 0; i < length; ++i) values[i] = kernel_type::load(run + i * kernel_type::size);
+            };
+        else
+            throw std::invalid_argument("Cannot load pixels of this format with the given value type.");
+    });
+    if (!has_kernel) throw std::invalid_argument("Cannot load pixels of a format without a pixel kernel.");
+
+    for_each_run(start, count, [&](const size_t index, const uint32_t offset, const uint32_t length) {
+        load_run(_storage.data() + _storage_element_size * index, length, values + offset);
+    });
+}
 
-    case r16f: return glm::vec4(glm::unpackHalf1x16(*reinterpret_cast<const uint16_t*>(&_storage[index])), 0, 0, 1.f);
-    case rg16f: return glm::vec4(glm::unpackHalf2x16(*reinterpret_cast<const uint32_t*>(&_storage[index])), 0, 1.f);
-    case rgb16f: return glm::vec4(glm::unpackHalf<3, glm::defaultp>(*reinterpret_cast<const glm::u16vec3*>(&_storage[index])), 1.f);
-    case rgba16f: return glm::vec4(glm::unpackHalf4x16(*reinterpret_cast<const uint64_t*>(&_storage[index])));
+template<typename T>
+void host_image::store_row(const glm::uvec3& start, const uint32_t count, const T* values)
+{
+    void (*store_run)(std::byte* run, uint32_t length, const T* values) = nullptr;
+    const bool has_kernel = dispatch_format(_format, [&](auto kernel) {
+        using kernel_type = decltype(kernel);
+        if constexpr (std::is_same_v<typename kernel_type::value_type, T>)
+            store_run = [](std::byte* run, const uint32_t length, const T* values) {
+                for (uint32_t i = 0; i < length; ++i) kernel_type::store(run + i * kernel_type::size, values[i]);
+            };
+        else
+            throw std::invalid_argument("Cannot store pixels of this format with the given value type.");
+    });
+    if (!has_kernel) throw std::invalid_argument("Cannot store pixels of a format without a pixel kernel.");
+
+    for_each_run(start, count, [&](const size_t index, const uint32_t offset, const uint32_t length) {
+        store_run(_storage.data() + _storage_element_size * index, length, values + offset);
+    });
+}
 
-    case r32f: return glm::vec4(*reinterpret_cast<const float*>(&_storage[index]), 0, 0, 1);
-    case rg32f: return glm::vec4(*reinterpret_cast<const glm::vec2*>(&_storage[index]), 0, 1);
-    case rgb32f: return glm::vec4(*reinterpret_cast<const glm::vec3*>(&_storage[index]), 1);
-    case rgba32f: return *reinterpret_cast<const glm::vec4*>(&_storage[index]);
+template void host_image::load_row(const glm::uvec3& start, uint32_t count, glm::vec4* values) const;
+template void host_image::load_row(const glm::uvec3& start, uint32_t count, glm::uvec4* values) const;
+template void host_image::load_row(const glm::uvec3& start, uint32_t count, glm::ivec4* values) const;
+template void host_image::store_row(const glm::uvec3& start, uint32_t count, const glm::vec4* values);
+template void host_image::store_row(const glm::uvec3& start, uint32_t count, const glm::uvec4* values);
+template void host_image::store_row(const glm::uvec3& start, uint32_t count, const glm::ivec4* values);
 
-    default: throw std::invalid_argument("Cannot call load4f on a non-normalized or non-floating-point image.");
-    }
+glm::vec4 host_image::load(glm::uvec3 pixel) const
+{
+    pixel = _extent.clamp(pixel);
+    glm::vec4 value;
+    load_row(pixel, 1, &value);
+    return value;
 }
 
 glm::uvec4 host_image::loadu(const glm::uvec3& pixel) const
 {
-    const size_t index = (_extent.width * _extent.height * pixel.z + _extent.width * pixel.y + pixel.x) * _storage_element_size;
-    switch (_format)
-    {
-    case r8u: return glm::uvec4(*reinterpret_cast<const uint8_t*>(&_storage[index]), 0, 0, 0);
-    case rg8u: return glm::uvec4(*reinterpret_cast<const glm::u8vec2*>(&_storage[index]), 0, 0);
-    case rgb8u: return glm::uvec4(*reinterpret_cast<const glm::u8vec3*>(&_storage[index]), 0);
-    case rgba8u: return glm::uvec4(*reinterpret_cast<const glm::u8vec4*>(&_storage[index]));
-
-    case r16u: return glm::uvec4(*reinterpret_cast<const uint16_t*>(&_storage[index]), 0, 0, 0);
-    case rg16u: return glm::uvec4(*reinterpret_cast<const glm::u16vec2*>(&_storage[index]), 0, 0);
-    case rgb16u: return glm::uvec4(*reinterpret_cast<const glm::u16vec3*>(&_storage[index]), 0);
-    case rgba16u: return glm::uvec4(*reinterpret_cast<const glm::u16vec4*>(&_storage[index]));
-
-    case r32u: return glm::uvec4(*reinterpret_cast<const uint32_t*>(&_storage[index]), 0, 0, 0);
-    case rg32u: return glm::uvec4(*reinterpret_cast<const glm::u32vec2*>(&_storage[index]), 0, 0);
-    case rgb32u: return glm::uvec4(*reinterpret_cast<const glm::u32vec3*>(&_storage[index]), 0);
-    case rgba32u: return glm::uvec4(*reinterpret_cast<const glm::u32vec4*>(&_storage[index]));
-
-    default: throw std::invalid_argument("Cannot call load4u on an image which has no uint type.");
-    }
+    glm::uvec4 value;
+    load_row(pixel, 1, &value);
+    return value;
 }
 
 glm::ivec4 host_image::loadi(const glm::uvec3& pixel) const
 {
-    const size_t index = (_extent.width * _extent.height * pixel.z + _extent.width * pixel.y + pixel.x) * _storage_element_size;
-    switch (_format)
-    {
-    case r8i: return glm::ivec4(*reinterpret_cast<const int8_t*>(&_storage[index]), 0, 0, 0);
-    case rg8i: return glm::ivec4(*reinterpret_cast<const glm::i8vec2*>(&_storage[index]), 0, 0);
-    case rgb8i: return glm::ivec4(*reinterpret_cast<const glm::i8vec3*>(&_storage[index]), 0);
-    case rgba8i: return glm::ivec4(*reinterpret_cast<const glm::i8vec4*>(&_storage[index]));
-
-    case r16i: return glm::ivec4(*reinterpret_cast<const int16_t*>(&_storage[index]), 0, 0, 0);
-    case rg16i: return glm::ivec4(*reinterpret_cast<const glm::i16vec2*>(&_storage[index]), 0, 0);
-    case rgb16i: return glm::ivec4(*reinterpret_cast<const glm::i16vec3*>(&_storage[index]), 0);
-    case rgba16i: return glm::ivec4(*reinterpret_cast<const glm::i16vec4*>(&_storage[index]));
-
-    case r32i: return glm::ivec4(*reinterpret_cast<const int32_t*>(&_storage[index]), 0, 0, 0);
-    case rg32i: return glm::ivec4(*reinterpret_cast<const glm::i32vec2*>(&_storage[index]), 0, 0);
-    case rgb32i: return glm::ivec4(*reinterpret_cast<const glm::i32vec3*>(&_storage[index]), 0);
-    case rgba32i: return glm::ivec4(*reinterpret_cast<const glm::i32vec4*>(&_storage[index]));
-
-    default: throw std::invalid_argument("Cannot call load4u on an image which has no uint type.");
-    }
-}
-
-template<typename T, glm::length_t L>
-auto cnorm(const glm::vec4& p)
-{
-    using vec_type      = glm::vec<L, T, glm::highp>;
-    constexpr float min = std::is_signed_v<T> ? -1.f : 0.f;
-    if constexpr (L == 1)
-        return T(glm::clamp(p.x, min, 1.f) * float(std::numeric_limits<T>::max()));
-    else
-        return vec_type(glm::clamp(p, min, 1.f) * float(std::numeric_limits<T>::max()));
+    glm::ivec4 value;
+    load_row(pixel, 1, &value);
+    return value;
 }
 
 void host_image::store(const glm::uvec3& pixel, const glm::vec4& p)
 {
-    const size_t index = (_extent.width * _extent.height * pixel.z + _extent.width * pixel.y + pixel.x) * _storage_element_size;
-    switch (_format)
-    {
-    case r8unorm: *reinterpret_cast<uint8_t*>(&_storage[index]) = cnorm<uint8_t, 1>(p); break;
-    case r8snorm: *reinterpret_cast<int8_t*>(&_storage[index]) = cnorm<int8_t, 1>(p); break;
-    case rg8unorm: *reinterpret_cast<glm::u8vec2*>(&_storage[index]) = cnorm<uint8_t, 2>(p); break;
-    case rg8snorm: *reinterpret_cast<glm::i8vec2*>(&_storage[index]) = cnorm<int8_t, 2>(p); break;
-    case rgb8unorm: *reinterpret_cast<glm::u8vec3*>(&_storage[index]) = cnorm<uint8_t, 3>(p); break;
-    case rgb8snorm: *reinterpret_cast<glm::u8vec3*>(&_storage[index]) = cnorm<int8_t, 3>(p); break;
-    case rgba8unorm: *reinterpret_cast<glm::u8vec4*>(&_storage[index]) = cnorm<uint8_t, 4>(p); break;
-    case rgba8snorm: *reinterpret_cast<glm::i8vec4*>(&_storage[index]) = cnorm<int8_t, 4>(p); break;
-	
-	case bgr8unorm: [&] {
-		const auto cnormed = cnorm<int8_t, 3>(p);
-		*reinterpret_cast<glm::i8vec3*>(&_storage[index]) ={ cnormed.b, cnormed.g, cnormed.r };
-	}();
-	case bgra8unorm: [&] {
-		const auto cnormed = cnorm<int8_t, 4>(p);
-		*reinterpret_cast<glm::i8vec4*>(&_storage[index]) ={ cnormed.b, cnormed.g, cnormed.r, cnormed.a };
-	}();
-
-    case r16unorm: *reinterpret_cast<uint16_t*>(&_storage[index]) = cnorm<uint16_t, 1>(p); break;
-    case r16snorm: *reinterpret_cast<int16_t*>(&_storage[index]) = cnorm<int16_t, 1>(p); break;
-    case rg16unorm: *reinterpret_cast<glm::u16vec2*>(&_storage[index]) = cnorm<uint16_t, 2>(p); break;
-    case rg16snorm: *reinterpret_cast<glm::i16vec2*>(&_storage[index]) = cnorm<int16_t, 2>(p); break;
-    case rgb16unorm: *reinterpret_cast<glm::u16vec3*>(&_storage[index]) = cnorm<uint16_t, 3>(p); break;
-    case rgb16snorm: *reinterpret_cast<glm::u16vec3*>(&_storage[index]) = cnorm<int16_t, 3>(p); break;
-    case rgba16unorm: *reinterpret_cast<glm::u16vec4*>(&_storage[index]) = cnorm<uint16_t, 4>(p); break;
-    case rgba16snorm: *reinterpret_cast<glm::i16vec4*>(&_storage[index]) = cnorm<int16_t, 4>(p); break;
-
-    case r5g6b5unorm: *reinterpret_cast<uint16_t*>(&_storage[index]) = packUnorm1x5_1x6_1x5(p); break;
-    case rgb5a1unorm: *reinterpret_cast<uint16_t*>(&_storage[index]) = packUnorm3x5_1x1(p); break;
-
-    case rgb10a2snorm: *reinterpret_cast<uint32_t*>(&_storage[index]) = packSnorm3x10_1x2(p); break;
-    case rgb10a2unorm: *reinterpret_cast<uint32_t*>(&_storage[index]) = packUnorm3x10_1x2(p); break;
-
-    case r11g11b10f: *reinterpret_cast<uint32_t*>(&_storage[index]) = packF2x11_1x10(p); break;
-    case rgb9e5: *reinterpret_cast<uint32_t*>(&_storage[index]) = packF3x9_E1x5(p); break;
-
-    case r16f: *reinterpret_cast<uint16_t*>(&_storage[index]) = glm::packHalf1x16(p.x); break;
-    case rg16f: *reinterpret_cast<uint32_t*>(&_storage[index]) = packHalf2x16(p); break;
-    case rgb16f: *reinterpret_cast<glm::u16vec3*>(&_storage[index]) = glm::packHalf<3, glm::defaultp>(p); break;
-    case rgba16f: *reinterpret_cast<uint64_t*>(&_storage[index]) = packHalf4x16(p); break;
-
-    case r32f: *reinterpret_cast<float*>(&_storage[index]) = p.x; break;
-    case rg32f: *reinterpret_cast<glm::vec2*>(&_storage[index]) = p; break;
-    case rgb32f: *reinterpret_cast<glm::vec3*>(&_storage[index]) = p; break;
-    case rgba32f: *reinterpret_cast<glm::vec4*>(&_storage[index]) = p; break;
-
-    default: throw std::invalid_argument("Cannot call storef on a non-normalized or non-floating-point image.");
-    }
+    store_row(pixel, 1, &p);
 }
 
 void host_image::storeu(const glm::uvec3& pixel, const glm::uvec4& p)
 {
-    const size_t index = (_extent.width * _extent.height * pixel.z + _extent.width * pixel.y + pixel.x) * _storage_element_size;
-    switch (_format)
-    {
-    case r8u: *reinterpret_cast<glm::u8vec1*>(&_storage[index]) = p; break;
-    case rg8u: *reinterpret_cast<glm::u8vec2*>(&_storage[index]) = p; break;
-    case rgb8u: *reinterpret_cast<glm::u8vec3*>(&_storage[index]) = p; break;
-    case rgba8u: *reinterpret_cast<glm::u8vec4*>(&_storage[index]) = p; break;
-
-    case r16u: *reinterpret_cast<glm::u16vec1*>(&_storage[index]) = p; break;
-    case rg16u: *reinterpret_cast<glm::u16vec2*>(&_storage[index]) = p; break;
-    case rgb16u: *reinterpret_cast<glm::u16vec3*>(&_storage[index]) = p; break;
-    case rgba16u: *reinterpret_cast<glm::u16vec4*>(&_storage[index]) = p; break;
-
-    case r32u: *reinterpret_cast<glm::u32vec1*>(&_storage[index]) = p; break;
-    case rg32u: *reinterpret_cast<glm::u32vec2*>(&_storage[index]) = p; break;
-    case rgb32u: *reinterpret_cast<glm::u32vec3*>(&_storage[index]) = p; break;
-    case rgba32u: *reinterpret_cast<glm::u32vec4*>(&_storage[index]) = p; break;
-
-    default: throw std::invalid_argument("Cannot call storeu on an image which has no uint type.");
-    }
+    store_row(pixel, 1, &p);
 }
 
 void host_image::storei(const glm::uvec3& pixel, const glm::ivec4& p)
 {
-    const size_t index = (_extent.width * _extent.height * pixel.z + _extent.width * pixel.y + pixel.x) * _storage_element_size;
-    switch (_format)
-    {
-    case r8i: *reinterpret_cast<glm::i8vec1*>(&_storage[index]) = p; break;
-    case rg8i: *reinterpret_cast<glm::i8vec2*>(&_storage[index]) = p; break;
-    case rgb8i: *reinterpret_cast<glm::i8vec3*>(&_storage[index]) = p; break;
-    case rgba8i: *reinterpret_cast<glm::i8vec4*>(&_storage[index]) = p; break;
-
-    case r16i: *reinterpret_cast<glm::i16vec1*>(&_storage[index]) = p; break;
-    case rg16i: *reinterpret_cast<glm::i16vec2*>(&_storage[index]) = p; break;
-    case rgb16i: *reinterpret_cast<glm::i16vec3*>(&_storage[index]) = p; break;
-    case rgba16i: *reinterpret_cast<glm::i16vec4*>(&_storage[index]) = p; break;
-
-    case r32i: *reinterpret_cast<glm::i32vec1*>(&_storage[index]) = p; break;
-    case rg32i: *reinterpret_cast<glm::i32vec2*>(&_storage[index]) = p; break;
-    case rgb32i: *reinterpret_cast<glm::i32vec3*>(&_storage[index]) = p; break;
-    case rgba32i: *reinterpret_cast<glm::i32vec4*>(&_storage[index]) = p; break;
-
-    default: throw std::invalid_argument("Cannot call storeu on an image which has no uint type.");
-    }
+    store_row(pixel, 1, &p);
 }
 
 bool is_unorm_compatible(const format fmt)
@@ -383,7 +330,9 @@ bool is_unorm_compatible(const format fmt)
     case r32f:
     case rg32f:
     case rgb32f:
-    case rgba32f: return true;
+    case rgba32f:
+    case bgr8unorm:
+    case bgra8unorm: return true;
     default: break;
     }
     return false;
@@ -430,38 +379,248 @@ bool is_signed(const format fmt)
     return false;
 }
 
-void host_image::convolute(const image_filter& f)
+std::optional<std::array<std::vector<float>, 3>> image_filter::separated() const
 {
-    gfx::host_image tmp(pixel_format(), extents());
-    convolute(f, tmp);
-    memcpy(storage().data(), tmp.storage().data(), storage().size());
+    const auto peak_it = std::max_element(_data.begin(), _data.end(), [](float a, float b) { return std::abs(a) < std::abs(b); });
+    if (peak_it == _data.end() || *peak_it == 0.f) return std::nullopt;
+
+    // A separable filter is the outer product of the lines through its largest weight.
+    const glm::uvec3                  peak = _extents.subpixel(uint32_t(peak_it - _data.begin()));
+    const float                       peak_value = *peak_it;
+    std::array<std::vector<float>, 3> weights{std::vector<float>(_extents.width), std::vector<float>(_extents.height),
+                                              std::vector<float>(_extents.depth)};
+    for (uint32_t x = 0; x < _extents.width; ++x) weights[0][x] = (*this)[{x, peak.y, peak.z}];
+    for (uint32_t y = 0; y < _extents.height; ++y) weights[1][y] = (*this)[{peak.x, y, peak.z}] / peak_value;
+    for (uint32_t z = 0; z < _extents.depth; ++z) weights[2][z] = (*this)[{peak.x, peak.y, z}] / peak_value;
+
+    const float tolerance = 1e-5f * std::abs(peak_value);
+    for (auto i = 0u; i < _extents.count(); ++i) {
+        const glm::uvec3 p = _extents.subpixel(i);
+        if (std::abs(weights[0][p.x] * weights[1][p.y] * weights[2][p.z] - _data[i]) > tolerance) return std::nullopt;
+    }
+    return weights;
 }
 
-void host_image::convolute(const image_filter& f, host_image& into) const
+namespace {
+// Floats per tile of a convolution pass, small enough for the accumulated values to stay in the L1 cache.
+constexpr size_t convolution_tile = 1024;
+
+// Adds weight * in to out for one tile. The loop runs over all channels of consecutive pixels, so it vectorizes.
+void accumulate(float* out, const float* in, const float weight, const size_t count)
 {
-    assert(is_unorm_compatible(_format));
+    for (size_t i = 0; i < count; ++i) out[i] += weight * in[i];
+}
+
+// Convolutes all rows along x. Each row is copied into a buffer padded with the border pixels, so the inner loops need
+// no clamping.
+void convolute_x(const extent& size, const std::vector<float>& weights, const glm::vec4* src, glm::vec4* dst)
+{
+    const size_t  radius = weights.size() / 2;
+    const size_t  floats = 4 * size_t(size.width);
+    const int64_t rows   = int64_t(size.height) * size.depth;
+#pragma omp parallel
+    {
+        std::vector<glm::vec4> padded(size.width + 2 * radius);
+#pragma omp for schedule(static)
+        for (int64_t r = 0; r < rows; ++r) {
+            const glm::vec4* row = src + r * size.width;
+            std::fill_n(padded.begin(), radius, row[0]);
+            std::copy_n(row, size.width, padded.begin() + radius);
+            std::fill_n(padded.begin() + radius + size.width, radius, row[size.width - 1]);
+
+            float* const out = glm::value_ptr(dst[r * size.width]);
+            for (size_t begin = 0; begin < floats; begin += convolution_tile) {
+                const size_t count = std::min(convolution_tile, floats - begin);
+                std::fill_n(out + begin, count, 0.f);
+                for (size_t k = 0; k < weights.size(); ++k)
+                    if (weights[k] != 0.f) accumulate(out + begin, glm::value_ptr(padded[k]) + begin, weights[k], count);
+            }
+        }
+    }
+}
 
-    const auto half_size = f.extents().vec / 2u;
+// Convolutes along y (axis 1) or z (axis 2), where neighbors are whole rows apart. Each output row is a weighted sum of
+// input rows, which are read sequentially, and the border clamping is done once per row instead of once per pixel.
+void convolute_yz(const extent& size, const int axis, const std::vector<float>& weights, const glm::vec4* src, glm::vec4* dst)
+{
+    const int64_t radius = int64_t(weights.size() / 2);
+    const size_t  floats = 4 * size_t(size.width);
+    const int64_t length = axis == 1 ? size.height : size.depth;
+    const int64_t stride = axis == 1 ? size.width : int64_t(size.width) * size.height;
+    const int64_t rows   = int64_t(size.height) * size.depth;
+#pragma omp parallel for schedule(static)
+    for (int64_t r = 0; r < rows; ++r) {
+        const int64_t    position = axis == 1 ? r % size.height : r / size.height;
+        const glm::vec4* line     = src + r * size.width - position * stride;
+        float* const     out      = glm::value_ptr(dst[r * size.width]);
+        for (size_t begin = 0; begin < floats; begin += convolution_tile) {
+            const size_t count = std::min(convolution_tile, floats - begin);
+            std::fill_n(out + begin, count, 0.f);
+            for (size_t k = 0; k < weights.size(); ++k) {
+                if (weights[k] == 0.f) continue;
+                const int64_t p = std::clamp<int64_t>(position + int64_t(k) - radius, 0, length - 1);
+                accumulate(out + begin, glm::value_ptr(line[p * stride]) + begin, weights[k], count);
+            }
+        }
+    }
+}
+
+std::vector<float> convolve_weights(const std::vector<float>& a, const std::vector<float>& b)
+{
+    std::vector<float> result(a.size() + b.size() - 1, 0.f);
+    for (size_t i = 0; i < a.size(); ++i)
+        for (size_t j = 0; j < b.size(); ++j) result[i + j] += a[i] * b[j];
+    return result;
+}
+
+bool is_identity(const std::vector<float>& weights)
+{
+    return weights.size() == 1 && weights[0] == 1.f;
+}
 
-#pragma omp parallel for
-    for (int p = 0; p < extents().count(); ++p) {
-        const glm::uvec3 pixel = extents().subpixel(p);
+// Convolutes the pixels in place, one pass per axis.
+void convolute_separable(std::vector<glm::vec4>& pixels, const extent& size, const std::array<std::vector<float>, 3>& weights)
+{
+    std::vector<glm::vec4> target(size.count());
+    for (int axis = 0; axis < 3; ++axis) {
+        if (is_identity(weights[axis])) continue;
+        if (axis == 0)
+            convolute_x(size, weights[axis], pixels.data(), target.data());
+        else
+            convolute_yz(size, axis, weights[axis], pixels.data(), target.data());
+        std::swap(pixels, target);
+    }
+}
+
+// The weights of a separable filter, if its passes are cheaper than its taps. Each pass reads and writes all pixels
+// once more, so a 3x3 filter runs about as fast either way, and a 5x5 filter is already more than 1.5 times faster in
+// passes.
+std::optional<std::array<std::vector<float>, 3>> separable_weights(const image_filter& f)
+{
+    auto weights = f.separated();
+    if (!weights) return std::nullopt;
+    size_t pass_taps = 0;
+    for (const auto& w : *weights)
+        if (!is_identity(w)) pass_taps += std::count_if(w.begin(), w.end(), [](float x) { return x != 0.f; });
+    const size_t taps = std::count_if(f.data(), f.data() + f.extents().count(), [](float x) { return x != 0.f; });
+    if (taps <= 2 * pass_taps) return std::nullopt;
+    return weights;
+}
 
-        glm::vec4 color{0};
-        for (auto i = 0u; i < f.extents().count(); ++i) {
-            const auto filter_pixel = f.extents().subpixel(i);
-            const auto cl           = extents().clamp(pixel + filter_pixel - half_size);
+// Convolutes with every tap of the filter and hands each row of results to store(start, values).
+template<typename Store>
+void convolute_direct(const std::vector<glm::vec4>& pixels, const extent& size, const image_filter& f, Store&& store)
+{
+    struct tap
+    {
+        glm::ivec3 offset;
+        float      weight;
+    };
+    const glm::ivec3 half_size = f.extents().vec / 2u;
+    std::vector<tap> taps;
+    for (auto i = 0u; i < f.extents().count(); ++i) {
+        const glm::uvec3 filter_pixel = f.extents().subpixel(i);
+        if (const float weight = f[filter_pixel]; weight != 0.f) taps.push_back({glm::ivec3(filter_pixel) - half_size, weight});
+    }
 
-            color += load(cl) * f[filter_pixel];
+    const int64_t rows = int64_t(size.height) * size.depth;
+#pragma omp parallel
+    {
+        std::vector<glm::vec4> values(size.width);
+#pragma omp for schedule(static)
+        for (int64_t r = 0; r < rows; ++r) {
+            const glm::uvec3 start(0, uint32_t(r % size.height), uint32_t(r / size.height));
+            for (uint32_t x = 0; x < size.width; ++x) {
+                const glm::ivec3 pixel(x, start.y, start.z);
+                glm::vec4        color{0};
+                for (const auto& t : taps) color += pixels[size.linear(size.clamp(pixel + t.offset))] * t.weight;
+                values[x] = color;
+            }
+            store(start, values.data());
         }
-        into.store(pixel, color);
     }
 }
 
+// Convolutes the pixels in place, keeping the results as floats.
+void convolute_floats(std::vector<glm::vec4>& pixels, const extent& size, const image_filter& f)
+{
+    if (const auto weights = separable_weights(f)) {
+        convolute_separable(pixels, size, *weights);
+        return;
+    }
+    std::vector<glm::vec4> target(size.count());
+    convolute_direct(pixels, size, f, [&](const glm::uvec3& start, const glm::vec4* values) {
+        std::copy_n(values, size.width, target.begin() + size.linear(start));
+    });
+    std::swap(pixels, target);
+}
+}    // namespace
+
+namespace detail {
+void convolute_pixels(std::vector<glm::vec4>& pixels, const extent& size, const image_filter& f, host_image& into)
+{
+    if (const auto weights = separable_weights(f)) {
+        convolute_separable(pixels, size, *weights);
+        pack_pixels(pixels, color_space::linear, into);
+        return;
+    }
+    convolute_direct(pixels, size, f,
+                     [&](const glm::uvec3& start, const glm::vec4* values) { into.store_row(start, size.width, values); });
+}
+
+void convolute_pixels(std::vector<glm::vec4>& pixels, const extent& size,
+                      const std::tuple<image_filter, image_filter, image_filter>& filters, host_image& into)
+{
+    const auto w0 = std::get<0>(filters).separated();
+    const auto w1 = std::get<1>(filters).separated();
+    const auto w2 = std::get<2>(filters).separated();
+    if (!w0 || !w1 || !w2) {
+        // The intermediate results stay floats, so the pixels are only quantized once.
+        convolute_floats(pixels, size, std::get<0>(filters));
+        convolute_floats(pixels, size, std::get<1>(filters));
+        convolute_pixels(pixels, size, std::get<2>(filters), into);
+        return;
+    }
+
+    // Sequential convolutions along the same axis combine into a single one.
+    std::array<std::vector<float>, 3> weights;
+    for (size_t axis = 0; axis < 3; ++axis) weights[axis] = convolve_weights(convolve_weights((*w0)[axis], (*w1)[axis]), (*w2)[axis]);
+    convolute_separable(pixels, size, weights);
+    pack_pixels(pixels, color_space::linear, into);
+}
+}    // namespace detail
+
+void host_image::convolute(const image_filter& f)
+{
+    convolute(f, *this);
+}
+
+// The pixels are unpacked before anything is stored, so the into image may be this image.
+void host_image::convolute(const image_filter& f, host_image& into) const
+{
+    assert(is_unorm_compatible(_format));
+    assert(into.extents() == _extent);
+    std::vector<glm::vec4> pixels = detail::unpack_pixels(*this, color_space::linear);
+    detail::convolute_pixels(pixels, _extent, f, into);
+}
+
+void host_image::convolute(const std::tuple<image_filter, image_filter, image_filter>& filters)
+{
+    convolute(filters, *this);
+}
+
+void host_image::convolute(const std::tuple<image_filter, image_filter, image_filter>& filters, host_image& into) const
+{
+    assert(into.extents() == _extent);
+    std::vector<glm::vec4> pixels = detail::unpack_pixels(*this, color_space::linear);
+    detail::convolute_pixels(pixels, _extent, filters, into);
+}
+
 bool host_image::operator==(const host_image& image) const
 {
-    return _format == image._format && _extent == image._extent && storage().size() == image.storage().size()
-           && memcmp(storage().data(), image.storage().data(), storage().size()) == 0;
+    if (_format != image._format || _extent != image._extent) return false;
+    if (_layout != image._layout) return *this == image.with_layout(_layout);
+    return storage().size() == image.storage().size() && memcmp(storage().data(), image.storage().data(), storage().size()) == 0;
 }
 
 bool host_image::operator!=(const host_image& image) const
@@ -469,62 +628,38 @@ bool host_image::operator!=(const host_image& image) const
     return !(*this == image);
 }
 
-std::function<void(const glm::vec4& v, int64_t i)> host_image::get_write_unorm_fun()
+template<typename T>
+void host_image::update_normalized(const data_format fmt, const T* data)
 {
-    const auto pack_fun = [this](auto fun) {
-        return [ this, f = fun ](const glm::vec4& v, const int64_t i)
-        {
-            auto x = f(v);
-            memcpy(&(_storage.data()[_storage_element_size * i]), &x, sizeof(x));
-        };
-    };
-    const auto pack_funf = [this](auto fun) {
-        return [ this, f = fun ](const glm::vec4& v, const int64_t i)
-        {
-            auto x = f(v.x);
-            memcpy(&(_storage.data()[_storage_element_size * i]), &x, sizeof(x));
-        };
-    };
+    if (!has_value_type<glm::vec4>(_format))
+        throw std::invalid_argument("Cannot update an image of this format with normalized values.");
+
+    const auto  data_components = static_cast<size_t>(fmt);
+    const float scale           = std::is_floating_point_v<T> ? 1.f : 1.f / static_cast<float>(std::numeric_limits<T>::max());
+    detail::parallel_rows<glm::vec4>(_extent, _extent.width, [&](const glm::uvec3& start, glm::vec4* values) {
+        const T* row = data + data_components * _extent.linear(start);
+        for (uint32_t x = 0; x < _extent.width; ++x) {
+            values[x] = glm::vec4{0, 0, 0, 1};
+            for (size_t c = 0; c < data_components; ++c) values[x][c] = row[data_components * x + c] * scale;
+        }
+        store_row(start, _extent.width, values);
+    });
+}
 
-    switch (_format)
-    {
-    case r8unorm: return pack_funf(glm::packUnorm1x8);
-    case r8snorm: return pack_funf(glm::packSnorm1x8);
-    case rg8unorm: return pack_fun(glm::packUnorm2x8);
-    case rg8snorm: return pack_fun(glm::packSnorm2x8);
-    case rgb8unorm: return pack_fun(glm::packUnorm<uint8_t, 3, float, glm::highp>);
-    case rgb8snorm: return pack_fun(glm::packSnorm<uint8_t, 3, float, glm::highp>);
-    case rgba8unorm: return pack_fun(glm::packUnorm4x8);
-    case rgba8snorm: return pack_fun(glm::packSnorm4x8);
-    case r5g6b5unorm: return pack_fun(glm::packUnorm1x5_1x6_1x5);
-    case r16unorm: return pack_funf(glm::packUnorm1x16);
-    case r16snorm: return pack_funf(glm::packSnorm1x16);
-    case rg16unorm: return pack_fun(glm::packUnorm2x16);
-    case rg16snorm: return pack_fun(glm::packSnorm2x16);
-    case r16f: return pack_funf(glm::packHalf1x16);
-    case rgb16unorm: return pack_fun(glm::packUnorm<uint16_t, 3, float, glm::highp>);
-    case rgb16snorm: return pack_fun(glm::packSnorm<uint16_t, 3, float, glm::highp>);
-    case rgb5a1unorm: return pack_fun(glm::packUnorm3x5_1x1);
-    case rgb9e5: return pack_fun(glm::packF3x9_E1x5);
-    case rg16f: return pack_fun(glm::packHalf2x16);
-    case rgb10a2unorm: return pack_fun(glm::packUnorm3x10_1x2);
-    case rgb10a2snorm: return pack_fun(glm::packSnorm3x10_1x2);
-    case r11g11b10f: return pack_fun(glm::packF2x11_1x10);
-    case rgb16f: return pack_fun(glm::packHalf<3, glm::highp>);
-    case rgba16unorm: return pack_fun(glm::packUnorm4x16);
-    case rgba16snorm: return pack_fun(glm::packSnorm4x16);
-    case rgba16f: return pack_fun(glm::packHalf4x16);
-    case r32f: return pack_fun([](const auto& v) { return glm::vec1(v); });
-    case rg32f: return pack_fun([](const auto& v) { return glm::vec2(v); });
-    case rgb32f: return pack_fun([](const auto& v) { return glm::vec3(v); });
-    case rgba32f: return pack_fun([](const auto& v) { return glm::vec4(v); });
-    default: break;
-    }
-    return pack_fun([](const auto& v) { return glm::vec4(v); });
+// The updates below write the data in linear order, so tiled images are updated through a linear one.
+template<typename T>
+bool host_image::update_tiled(const data_format fmt, const T* data)
+{
+    if (_layout == image_layout::linear) return false;
+    host_image image(_format, _extent);
+    image.update(fmt, data);
+    *this = image.with_layout(_layout);
+    return true;
 }
 
 void host_image::update(data_format format, const uint8_t* data)
 {
+    if (update_tiled(format, data)) return;
     using data_type              = std::decay_t<decltype(data[0])>;
     const auto   data_components = static_cast<size_t>(format);
     const size_t data_size       = std::min(_storage_element_size, sizeof(data_type) * data_components);
@@ -633,18 +768,11 @@ void host_image::update(data_format format, const uint8_t* data)
     default: break;
     }
 
-#pragma omp parallel for schedule(static)
-    for (int64_t i = 0; i < static_cast<int64_t>(_extent.count()); ++i) {
-        glm::vec4 unpacked{0, 0, 0, 1};
-        for (int c = 0; c < data_components; ++c) {
-            unpacked[c] = data[data_components * i + c] / static_cast<float>(std::numeric_limits<data_type>::max());
-        }
-
-        _write_unorm(unpacked, i);
-    }
+    update_normalized(format, data);
 }
 void host_image::update(data_format format, const uint16_t* data)
 {
+    if (update_tiled(format, data)) return;
     using data_type              = std::decay_t<decltype(data[0])>;
     const size_t data_components = static_cast<size_t>(format);
     const size_t data_size       = std::min(_storage_element_size, sizeof(data_type) * data_components);
@@ -753,18 +881,11 @@ void host_image::update(data_format format, const uint16_t* data)
     default: break;
     }
 
-#pragma omp parallel for schedule(static)
-    for (int64_t i = 0; i < static_cast<int64_t>(_extent.count()); ++i) {
-        glm::vec4 unpacked{0, 0, 0, 1};
-        for (int c = 0; c < data_components; ++c) {
-            unpacked[c] = data[data_components * i + c] / static_cast<float>(std::numeric_limits<data_type>::max());
-        }
-
-        _write_unorm(unpacked, i);
-    }
+    update_normalized(format, data);
 }
 void host_image::update(data_format format, const uint32_t* data)
 {
+    if (update_tiled(format, data)) return;
     using data_type              = std::decay_t<decltype(data[0])>;
     const size_t data_components = static_cast<size_t>(format);
     const size_t data_size       = std::min(_storage_element_size, sizeof(data_type) * data_components);
@@ -873,18 +994,11 @@ void host_image::update(data_format format, const uint32_t* data)
     default: break;
     }
 
-#pragma omp parallel for schedule(static)
-    for (int64_t i = 0; i < static_cast<int64_t>(_extent.count()); ++i) {
-        glm::vec4 unpacked{0, 0, 0, 1};
-        for (int c = 0; c < data_components; ++c) {
-            unpacked[c] = data[data_components * i + c] / static_cast<float>(std::numeric_limits<data_type>::max());
-        }
-
-        _write_unorm(unpacked, i);
-    }
+    update_normalized(format, data);
 }
 void host_image::update(data_format format, const int8_t* data)
 {
+    if (update_tiled(format, data)) return;
     using data_type              = std::decay_t<decltype(data[0])>;
     const size_t data_components = static_cast<size_t>(format);
     const size_t data_size       = std::min(_storage_element_size, sizeof(data_type) * data_components);
@@ -993,18 +1107,11 @@ void host_image::update(data_format format, const int8_t* data)
     default: break;
     }
 
-#pragma omp parallel for schedule(static)
-    for (int64_t i = 0; i < static_cast<int64_t>(_extent.count()); ++i) {
-        glm::vec4 unpacked{0, 0, 0, 1};
-        for (int c = 0; c < data_components; ++c) {
-            unpacked[c] = data[data_components * i + c] / static_cast<float>(std::numeric_limits<data_type>::max());
-        }
-
-        _write_unorm(unpacked, i);
-    }
+    update_normalized(format, data);
 }
 void host_image::update(data_format format, const int16_t* data)
 {
+    if (update_tiled(format, data)) return;
     using data_type              = std::decay_t<decltype(data[0])>;
     const size_t data_components = static_cast<size_t>(format);
     const size_t data_size       = std::min(_storage_element_size, sizeof(data_type) * data_components);
@@ -1113,18 +1220,11 @@ void host_image::update(data_format format, const int16_t* data)
     default: break;
     }
 
-#pragma omp parallel for schedule(static)
-    for (int64_t i = 0; i < static_cast<int64_t>(_extent.count()); ++i) {
-        glm::vec4 unpacked{0, 0, 0, 1};
-        for (int c = 0; c < data_components; ++c) {
-            unpacked[c] = data[data_components * i + c] / static_cast<float>(std::numeric_limits<data_type>::max());
-        }
-
-        _write_unorm(unpacked, i);
-    }
+    update_normalized(format, data);
 }
 void host_image::update(data_format format, const int32_t* data)
 {
+    if (update_tiled(format, data)) return;
     using data_type              = std::decay_t<decltype(data[0])>;
     const size_t data_components = static_cast<size_t>(format);
     const size_t data_size       = std::min(_storage_element_size, sizeof(data_type) * data_components);
@@ -1233,18 +1333,11 @@ void host_image::update(data_format format, const int32_t* data)
     default: break;
     }
 
-#pragma omp parallel for schedule(static)
-    for (int64_t i = 0; i < static_cast<int64_t>(_extent.count()); ++i) {
-        glm::vec4 unpacked{0, 0, 0, 1};
-        for (int c = 0; c < data_components; ++c) {
-            unpacked[c] = data[data_components * i + c] / static_cast<float>(std::numeric_limits<data_type>::max());
-        }
-
-        _write_unorm(unpacked, i);
-    }
+    update_normalized(format, data);
 }
 void host_image::update(data_format format, const float* data)
 {
+    if (update_tiled(format, data)) return;
     using data_type              = std::decay_t<decltype(data[0])>;
     const size_t data_components = static_cast<size_t>(format);
 
@@ -1307,15 +1400,7 @@ void host_image::update(data_format format, const float* data)
     default: break;
     }
 
-#pragma omp parallel for schedule(static)
-    for (int64_t i = 0; i < static_cast<int64_t>(_extent.count()); ++i) {
-        glm::vec4 unpacked{0, 0, 0, 1};
-        for (int c = 0; c < data_components; ++c) {
-            unpacked[c] = data[data_components * i + c];
-        }
-
-        _write_unorm(unpacked, i);
-    }
+    update_normalized(format, data);
 }
 
 const host_buffer<std::byte>& host_image::storage() const noexcept
@@ -1,8 +1,11 @@
 #pragma once
 #include "formats.hpp"
 #include "host_buffer.hpp"
+#include "pixel_kernels.hpp"
+#include <array>
 #include <cinttypes>
 #include <functional>
+#include <optional>
 #include <gfx/file/file.hpp>
 #include <glm/ext.hpp>
 
@@ -79,6 +82,10 @@ public:
     const auto* data() const noexcept { return _data.data(); }
     auto*       data() noexcept { return _data.data(); }
 
+    // Factors the filter into one-dimensional weights along x, y and z whose product is the filter, or returns nullopt
+    // if the filter is not separable.
+    std::optional<std::array<std::vector<float>, 3>> separated() const;
+
 private:
     extent             _extents;
     std::vector<float> _data;
@@ -88,19 +95,98 @@ bool is_unsigned(format fmt);
 bool is_signed(format fmt);
 bool is_unorm_compatible(format fmt);
 
+namespace detail {
+// Defined in parallel_rows.hpp, which is included at the end of this header.
+template<typename T, typename Fun>
+void parallel_rows(const extent& size, size_t buffer_size, Fun&& fun);
+template<typename T, typename State, typename Fun, typename Combine>
+State reduce_rows(const extent& size, size_t buffer_size, State init, Fun&& fun, Combine&& combine);
+}    // namespace detail
+
+class host_image;
+class host_image_view;
+class lazy_image;
+template<typename Lhs, typename Rhs, typename Op>
+class image_expression;
+
+template<typename T>
+constexpr bool is_image_expression_v = false;
+template<>
+constexpr bool is_image_expression_v<lazy_image> = true;
+template<typename Lhs, typename Rhs, typename Op>
+constexpr bool is_image_expression_v<image_expression<Lhs, Rhs, Op>> = true;
+
+// Types which can be combined with an image through the arithmetic operators.
+template<typename T>
+constexpr bool is_image_operand_v = std::is_same_v<T, host_image> || is_image_expression_v<T> || std::is_same_v<T, float>
+                                    || std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> || std::is_same_v<T, glm::vec4>
+                                    || std::is_same_v<T, glm::ivec4> || std::is_same_v<T, glm::uvec4>;
+
+// The order of the pixels in the storage of a host_image. Tiled images store 8x8 tiles, or 4x4x4 bricks if they have
+// a depth, one after another so that neighbouring rows and slices are close in memory. Their storage is padded to
+// whole tiles.
+enum class image_layout
+{
+    linear,
+    tiled
+};
+
+enum class resample_filter
+{
+    box,         // Average of the covered pixels, like a blit.
+    triangle,    // Linear interpolation, or a tent over the covered pixels when shrinking.
+    mitchell,    // Mitchell-Netravali cubic with B = C = 1/3.
+    kaiser,      // Kaiser-windowed sinc with a radius of three pixels.
+    lanczos      // Lanczos-windowed sinc with a radius of three pixels.
+};
+
+// How each_pixel, each_row and the reductions visit the pixels. The parallel policies split the rows between threads,
+// parallel_vectorized also lets the compiler vectorize the loop over the pixels of a row in each_pixel, so the function
+// must not depend on the order of the pixels of a row.
+enum class execution_policy
+{
+    sequential,
+    parallel,
+    parallel_vectorized
+};
+
+enum class color_space
+{
+    linear,
+    srgb    // Color channels are sRGB-encoded and filtered as linear values, alpha is always linear.
+};
+
 class host_image
 {
 public:
-    host_image(format fmt, const extent& size);
+    host_image(format fmt, const extent& size, image_layout layout = image_layout::linear);
     host_image(format fmt, const image_file& file);
+    // Decodes the file and converts its pixels into the image in one pass, without an intermediate copy.
     host_image(format fmt, const std::filesystem::path& file);
+    // Copies the pixels of a view.
+    explicit host_image(const host_image_view& view);
 
     host_image(const host_image& o);
     host_image& operator       =(const host_image& o);
     host_image(host_image&& o) = default;
     host_image& operator=(host_image&& o) = default;
 
+    // Evaluates an expression like (a - mean) * scale + b in a single pass. Assigning to an image with the format and
+    // extents of the expression reuses its storage, and the image may be one of the operands.
+    template<typename Lhs, typename Rhs, typename Op>
+    host_image(const image_expression<Lhs, Rhs, Op>& expression);
+    template<typename Lhs, typename Rhs, typename Op>
+    host_image& operator=(const image_expression<Lhs, Rhs, Op>& expression);
+
+    // Views the storage of an image with a linear layout, or the part of it from offset to offset + size.
+    host_image_view view() const;
+    host_image_view view(const glm::uvec3& offset, const extent& size) const;
+
     host_image converted(format fmt) const;
+    host_image with_layout(image_layout layout) const;
+    // Resamples the image to other extents with one pass of precomputed weights per axis which changes size.
+    host_image resized(const extent& size, resample_filter filter = resample_filter::mitchell,
+                       color_space space = color_space::linear) const;
     void       flip_vertically();
 
     void update(data_format fmt, const uint8_t* data);
@@ -112,18 +198,53 @@ public:
     void update(data_format fmt, const float* data);
     void update(const image_file& file);
 
+    // The pixels in the order given by the layout. Device images can only be filled from linear storage.
     host_buffer<std::byte>&       storage() noexcept;
     const host_buffer<std::byte>& storage() const noexcept;
 
     const extent& extents() const noexcept;
     uint32_t      max_levels() const noexcept;
     format        pixel_format() const noexcept;
+    image_layout  layout() const noexcept;
 
+    // Calls f(pixel) for all pixels, row by row. The coordinates are counted up instead of being computed from an index.
     template<typename Fun, typename = decltype(std::declval<Fun>()(std::declval<glm::uvec3>()))>
     void each_pixel(Fun&& f) const
     {
-        for (auto i = 0u; i < _extent.count(); ++i) f(_extent.subpixel(i));
+        each_pixel(execution_policy::sequential, f);
     }
+    template<typename Fun, typename = decltype(std::declval<Fun>()(std::declval<glm::uvec3>()))>
+    void each_pixel(execution_policy policy, Fun&& f) const;
+    // Calls f(start, width) for every row, with start being its first pixel, like for load_row and store_row.
+    template<typename Fun>
+    void each_row(execution_policy policy, Fun&& f) const;
+
+    // Like each_pixel and each_row, but f(state, ...) also gets a state, which every thread initializes from init. The
+    // states of the threads are combined with combine(a, b) in the order of their rows, so init has to be neutral, like
+    // zero for a sum. Reductions never vectorize the loop over a row, as all pixels of a thread update the same state.
+    template<typename State, typename Fun, typename Combine>
+    State reduce_pixels(execution_policy policy, State init, Fun&& f, Combine&& combine) const;
+    template<typename State, typename Fun, typename Combine>
+    State reduce_rows(execution_policy policy, State init, Fun&& f, Combine&& combine) const;
+
+    // Calls fun(pixel, value) for every pixel with the value loaded through the kernel of the pixel format, which is
+    // selected once for the whole image. The mutable overloads store the value back afterwards. Without an explicit
+    // format, fun has to accept glm::vec4, glm::uvec4 and glm::ivec4 values.
+    template<typename Fun>
+    void visit_pixels(Fun&& fun);
+    template<typename Fun>
+    void visit_pixels(Fun&& fun) const;
+    template<format Format, typename Fun>
+    void visit_pixels(Fun&& fun);
+    template<format Format, typename Fun>
+    void visit_pixels(Fun&& fun) const;
+
+    // Loads or stores count consecutive pixels of the row containing start. T is glm::vec4 for normalized and
+    // floating-point formats, glm::uvec4 for unsigned and glm::ivec4 for signed integer formats.
+    template<typename T>
+    void load_row(const glm::uvec3& start, uint32_t count, T* values) const;
+    template<typename T>
+    void store_row(const glm::uvec3& start, uint32_t count, const T* values);
 
     glm::vec4  load(glm::uvec3 pixel) const;
     glm::vec4  load_bilinear(const glm::vec3& pixel) const;
@@ -135,8 +256,9 @@ public:
 
     using available_types = std::variant<float, int32_t, uint32_t, glm::vec4, glm::ivec4, glm::uvec4, host_image>;
     template<typename T>
-    using enable_if_available = decltype(std::get<std::decay_t<T>>(std::declval<available_types>()));
+    using enable_if_available = std::enable_if_t<is_image_operand_v<std::decay_t<T>>>;
 
+    // The results are computed immediately. Chains like lazy(a) * 2.f + b are evaluated in a single pass instead.
     template<typename T, typename = enable_if_available<T>>
     host_image operator+(const T& value) const;
     template<typename T, typename = enable_if_available<T>>
@@ -157,31 +279,46 @@ public:
     bool operator==(const host_image& image) const;
     bool operator!=(const host_image& image) const;
 
+    // Separable filters are applied as one pass per axis, all others per pixel. The into image must have the same
+    // extents and may be this image.
     void convolute(const image_filter& f);
     void convolute(const image_filter& f, host_image& into) const;
+    // Convolutes with all three filters in sequence, like the ones returned by image_filter::gauss_separable.
+    void convolute(const std::tuple<image_filter, image_filter, image_filter>& filters);
+    void convolute(const std::tuple<image_filter, image_filter, image_filter>& filters, host_image& into) const;
 
 private:
-    template<typename OpFun>
-    host_image& operator_apply(host_image& store_target, const host_image& image, OpFun&& fun) const;
-    template<typename Scalar, typename OpFun, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Scalar>, host_image>>>
-    host_image& operator_apply(host_image& store_target, Scalar image, OpFun&& fun) const;
-    template<typename T, typename OpFun>
-    host_image operator_nonapply(const T& val, OpFun&& fun) const
-    {
-        host_image img(pixel_format(), _extent);
-        operator_apply(img, val, std::forward<OpFun&&>(fun));
-        return img;
-    }
+    template<typename Expression>
+    void evaluate(const Expression& expression);
+
+    template<typename Kernel, typename Fun>
+    void visit_rows(Fun&& fun);
+    template<typename Kernel, typename Fun>
+    void visit_rows(Fun&& fun) const;
+    template<typename T>
+    void update_normalized(data_format fmt, const T* data);
+    template<typename T>
+    bool update_tiled(data_format fmt, const T* data);
 
-    std::function<void(const glm::vec4&, int64_t i)> get_write_unorm_fun();
+    // The index of a pixel in the storage.
+    size_t pixel_index(const glm::uvec3& pixel) const noexcept;
+    // Splits count pixels of the row containing start into runs which are consecutive in the storage and calls
+    // fun(index, offset, length) for each run, with offset counting from start.
+    template<typename Fun>
+    void for_each_run(const glm::uvec3& start, uint32_t count, Fun&& fun) const;
 
-    format                                             _format;
-    extent                                             _extent;
-    size_t                                             _storage_element_size;
-    host_buffer<std::byte>                             _storage;
-    std::function<void(const glm::vec4& v, int64_t i)> _write_unorm;
+    format                 _format;
+    extent                 _extent;
+    image_layout           _layout;
+    glm::uvec3             _tile_shift;
+    extent                 _tiles;
+    size_t                 _storage_element_size;
+    host_buffer<std::byte> _storage;
 };
 }    // namespace v1
 }    // namespace gfx
 
-#include "host_image.inl"
\ No newline at end of file
+#include "parallel_rows.hpp"
+#include "host_image.inl"
+#include "host_image_expression.hpp"
+#include "host_image_view.hpp"
\ No newline at end of file
@@ -55,89 +55,193 @@ constexpr glm::ivec3 extent::wrap(const glm::ivec3 pixel) const noexcept
 #pragma warning(push)
 #pragma warning(disable : 4244)
 
-template<typename OpFun>
-host_image& host_image::operator_apply(host_image& store_target, const host_image& image, OpFun&& fun) const
-{
-    const std::function<void(const glm::uvec3&)> store_fun = [&]() -> std::function<void(const glm::uvec3&)> {
-        if (is_unsigned(_format))
-            return [&](const auto& pixel) { store_target.storeu(pixel, fun(loadu(pixel), image.loadu(image.extents().wrap(pixel)))); };
-        else if (is_signed(_format))
-            return [&](const auto& pixel) { store_target.storei(pixel, fun(loadi(pixel), image.loadi(image.extents().wrap(pixel)))); };
-        else
-            return [&](const auto& pixel) { store_target.store(pixel, fun(load(pixel), image.load(image.extents().wrap(pixel)))); };
-    }();
-#pragma omp parallel for schedule(static)
-    for (auto p = 0; p < _extent.count(); ++p) {
-        const auto pixel = _extent.subpixel(p);
-        store_fun(pixel);
-    }
-    return store_target;
+inline size_t host_image::pixel_index(const glm::uvec3& pixel) const noexcept
+{
+    if (_layout == image_layout::linear) return _extent.linear(pixel);
+
+    const uint32_t sx   = _tile_shift.x;
+    const uint32_t sy   = _tile_shift.y;
+    const uint32_t sz   = _tile_shift.z;
+    const size_t   tile = (size_t(pixel.z >> sz) * _tiles.height + (pixel.y >> sy)) * _tiles.width + (pixel.x >> sx);
+    const size_t   x    = pixel.x & ((1u << sx) - 1);
+    const size_t   y    = pixel.y & ((1u << sy) - 1);
+    const size_t   z    = pixel.z & ((1u << sz) - 1);
+    return (tile << (sx + sy + sz)) | (z << (sx + sy)) | (y << sx) | x;
 }
 
-template<typename Scalar, typename OpFun, typename>
-host_image& host_image::operator_apply(host_image& store_target, Scalar image, OpFun&& fun) const
+template<typename Fun>
+void host_image::for_each_run(const glm::uvec3& start, const uint32_t count, Fun&& fun) const
 {
-    const std::function<void(const glm::uvec3&)> store_fun = [&]() -> std::function<void(const glm::uvec3&)> {
-        if (is_unsigned(_format))
-            return [&](const auto& pixel) { store_target.storeu(pixel, fun(loadu(pixel), glm::uvec4(image))); };
-        else if (is_signed(_format))
-            return [&](const auto& pixel) { store_target.storei(pixel, fun(loadi(pixel), glm::ivec4(image))); };
-        else
-            return [&](const auto& pixel) { store_target.store(pixel, fun(load(pixel), glm::vec4(image))); };
-    }();
-#pragma omp parallel for schedule(static)
-    for (auto p = 0; p < _extent.count(); ++p) {
-        const auto pixel = _extent.subpixel(p);
-        store_fun(pixel);
+    if (_layout == image_layout::linear) {
+        fun(pixel_index(start), 0u, count);
+        return;
+    }
+
+    const uint32_t tile_width = 1u << _tile_shift.x;
+    for (uint32_t offset = 0; offset < count;) {
+        const glm::uvec3 pixel(start.x + offset, start.y, start.z);
+        const uint32_t   length = std::min(count - offset, tile_width - (pixel.x & (tile_width - 1)));
+        fun(pixel_index(pixel), offset, length);
+        offset += length;
+    }
+}
+
+template<typename Kernel, typename Fun>
+void host_image::visit_rows(Fun&& fun)
+{
+    for (uint32_t z = 0; z < _extent.depth; ++z) {
+        for (uint32_t y = 0; y < _extent.height; ++y) {
+            for_each_run({0, y, z}, _extent.width, [&](const size_t index, const uint32_t offset, const uint32_t length) {
+                std::byte* run = _storage.data() + Kernel::size * index;
+                for (uint32_t x = offset; x < offset + length; ++x, run += Kernel::size) {
+                    auto value = Kernel::load(run);
+                    fun(glm::uvec3(x, y, z), value);
+                    Kernel::store(run, value);
+                }
+            });
+        }
     }
-    return store_target;
 }
 
-inline const auto op_add = [](const auto& a, const auto& b) { return a + b; };
-inline const auto op_sub = [](const auto& a, const auto& b) { return a - b; };
-inline const auto op_mul = [](const auto& a, const auto& b) { return a * b; };
-inline const auto op_div = [](const auto& a, const auto& b) { return a / b; };
+template<typename Kernel, typename Fun>
+void host_image::visit_rows(Fun&& fun) const
+{
+    for (uint32_t z = 0; z < _extent.depth; ++z) {
+        for (uint32_t y = 0; y < _extent.height; ++y) {
+            for_each_run({0, y, z}, _extent.width, [&](const size_t index, const uint32_t offset, const uint32_t length) {
+                const std::byte* run = _storage.data() + Kernel::size * index;
+                for (uint32_t x = offset; x < offset + length; ++x, run += Kernel::size) {
+                    const auto value = Kernel::load(run);
+                    fun(glm::uvec3(x, y, z), value);
+                }
+            });
+        }
+    }
+}
 
-template<typename T, typename>
-host_image host_image::operator+(const T& value) const
+template<typename Fun>
+void host_image::visit_pixels(Fun&& fun)
 {
-    return operator_nonapply(value, op_add);
+    if (!dispatch_format(_format, [&](auto kernel) { visit_rows<decltype(kernel)>(fun); }))
+        throw std::invalid_argument("Cannot visit the pixels of an image without a pixel kernel.");
 }
-template<typename T, typename>
-host_image host_image::operator-(const T& value) const
+
+template<typename Fun>
+void host_image::visit_pixels(Fun&& fun) const
 {
-    return operator_nonapply(value, op_sub);
+    if (!dispatch_format(_format, [&](auto kernel) { visit_rows<decltype(kernel)>(fun); }))
+        throw std::invalid_argument("Cannot visit the pixels of an image without a pixel kernel.");
 }
-template<typename T, typename>
-host_image host_image::operator*(const T& value) const
+
+template<format Format, typename Fun>
+void host_image::visit_pixels(Fun&& fun)
 {
-    return operator_nonapply(value, op_mul);
+    assert(_format == Format);
+    visit_rows<pixel_kernel<Format>>(fun);
 }
-template<typename T, typename>
-host_image host_image::operator/(const T& value) const
+
+template<format Format, typename Fun>
+void host_image::visit_pixels(Fun&& fun) const
 {
-    return operator_nonapply(value, op_div);
+    assert(_format == Format);
+    visit_rows<pixel_kernel<Format>>(fun);
+}
+
+template<typename Fun, typename>
+void host_image::each_pixel(const execution_policy policy, Fun&& f) const
+{
+    each_row(policy, [&](glm::uvec3 pixel, const uint32_t width) {
+        if (policy == execution_policy::parallel_vectorized) {
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+            for (uint32_t x = 0; x < width; ++x) f(glm::uvec3(x, pixel.y, pixel.z));
+        } else {
+            for (; pixel.x < width; ++pixel.x) f(pixel);
+        }
+    });
 }
-template<typename T, typename>
-host_image& host_image::operator+=(const T& value)
+
+template<typename Fun>
+void host_image::each_row(const execution_policy policy, Fun&& f) const
 {
-    return operator_apply(*this, value, op_add);
+    if (policy == execution_policy::sequential) {
+        for (uint32_t z = 0; z < _extent.depth; ++z)
+            for (uint32_t y = 0; y < _extent.height; ++y) f(glm::uvec3(0, y, z), _extent.width);
+        return;
+    }
+
+    const int64_t rows = int64_t(_extent.height) * _extent.depth;
+#pragma omp parallel for schedule(static)
+    for (int64_t r = 0; r < rows; ++r) f(glm::uvec3(0, uint32_t(r % _extent.height), uint32_t(r / _extent.height)), _extent.width);
 }
-template<typename T, typename>
-host_image& host_image::operator-=(const T& value)
+
+template<typename State, typename Fun, typename Combine>
+State host_image::reduce_pixels(const execution_policy policy, State init, Fun&& f, Combine&& combine) const
 {
-    return operator_apply(*this, value, op_sub);
+    return reduce_rows(
+            policy, std::move(init),
+            [&](State& state, glm::uvec3 pixel, const uint32_t width) {
+                for (; pixel.x < width; ++pixel.x) f(state, pixel);
+            },
+            combine);
 }
-template<typename T, typename>
-host_image& host_image::operator*=(const T& value)
+
+template<typename State, typename Fun, typename Combine>
+State host_image::reduce_rows(const execution_policy policy, State init, Fun&& f, Combine&& combine) const
 {
-    return operator_apply(*this, value, op_mul);
+    if (policy == execution_policy::sequential) {
+        for (uint32_t z = 0; z < _extent.depth; ++z)
+            for (uint32_t y = 0; y < _extent.height; ++y) f(init, glm::uvec3(0, y, z), _extent.width);
+        return init;
+    }
+
+    return detail::reduce_rows<std::byte>(
+            _extent, 0, std::move(init),
+            [&](State& state, const glm::uvec3& start, std::byte*) { f(state, start, _extent.width); }, combine);
 }
-template<typename T, typename>
-host_image& host_image::operator/=(const T& value)
+
+template<typename Lhs, typename Rhs, typename Op>
+host_image::host_image(const image_expression<Lhs, Rhs, Op>& expression) : host_image(expression.pixel_format(), expression.extents())
 {
-    return operator_apply(*this, value, op_div);
+    evaluate(expression);
 }
+
+template<typename Lhs, typename Rhs, typename Op>
+host_image& host_image::operator=(const image_expression<Lhs, Rhs, Op>& expression)
+{
+    if (_format == expression.pixel_format() && _extent == expression.extents())
+        evaluate(expression);
+    else
+        *this = host_image(expression);
+    return *this;
+}
+
+template<typename Expression>
+void host_image::evaluate(const Expression& expression)
+{
+    const auto apply = [&](auto type) {
+        using value_type = decltype(type);
+        if (!has_value_type<value_type>(_format) || !expression.template accepts<value_type>())
+            throw std::invalid_argument("Cannot combine images with incompatible pixel formats.");
+
+        // Each row is computed completely before it is stored, so this image may also be an operand.
+        const size_t row_size = _extent.width;
+        detail::parallel_rows<value_type>(_extent, (1 + Expression::scratch_rows) * row_size,
+                                          [&](const glm::uvec3& start, value_type* values) {
+                                              expression.load_row(start, _extent.width, values, values + row_size);
+                                              store_row(start, _extent.width, values);
+                                          });
+    };
+
+    if (is_unsigned(_format))
+        apply(glm::uvec4());
+    else if (is_signed(_format))
+        apply(glm::ivec4());
+    else
+        apply(glm::vec4());
+}
+
 #pragma warning(pop)
 }    // namespace v1
 }    // namespace gfx
\ No newline at end of file
@@ -0,0 +1,233 @@
+#pragma once
+
+namespace gfx {
+inline namespace v1 {
+// An image whose arithmetic operators build a lazy image_expression instead of a new image. The image is referenced,
+// not copied. Images smaller than the expression are repeated.
+class lazy_image
+{
+public:
+    constexpr static bool   is_scalar    = false;
+    constexpr static size_t scratch_rows = 1;
+
+    explicit lazy_image(const host_image& image) : _image(&image) {}
+
+    format        pixel_format() const noexcept { return _image->pixel_format(); }
+    const extent& extents() const noexcept { return _image->extents(); }
+
+    template<typename T>
+    bool accepts() const
+    {
+        return has_value_type<T>(_image->pixel_format());
+    }
+
+    template<typename T>
+    void load_row(const glm::uvec3& start, const uint32_t count, T* values, T* scratch) const
+    {
+        const extent& size = _image->extents();
+        if (size.width >= count) {
+            _image->load_row(size.wrap(start), count, values);
+            return;
+        }
+        _image->load_row(size.wrap(start), size.width, scratch);
+        for (uint32_t x = 0; x < count; ++x) values[x] = scratch[x % size.width];
+    }
+
+private:
+    const host_image* _image;
+};
+
+// Starts a lazy expression, like (lazy(a) - mean) * scale + b, which is computed in a single pass when it is assigned to
+// or converted into a host_image. The operators of host_image itself return images.
+inline lazy_image lazy(const host_image& image)
+{
+    return lazy_image(image);
+}
+
+namespace detail {
+template<typename Scalar>
+class scalar_operand
+{
+public:
+    constexpr static bool   is_scalar    = true;
+    constexpr static size_t scratch_rows = 0;
+
+    explicit scalar_operand(const Scalar& value) : _value(value) {}
+
+    template<typename T>
+    bool accepts() const
+    {
+        return true;
+    }
+
+    template<typename T>
+    T value() const
+    {
+        return T(_value);
+    }
+
+private:
+    Scalar _value;
+};
+
+template<typename T>
+auto as_operand(const T& value)
+{
+    if constexpr (std::is_same_v<T, host_image>)
+        return lazy_image(value);
+    else if constexpr (is_image_expression_v<T>)
+        return value;
+    else
+        return scalar_operand<T>(value);
+}
+
+struct image_add
+{
+    template<typename A, typename B>
+    auto operator()(const A& a, const B& b) const
+    {
+        return a + b;
+    }
+};
+struct image_sub
+{
+    template<typename A, typename B>
+    auto operator()(const A& a, const B& b) const
+    {
+        return a - b;
+    }
+};
+struct image_mul
+{
+    template<typename A, typename B>
+    auto operator()(const A& a, const B& b) const
+    {
+        return a * b;
+    }
+};
+struct image_div
+{
+    template<typename A, typename B>
+    auto operator()(const A& a, const B& b) const
+    {
+        return a / b;
+    }
+};
+}    // namespace detail
+
+// A lazily evaluated operation on images and scalars, started with lazy(image). Images are referenced, not copied, so
+// an expression must not outlive its operands. The result has the format and extents of the leftmost image and is computed row by row in a
+// single parallel pass when it is assigned to or converted into a host_image.
+template<typename Lhs, typename Rhs, typename Op>
+class image_expression
+{
+public:
+    constexpr static bool   is_scalar    = false;
+    constexpr static size_t scratch_rows = std::max(Lhs::scratch_rows, Rhs::is_scalar ? size_t(0) : 1 + Rhs::scratch_rows);
+
+    image_expression(Lhs lhs, Rhs rhs, Op op) : _lhs(std::move(lhs)), _rhs(std::move(rhs)), _op(op) {}
+
+    format        pixel_format() const noexcept { return _lhs.pixel_format(); }
+    const extent& extents() const noexcept { return _lhs.extents(); }
+
+    template<typename T>
+    bool accepts() const
+    {
+        return _lhs.template accepts<T>() && _rhs.template accepts<T>();
+    }
+
+    // Computes count values of the row containing start. The scratch buffer holds scratch_rows rows of count values.
+    template<typename T>
+    void load_row(const glm::uvec3& start, const uint32_t count, T* values, T* scratch) const
+    {
+        _lhs.load_row(start, count, values, scratch);
+        if constexpr (Rhs::is_scalar) {
+            const T operand = _rhs.template value<T>();
+            for (uint32_t x = 0; x < count; ++x) values[x] = T(_op(values[x], operand));
+        } else {
+            _rhs.load_row(start, count, scratch, scratch + count);
+            for (uint32_t x = 0; x < count; ++x) values[x] = T(_op(values[x], scratch[x]));
+        }
+    }
+
+private:
+    Lhs _lhs;
+    Rhs _rhs;
+    Op  _op;
+};
+
+template<typename Lhs, typename Rhs, typename Op>
+auto make_image_expression(const Lhs& lhs, const Rhs& rhs, Op op)
+{
+    using lhs_operand = decltype(detail::as_operand(lhs));
+    using rhs_operand = decltype(detail::as_operand(rhs));
+    return image_expression<lhs_operand, rhs_operand, Op>(detail::as_operand(lhs), detail::as_operand(rhs), op);
+}
+
+template<typename Lhs, typename Rhs, typename = std::enable_if_t<is_image_expression_v<Lhs> && is_image_operand_v<Rhs>>>
+auto operator+(const Lhs& lhs, const Rhs& rhs)
+{
+    return make_image_expression(lhs, rhs, detail::image_add{});
+}
+template<typename Lhs, typename Rhs, typename = std::enable_if_t<is_image_expression_v<Lhs> && is_image_operand_v<Rhs>>>
+auto operator-(const Lhs& lhs, const Rhs& rhs)
+{
+    return make_image_expression(lhs, rhs, detail::image_sub{});
+}
+template<typename Lhs, typename Rhs, typename = std::enable_if_t<is_image_expression_v<Lhs> && is_image_operand_v<Rhs>>>
+auto operator*(const Lhs& lhs, const Rhs& rhs)
+{
+    return make_image_expression(lhs, rhs, detail::image_mul{});
+}
+template<typename Lhs, typename Rhs, typename = std::enable_if_t<is_image_expression_v<Lhs> && is_image_operand_v<Rhs>>>
+auto operator/(const Lhs& lhs, const Rhs& rhs)
+{
+    return make_image_expression(lhs, rhs, detail::image_div{});
+}
+
+template<typename T, typename>
+host_image host_image::operator+(const T& value) const
+{
+    return host_image(make_image_expression(*this, value, detail::image_add{}));
+}
+template<typename T, typename>
+host_image host_image::operator-(const T& value) const
+{
+    return host_image(make_image_expression(*this, value, detail::image_sub{}));
+}
+template<typename T, typename>
+host_image host_image::operator*(const T& value) const
+{
+    return host_image(make_image_expression(*this, value, detail::image_mul{}));
+}
+template<typename T, typename>
+host_image host_image::operator/(const T& value) const
+{
+    return host_image(make_image_expression(*this, value, detail::image_div{}));
+}
+template<typename T, typename>
+host_image& host_image::operator+=(const T& value)
+{
+    evaluate(make_image_expression(*this, value, detail::image_add{}));
+    return *this;
+}
+template<typename T, typename>
+host_image& host_image::operator-=(const T& value)
+{
+    evaluate(make_image_expression(*this, value, detail::image_sub{}));
+    return *this;
+}
+template<typename T, typename>
+host_image& host_image::operator*=(const T& value)
+{
+    evaluate(make_image_expression(*this, value, detail::image_mul{}));
+    return *this;
+}
+template<typename T, typename>
+host_image& host_image::operator/=(const T& value)
+{
+    evaluate(make_image_expression(*this, value, detail::image_div{}));
+    return *this;
+}
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,57 @@
+#include "host_image_pyramid.hpp"
+#include "image_resampling.hpp"
+
+namespace gfx {
+inline namespace v1 {
+host_image_pyramid::host_image_pyramid(const host_image& base, const mip_filter filter, const color_space space, const uint32_t levels)
+{
+    if (!has_value_type<glm::vec4>(base.pixel_format()))
+        throw std::invalid_argument("Mip chains can only be computed for normalized and floating-point formats.");
+
+    const uint32_t level_count = std::clamp(levels, 1u, base.max_levels());
+    _levels.reserve(level_count);
+    // All levels are linear so that they can be uploaded to a device image.
+    _levels.push_back(base.layout() == image_layout::linear ? base : base.with_layout(image_layout::linear));
+
+    // Every level is filtered from the unquantized values of the previous one.
+    extent                 size    = base.extents();
+    std::vector<glm::vec4> current = detail::unpack_pixels(base, space);
+    std::vector<glm::vec4> scratch;
+    for (uint32_t level = 1; level < level_count; ++level) {
+        const extent next_size(std::max(size.width >> 1, 1u), std::max(size.height >> 1, 1u), std::max(size.depth >> 1, 1u));
+        detail::resample_pixels(current, size, next_size, filter, scratch);
+        detail::pack_pixels(current, space, _levels.emplace_back(base.pixel_format(), size));
+    }
+}
+
+uint32_t host_image_pyramid::levels() const noexcept
+{
+    return static_cast<uint32_t>(_levels.size());
+}
+
+format host_image_pyramid::pixel_format() const noexcept
+{
+    return _levels.front().pixel_format();
+}
+
+const extent& host_image_pyramid::extents() const noexcept
+{
+    return _levels.front().extents();
+}
+
+host_image& host_image_pyramid::level(const uint32_t level)
+{
+    return _levels[level];
+}
+
+const host_image& host_image_pyramid::level(const uint32_t level) const
+{
+    return _levels[level];
+}
+
+const host_image& host_image_pyramid::operator[](const uint32_t level) const
+{
+    return _levels[level];
+}
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,31 @@
+#pragma once
+#include "host_image.hpp"
+#include <vector>
+
+namespace gfx {
+inline namespace v1 {
+using mip_filter = resample_filter;
+
+// The mip chain of an image computed on the CPU. Every level halves the extents of the previous one down to one pixel,
+// including the depth of 3D images, and is filtered from an unquantized copy of the previous level.
+class host_image_pyramid
+{
+public:
+    constexpr static uint32_t max_levels = ~0u;
+
+    host_image_pyramid(const host_image& base, mip_filter filter = mip_filter::box, color_space space = color_space::linear,
+                       uint32_t levels = max_levels);
+
+    uint32_t      levels() const noexcept;
+    format        pixel_format() const noexcept;
+    const extent& extents() const noexcept;
+
+    host_image&       level(uint32_t level);
+    const host_image& level(uint32_t level) const;
+    const host_image& operator[](uint32_t level) const;
+
+private:
+    std::vector<host_image> _levels;
+};
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,194 @@
+#include "host_image_view.hpp"
+#include "image_resampling.hpp"
+#include "pixel_conversion.hpp"
+
+namespace gfx {
+inline namespace v1 {
+namespace {
+format file_format(const bits channel_bits, const uint16_t channels)
+{
+    constexpr std::array<format, 4> unorm8{r8unorm, rg8unorm, rgb8unorm, rgba8unorm};
+    constexpr std::array<format, 4> unorm16{r16unorm, rg16unorm, rgb16unorm, rgba16unorm};
+    constexpr std::array<format, 4> float32{r32f, rg32f, rgb32f, rgba32f};
+    if (channels < 1 || channels > 4) throw std::invalid_argument("Image files have one to four channels.");
+
+    switch (channel_bits)
+    {
+    case bits::b8: return unorm8[channels - 1];
+    case bits::b16: return unorm16[channels - 1];
+    default: return float32[channels - 1];
+    }
+}
+}    // namespace
+
+host_image_view::host_image_view(const format fmt, const extent& size, const void* data, const size_t row_stride,
+                                 const size_t slice_stride)
+      : _format(fmt)
+      , _extent(size)
+      , _data(static_cast<const std::byte*>(data))
+      , _element_size(format_element_size(fmt))
+      , _row_stride(row_stride == 0 ? _element_size * size.width : row_stride)
+      , _slice_stride(slice_stride == 0 ? _row_stride * size.height : slice_stride)
+{
+    if (is_block_compressed(fmt)) throw std::invalid_argument("Block-compressed formats are stored in compressed images.");
+    if (_row_stride < _element_size * size.width || _slice_stride < _row_stride * size.height)
+        throw std::invalid_argument("The strides of an image view are too small for its extents.");
+}
+
+host_image_view::host_image_view(const host_image& image)
+      : host_image_view(image.pixel_format(), image.extents(), image.storage().data())
+{
+    if (image.layout() != image_layout::linear) throw std::invalid_argument("Only images with a linear layout can be viewed.");
+}
+
+host_image_view::host_image_view(const image_file& file)
+      : host_image_view(file_format(file.channel_bits, file.channels), extent(file.width, file.height), file.bytes())
+{}
+
+host_image_view::host_image_view(const image_file::decoded& file)
+      : host_image_view(file_format(file.channel_bits, file.channels), extent(file.width, file.height), file.pixels.get())
+{}
+
+host_image_view host_image_view::subview(const glm::uvec3& offset, const extent& size) const
+{
+    if (offset.x + size.width > _extent.width || offset.y + size.height > _extent.height || offset.z + size.depth > _extent.depth)
+        throw std::invalid_argument("A subview has to lie within the extents of the view.");
+    return host_image_view(_format, size, row(offset) + _element_size * offset.x, _row_stride, _slice_stride);
+}
+
+host_image host_image_view::converted(const format fmt) const
+{
+    host_image   n(fmt, _extent);
+    const size_t n_element_size = format_element_size(fmt);
+    const auto   n_row          = [&](const glm::uvec3& start) { return n.storage().data() + n_element_size * _extent.linear(start); };
+    if (fmt == _format) {
+        detail::parallel_rows<std::byte>(_extent, 0, [&](const glm::uvec3& start, std::byte*) {
+            memcpy(n_row(start), row(start), _element_size * _extent.width);
+        });
+        return n;
+    }
+
+    if (const auto fast_convert = find_pixel_conversion(_format, fmt)) {
+        detail::parallel_rows<std::byte>(_extent, 0, [&](const glm::uvec3& start, std::byte*) {
+            fast_convert(row(start), n_row(start), _extent.width);
+        });
+        return n;
+    }
+
+    const auto convert = [&](auto type) {
+        using value_type = decltype(type);
+        if (!has_value_type<value_type>(_format) || !has_value_type<value_type>(fmt))
+            throw std::invalid_argument("Cannot convert between pixel formats of different types.");
+
+        detail::parallel_rows<value_type>(_extent, _extent.width, [&](const glm::uvec3& start, value_type* values) {
+            load_row(start, _extent.width, values);
+            n.store_row(start, _extent.width, values);
+        });
+    };
+
+    if (is_unsigned(_format))
+        convert(glm::uvec4());
+    else if (is_signed(_format))
+        convert(glm::ivec4());
+    else
+        convert(glm::vec4());
+    return n;
+}
+
+host_image host_image_view::resized(const extent& size, const resample_filter filter, const color_space space) const
+{
+    return detail::resized_image(*this, size, filter, space, image_layout::linear);
+}
+
+void host_image_view::convolute(const image_filter& f, host_image& into) const
+{
+    assert(is_unorm_compatible(_format));
+    assert(into.extents() == _extent);
+    std::vector<glm::vec4> pixels = detail::unpack_pixels(*this, color_space::linear);
+    detail::convolute_pixels(pixels, _extent, f, into);
+}
+
+void host_image_view::convolute(const std::tuple<image_filter, image_filter, image_filter>& filters, host_image& into) const
+{
+    assert(into.extents() == _extent);
+    std::vector<glm::vec4> pixels = detail::unpack_pixels(*this, color_space::linear);
+    detail::convolute_pixels(pixels, _extent, filters, into);
+}
+
+template<typename T>
+void host_image_view::load_row(const glm::uvec3& start, const uint32_t count, T* values) const
+{
+    const bool has_kernel = dispatch_format(_format, [&](auto kernel) {
+        using kernel_type = decltype(kernel);
+        if constexpr (std::is_same_v<typename kernel_type::value_type, T>) {
+            const std::byte* run = row(start) + kernel_type::size * start.x;
+            for (uint32_t i = 0; i < count; ++i) values[i] = kernel_type::load(run + i * kernel_type::size);
+        } else {
+            throw std::invalid_argument("Cannot load pixels of this format with the given value type.");
+        }
+    });
+    if (!has_kernel) throw std::invalid_argument("Cannot load pixels of a format without a pixel kernel.");
+}
+
+template void host_image_view::load_row(const glm::uvec3& start, uint32_t count, glm::vec4* values) const;
+template void host_image_view::load_row(const glm::uvec3& start, uint32_t count, glm::uvec4* values) const;
+template void host_image_view::load_row(const glm::uvec3& start, uint32_t count, glm::ivec4* values) const;
+
+glm::vec4 host_image_view::load(glm::uvec3 pixel) const
+{
+    pixel = _extent.clamp(pixel);
+    glm::vec4 value;
+    load_row(pixel, 1, &value);
+    return value;
+}
+
+glm::uvec4 host_image_view::loadu(const glm::uvec3& pixel) const
+{
+    glm::uvec4 value;
+    load_row(pixel, 1, &value);
+    return value;
+}
+
+glm::ivec4 host_image_view::loadi(const glm::uvec3& pixel) const
+{
+    glm::ivec4 value;
+    load_row(pixel, 1, &value);
+    return value;
+}
+
+const std::byte* host_image_view::row(const glm::uvec3& start) const noexcept
+{
+    return _data + _slice_stride * start.z + _row_stride * start.y;
+}
+
+const std::byte* host_image_view::data() const noexcept
+{
+    return _data;
+}
+
+size_t host_image_view::row_stride() const noexcept
+{
+    return _row_stride;
+}
+
+size_t host_image_view::slice_stride() const noexcept
+{
+    return _slice_stride;
+}
+
+bool host_image_view::is_contiguous() const noexcept
+{
+    return _row_stride == _element_size * _extent.width && (_extent.depth == 1 || _slice_stride == _row_stride * _extent.height);
+}
+
+const extent& host_image_view::extents() const noexcept
+{
+    return _extent;
+}
+
+format host_image_view::pixel_format() const noexcept
+{
+    return _format;
+}
+}    // namespace v1
+}    // namespace gfx
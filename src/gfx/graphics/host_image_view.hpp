@@ -0,0 +1,58 @@
+#pragma once
+#include "host_image.hpp"
+
+namespace gfx {
+inline namespace v1 {
+// A read-only view of linear pixels in memory owned by something else, like the storage of a host image, the pixels of
+// an image file or a host buffer. Rows are row_stride bytes and slices slice_stride bytes apart, so a view can also
+// cover a sub-rectangle of a larger image. The memory has to outlive the view, and views are cheap to copy.
+class host_image_view
+{
+public:
+    // Strides of zero stand for tightly packed rows and slices.
+    host_image_view(format fmt, const extent& size, const void* data, size_t row_stride = 0, size_t slice_stride = 0);
+    // Views the storage of an image with a linear layout.
+    host_image_view(const host_image& image);
+    // Views the pixels of a file as r, rg, rgb or rgba pixels of 8 or 16 bit unorm or 32 bit float channels.
+    explicit host_image_view(const image_file& file);
+    explicit host_image_view(const image_file::decoded& file);
+
+    // The pixels from offset to offset + size.
+    host_image_view subview(const glm::uvec3& offset, const extent& size) const;
+
+    // These copy the pixels once, into an image with a linear layout.
+    host_image converted(format fmt) const;
+    host_image resized(const extent& size, resample_filter filter = resample_filter::mitchell,
+                       color_space space = color_space::linear) const;
+    void       convolute(const image_filter& f, host_image& into) const;
+    void       convolute(const std::tuple<image_filter, image_filter, image_filter>& filters, host_image& into) const;
+
+    // Like host_image::load_row.
+    template<typename T>
+    void load_row(const glm::uvec3& start, uint32_t count, T* values) const;
+
+    glm::vec4  load(glm::uvec3 pixel) const;
+    glm::uvec4 loadu(const glm::uvec3& pixel) const;
+    glm::ivec4 loadi(const glm::uvec3& pixel) const;
+
+    // The first pixel of the row containing start.
+    const std::byte* row(const glm::uvec3& start) const noexcept;
+    const std::byte* data() const noexcept;
+    size_t           row_stride() const noexcept;
+    size_t           slice_stride() const noexcept;
+    // Whether all pixels are consecutive in memory, like in the storage of a linear image.
+    bool             is_contiguous() const noexcept;
+
+    const extent& extents() const noexcept;
+    format        pixel_format() const noexcept;
+
+private:
+    format           _format;
+    extent           _extent;
+    const std::byte* _data;
+    size_t           _element_size;
+    size_t           _row_stride;
+    size_t           _slice_stride;
+};
+}    // namespace v1
+}    // namespace gfx
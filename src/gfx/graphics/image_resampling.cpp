@@ -0,0 +1,331 @@
+#include "image_resampling.hpp"
+#include "pixel_conversion.hpp"
+
+namespace gfx {
+inline namespace v1 {
+namespace detail {
+namespace {
+constexpr float pi = 3.14159265358979f;
+
+float sinc(float x)
+{
+    if (std::abs(x) < 1e-6f) return 1.f;
+    x *= pi;
+    return std::sin(x) / x;
+}
+
+// Modified Bessel function of the first kind and order zero.
+float bessel_i0(const float x)
+{
+    float sum  = 1.f;
+    float term = 1.f;
+    for (int k = 1; term > 1e-7f * sum; ++k) {
+        const float f = x / (2.f * k);
+        term *= f * f;
+        sum += term;
+    }
+    return sum;
+}
+
+float filter_radius(const resample_filter filter)
+{
+    switch (filter)
+    {
+    case resample_filter::box: return 0.5f;
+    case resample_filter::triangle: return 1.f;
+    case resample_filter::mitchell: return 2.f;
+    default: return 3.f;
+    }
+}
+
+float filter_weight(const resample_filter filter, const float x)
+{
+    const float a = std::abs(x);
+    switch (filter)
+    {
+    case resample_filter::box: return a < 0.5f ? 1.f : (a == 0.5f ? 0.5f : 0.f);
+    case resample_filter::triangle: return std::max(1.f - a, 0.f);
+    case resample_filter::mitchell:
+        if (a < 1.f) return (7.f * a * a * a - 12.f * a * a + 16.f / 3.f) / 6.f;
+        if (a < 2.f) return (-7.f / 3.f * a * a * a + 12.f * a * a - 20.f * a + 32.f / 3.f) / 6.f;
+        return 0.f;
+    case resample_filter::kaiser:
+    {
+        constexpr float alpha = 4.f;
+        const float     t     = x / 3.f;
+        return std::abs(t) < 1.f ? sinc(x) * bessel_i0(alpha * std::sqrt(1.f - t * t)) / bessel_i0(alpha) : 0.f;
+    }
+    case resample_filter::lanczos: return a < 3.f ? sinc(x) * sinc(x / 3.f) : 0.f;
+    }
+    return 0.f;
+}
+
+// The same number of taps for every destination pixel along one axis. Source indices are clamped when the taps are
+// built, so the resampling passes need no border handling.
+struct axis_taps
+{
+    uint32_t              count = 0;
+    std::vector<uint32_t> index;
+    std::vector<float>    weight;
+};
+
+axis_taps make_taps(const resample_filter filter, const uint32_t src, const uint32_t dst)
+{
+    // The filter is stretched over the source pixels covered by one destination pixel when shrinking, and
+    // interpolates between source pixels when enlarging.
+    const float scale   = float(src) / float(dst);
+    const float support = std::max(scale, 1.f);
+    const float radius  = filter_radius(filter) * support;
+
+    axis_taps taps;
+    taps.count = uint32_t(std::ceil(2.f * radius)) + 1;
+    taps.index.resize(size_t(dst) * taps.count);
+    taps.weight.resize(size_t(dst) * taps.count);
+    for (uint32_t i = 0; i < dst; ++i) {
+        const float center = (i + 0.5f) * scale - 0.5f;
+        const auto  first  = int64_t(std::floor(center - radius));
+        float       sum    = 0.f;
+        for (uint32_t t = 0; t < taps.count; ++t) {
+            const int64_t p                  = first + t;
+            const float   w                  = filter_weight(filter, (p - center) / support);
+            taps.index[i * taps.count + t]  = uint32_t(std::clamp<int64_t>(p, 0, int64_t(src) - 1));
+            taps.weight[i * taps.count + t] = w;
+            sum += w;
+        }
+        if (sum != 0.f)
+            for (uint32_t t = 0; t < taps.count; ++t) taps.weight[i * taps.count + t] /= sum;
+    }
+    return taps;
+}
+
+void resample_row(const axis_taps& taps, const uint32_t width, const glm::vec4* in, glm::vec4* out)
+{
+    for (uint32_t x = 0; x < width; ++x) {
+        glm::vec4 sum{0};
+        for (uint32_t t = 0; t < taps.count; ++t) sum += in[taps.index[x * taps.count + t]] * taps.weight[x * taps.count + t];
+        out[x] = sum;
+    }
+}
+
+void resample_x(const extent& src_size, const extent& dst_size, const axis_taps& taps, const glm::vec4* src, glm::vec4* dst)
+{
+    parallel_rows<glm::vec4>(dst_size, 0, [&](const glm::uvec3& start, glm::vec4*) {
+        const int64_t r = int64_t(start.z) * dst_size.height + start.y;
+        resample_row(taps, dst_size.width, src + r * src_size.width, dst + r * dst_size.width);
+    });
+}
+
+// Resamples along y (axis 1) or z (axis 2). Every destination row is a weighted sum of complete source rows, which
+// vectorizes over the interleaved channels.
+void resample_yz(const extent& src_size, const extent& dst_size, const int axis, const axis_taps& taps, const glm::vec4* src,
+                 glm::vec4* dst)
+{
+    const size_t floats = 4 * size_t(dst_size.width);
+    parallel_rows<glm::vec4>(dst_size, 0, [&](const glm::uvec3& start, glm::vec4*) {
+        const auto   y        = start.y;
+        const auto   z        = start.z;
+        const auto   position = axis == 1 ? y : z;
+        float* const out      = glm::value_ptr(dst[(int64_t(z) * dst_size.height + y) * dst_size.width]);
+        std::fill_n(out, floats, 0.f);
+        for (uint32_t t = 0; t < taps.count; ++t) {
+            const float weight = taps.weight[position * taps.count + t];
+            if (weight == 0.f) continue;
+            const uint32_t   p  = taps.index[position * taps.count + t];
+            const glm::vec4* in = src + src_size.linear(axis == 1 ? glm::uvec3(0, p, z) : glm::uvec3(0, y, p));
+            const float*     f  = glm::value_ptr(*in);
+            for (size_t i = 0; i < floats; ++i) out[i] += weight * f[i];
+        }
+    });
+}
+
+float srgb_to_linear(const float c)
+{
+    return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float linear_to_srgb(const float c)
+{
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.f / 2.4f) - 0.055f;
+}
+
+// 8-bit colors are decoded through a table instead of one pow per channel.
+bool has_8bit_colors(const format fmt)
+{
+    switch (fmt)
+    {
+    case r8unorm:
+    case rg8unorm:
+    case rgb8unorm:
+    case rgba8unorm:
+    case bgr8unorm:
+    case bgra8unorm: return true;
+    default: return false;
+    }
+}
+
+const std::array<float, 256>& srgb_8bit_table()
+{
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> t{};
+        for (size_t i = 0; i < t.size(); ++i) t[i] = srgb_to_linear(i / 255.f);
+        return t;
+    }();
+    return table;
+}
+
+}    // namespace
+
+row_loader::row_loader(const host_image& image, const color_space space) : row_loader(image.pixel_format(), image.extents(), space)
+{
+    if (image.layout() == image_layout::linear)
+        _view.emplace(image);
+    else
+        _image = &image;
+}
+
+row_loader::row_loader(const host_image_view& view, const color_space space) : row_loader(view.pixel_format(), view.extents(), space)
+{
+    _view.emplace(view);
+}
+
+row_loader::row_loader(const format fmt, const extent& size, const color_space space)
+      : _size(size), _space(space), _convert(find_pixel_conversion(fmt, rgba32f)), _use_table(has_8bit_colors(fmt))
+{}
+
+void row_loader::load(const int64_t r, glm::vec4* row) const
+{
+    load(r, 0, _size.width, row);
+}
+
+void row_loader::load(const int64_t r, const uint32_t x, const uint32_t count, glm::vec4* values) const
+{
+    const glm::uvec3 start(x, uint32_t(r % _size.height), uint32_t(r / _size.height));
+    if (_view && _convert)
+        _convert(_view->row(start) + format_element_size(_view->pixel_format()) * x, reinterpret_cast<std::byte*>(values), count);
+    else if (_view)
+        _view->load_row(start, count, values);
+    else
+        _image->load_row(start, count, values);
+
+    if (_space == color_space::srgb) {
+        const auto& table = srgb_8bit_table();
+        for (uint32_t i = 0; i < count; ++i)
+            for (int c = 0; c < 3; ++c)
+                values[i][c] = _use_table ? table[int(values[i][c] * 255.f + 0.5f)] : srgb_to_linear(values[i][c]);
+    }
+}
+
+namespace {
+std::vector<glm::vec4> unpack_rows(const row_loader& loader)
+{
+    const extent&          size = loader.extents();
+    std::vector<glm::vec4> pixels(size.count());
+    parallel_rows<glm::vec4>(size, 0, [&](const glm::uvec3& start, glm::vec4*) {
+        const int64_t r = int64_t(start.z) * size.height + start.y;
+        loader.load(r, &pixels[r * size.width]);
+    });
+    return pixels;
+}
+
+// Like unpack_rows, but resamples every row to the given width while loading.
+std::vector<glm::vec4> unpack_resampled_rows(const row_loader& loader, const uint32_t width, const resample_filter filter)
+{
+    const extent&          size = loader.extents();
+    std::vector<glm::vec4> pixels(size_t(width) * size.height * size.depth);
+    const axis_taps        taps = make_taps(filter, size.width, width);
+    parallel_rows<glm::vec4>(size, size.width, [&](const glm::uvec3& start, glm::vec4* row) {
+        const int64_t r = int64_t(start.z) * size.height + start.y;
+        loader.load(r, row);
+        resample_row(taps, width, row, &pixels[r * width]);
+    });
+    return pixels;
+}
+
+host_image resize_rows(const row_loader& loader, const format fmt, const extent& size, const resample_filter filter,
+                       const color_space space, const image_layout layout)
+{
+    if (!has_value_type<glm::vec4>(fmt))
+        throw std::invalid_argument("Only images of normalized and floating-point formats can be resized.");
+
+    extent                 current_size = loader.extents();
+    std::vector<glm::vec4> pixels;
+    std::vector<glm::vec4> scratch;
+    if (size.width < current_size.width) {
+        pixels             = unpack_resampled_rows(loader, size.width, filter);
+        current_size.width = size.width;
+    } else {
+        pixels = unpack_rows(loader);
+    }
+    resample_pixels(pixels, current_size, size, filter, scratch);
+
+    host_image result(fmt, size, layout);
+    pack_pixels(pixels, space, result);
+    return result;
+}
+}    // namespace
+
+std::vector<glm::vec4> unpack_pixels(const host_image& image, const color_space space)
+{
+    return unpack_rows(row_loader(image, space));
+}
+
+std::vector<glm::vec4> unpack_pixels(const host_image_view& image, const color_space space)
+{
+    return unpack_rows(row_loader(image, space));
+}
+
+host_image resized_image(const host_image& image, const extent& size, const resample_filter filter, const color_space space,
+                         const image_layout layout)
+{
+    return resize_rows(row_loader(image, space), image.pixel_format(), size, filter, space, layout);
+}
+
+host_image resized_image(const host_image_view& image, const extent& size, const resample_filter filter, const color_space space,
+                         const image_layout layout)
+{
+    return resize_rows(row_loader(image, space), image.pixel_format(), size, filter, space, layout);
+}
+
+void pack_pixels(const std::vector<glm::vec4>& pixels, const color_space space, host_image& image)
+{
+    const extent& size = image.extents();
+    if (space == color_space::linear) {
+        parallel_rows<glm::vec4>(size, 0, [&](const glm::uvec3& start, glm::vec4*) {
+            image.store_row(start, size.width, &pixels[(int64_t(start.z) * size.height + start.y) * size.width]);
+        });
+        return;
+    }
+
+    parallel_rows<glm::vec4>(size, size.width, [&](const glm::uvec3& start, glm::vec4* encoded) {
+        std::copy_n(&pixels[(int64_t(start.z) * size.height + start.y) * size.width], size.width, encoded);
+        for (uint32_t x = 0; x < size.width; ++x)
+            for (int c = 0; c < 3; ++c) encoded[x][c] = linear_to_srgb(std::max(encoded[x][c], 0.f));
+        image.store_row(start, size.width, encoded);
+    });
+}
+
+void resample_pixels(std::vector<glm::vec4>& pixels, extent& size, const extent& target, const resample_filter filter,
+                     std::vector<glm::vec4>& scratch)
+{
+    // Axes which shrink the most go first, which leaves the least data for the other passes.
+    std::array<int, 3> axes{0, 1, 2};
+    std::stable_sort(axes.begin(), axes.end(),
+                     [&](const int a, const int b) { return float(target.vec[a]) / size.vec[a] < float(target.vec[b]) / size.vec[b]; });
+
+    for (const int axis : axes) {
+        if (size.vec[axis] == target.vec[axis]) continue;
+        extent pass_size       = size;
+        pass_size.vec[axis]    = target.vec[axis];
+        const axis_taps taps   = make_taps(filter, size.vec[axis], target.vec[axis]);
+        scratch.resize(pass_size.count());
+        if (axis == 0)
+            resample_x(size, pass_size, taps, pixels.data(), scratch.data());
+        else
+            resample_yz(size, pass_size, axis, taps, pixels.data(), scratch.data());
+        std::swap(pixels, scratch);
+        size = pass_size;
+    }
+}
+}    // namespace detail
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,54 @@
+#pragma once
+#include "host_image.hpp"
+#include "pixel_conversion.hpp"
+#include <vector>
+
+namespace gfx {
+inline namespace v1 {
+namespace detail {
+// Loads rows of an image as linear floating-point values. Views and linear images are converted with the vectorized
+// kernels where there are some for the format, tiled images are loaded run by run.
+class row_loader
+{
+public:
+    row_loader(const host_image& image, color_space space);
+    row_loader(const host_image_view& view, color_space space);
+
+    const extent& extents() const noexcept { return _size; }
+    // Loads row r, counting rows of all slices, into extents().width values.
+    void load(int64_t r, glm::vec4* row) const;
+    // Loads count pixels of row r, starting at column x.
+    void load(int64_t r, uint32_t x, uint32_t count, glm::vec4* values) const;
+
+private:
+    row_loader(format fmt, const extent& size, color_space space);
+
+    extent                         _size;
+    color_space                    _space;
+    pixel_conversion_fun           _convert;
+    bool                           _use_table;
+    std::optional<host_image_view> _view;
+    const host_image*              _image = nullptr;
+};
+
+// Loads all pixels of an image as floating-point values in linear order, decoding sRGB colors.
+std::vector<glm::vec4> unpack_pixels(const host_image& image, color_space space);
+std::vector<glm::vec4> unpack_pixels(const host_image_view& image, color_space space);
+// Resamples an image into a new one with the given extents and layout. Rows are resampled while they are loaded if the
+// width shrinks, so the full image is never unpacked.
+host_image resized_image(const host_image& image, const extent& size, resample_filter filter, color_space space, image_layout layout);
+host_image resized_image(const host_image_view& image, const extent& size, resample_filter filter, color_space space,
+                         image_layout layout);
+// Stores pixels with the extents of the image, encoding sRGB colors.
+void pack_pixels(const std::vector<glm::vec4>& pixels, color_space space, host_image& image);
+// Resamples the pixels from size to target with one separable pass per axis which changes size. The result replaces
+// pixels and size, scratch is reused between the passes.
+void resample_pixels(std::vector<glm::vec4>& pixels, extent& size, const extent& target, resample_filter filter,
+                     std::vector<glm::vec4>& scratch);
+// Convolutes unpacked linear pixels of the given extents and stores the result into an image with the same extents.
+void convolute_pixels(std::vector<glm::vec4>& pixels, const extent& size, const image_filter& f, host_image& into);
+void convolute_pixels(std::vector<glm::vec4>& pixels, const extent& size,
+                      const std::tuple<image_filter, image_filter, image_filter>& filters, host_image& into);
+}    // namespace detail
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,211 @@
+#include "image_statistics.hpp"
+#include "image_resampling.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <numeric>
+
+namespace gfx {
+inline namespace v1 {
+namespace {
+// Pixels summed in float before the sums are added in double, few enough for the rounding errors to stay small.
+constexpr uint32_t summation_block = 128;
+// Rows reduced by one task, which are merged in a fixed order so that the result does not depend on the threads.
+constexpr int64_t row_group = 64;
+
+// The mean and the sums of squared deviations from it of a set of pixels, which can be merged without the cancellation
+// of the textbook formula (Chan et al.).
+struct moments
+{
+    double     count = 0;
+    glm::dvec4 mean{0};
+    glm::dvec4 m2{0};
+    glm::dmat3 c2{0};
+    glm::vec4  min{FLT_MAX};
+    glm::vec4  max{-FLT_MAX};
+};
+
+moments merge(const moments& a, const moments& b)
+{
+    if (a.count == 0) return b;
+    if (b.count == 0) return a;
+
+    moments          result;
+    const glm::dvec4 delta = b.mean - a.mean;
+    const glm::dvec3 color(delta);
+    result.count           = a.count + b.count;
+    const double weight    = a.count * b.count / result.count;
+    result.mean            = a.mean + delta * (b.count / result.count);
+    result.m2              = a.m2 + b.m2 + delta * delta * weight;
+    result.c2              = a.c2 + b.c2 + glm::outerProduct(color, color) * weight;
+    result.min             = glm::min(a.min, b.min);
+    result.max             = glm::max(a.max, b.max);
+    return result;
+}
+
+// Two passes over a row which is still in the cache: one for the mean and the range, one for the deviations. The inner
+// loops run over consecutive floats of a block, so they vectorize.
+moments row_moments(const glm::vec4* row, const uint32_t width)
+{
+    moments    m;
+    glm::dvec4 sum(0);
+    for (uint32_t begin = 0; begin < width; begin += summation_block) {
+        const uint32_t end = std::min(begin + summation_block, width);
+        glm::vec4      block(0);
+        for (uint32_t x = begin; x < end; ++x) {
+            block += row[x];
+            m.min = glm::min(m.min, row[x]);
+            m.max = glm::max(m.max, row[x]);
+        }
+        sum += glm::dvec4(block);
+    }
+    m.count = width;
+    m.mean  = sum / double(width);
+
+    const glm::vec4 mean(m.mean);
+    for (uint32_t begin = 0; begin < width; begin += summation_block) {
+        const uint32_t end = std::min(begin + summation_block, width);
+        glm::vec4      squares(0);
+        glm::vec3      products(0);    // rg, rb and gb
+        for (uint32_t x = begin; x < end; ++x) {
+            const glm::vec4 d = row[x] - mean;
+            squares += d * d;
+            products += glm::vec3(d.r * d.g, d.r * d.b, d.g * d.b);
+        }
+        m.m2 += glm::dvec4(squares);
+        m.c2[0][1] += products.x;
+        m.c2[0][2] += products.y;
+        m.c2[1][2] += products.z;
+    }
+    m.c2[1][0] = m.c2[0][1];
+    m.c2[2][0] = m.c2[0][2];
+    m.c2[2][1] = m.c2[1][2];
+    for (int c = 0; c < 3; ++c) m.c2[c][c] = m.m2[c];
+    return m;
+}
+
+// Merges neighbors pairwise, like a pairwise sum.
+moments merge_pairwise(const moments* begin, const size_t count)
+{
+    if (count == 1) return *begin;
+    return merge(merge_pairwise(begin, count / 2), merge_pairwise(begin + count / 2, count - count / 2));
+}
+
+void check_format(const format fmt)
+{
+    if (!has_value_type<glm::vec4>(fmt))
+        throw std::invalid_argument("Statistics are only computed for images of normalized and floating-point formats.");
+}
+
+template<typename Image>
+image_statistics compute_statistics(const Image& image)
+{
+    check_format(image.pixel_format());
+    const detail::row_loader loader(image, color_space::linear);
+    const extent&            size   = image.extents();
+    const int64_t            rows   = int64_t(size.height) * size.depth;
+    const int64_t            groups = (rows + row_group - 1) / row_group;
+    if (size.count() == 0) return {};
+
+    std::vector<moments> group_moments(groups);
+#pragma omp parallel
+    {
+        std::vector<glm::vec4> row(size.width);
+        std::vector<moments>   row_moments_of_group(row_group);
+#pragma omp for schedule(static)
+        for (int64_t g = 0; g < groups; ++g) {
+            const int64_t first = g * row_group;
+            const int64_t count = std::min(row_group, rows - first);
+            for (int64_t r = 0; r < count; ++r) {
+                loader.load(first + r, row.data());
+                row_moments_of_group[r] = row_moments(row.data(), size.width);
+            }
+            group_moments[g] = merge_pairwise(row_moments_of_group.data(), size_t(count));
+        }
+    }
+
+    const moments    total = merge_pairwise(group_moments.data(), group_moments.size());
+    image_statistics result;
+    result.count      = uint64_t(total.count);
+    result.mean       = total.mean;
+    result.variance   = total.m2 / total.count;
+    result.covariance = total.c2 / total.count;
+    result.min        = total.min;
+    result.max        = total.max;
+    return result;
+}
+
+template<typename Image>
+image_histogram compute_histogram(const Image& image, const uint32_t bins, const float low, const float high)
+{
+    check_format(image.pixel_format());
+    if (bins == 0 || !(high > low)) throw std::invalid_argument("Histograms need at least one bin and a range with high > low.");
+
+    image_histogram result;
+    result.low  = low;
+    result.high = high;
+    for (auto& channel : result.bins) channel.assign(bins, 0);
+
+    const detail::row_loader loader(image, color_space::linear);
+    const extent&            size  = image.extents();
+    const float              scale = float(bins) / (high - low);
+    const auto               bin   = [&](const float value) {
+        const float t = (value - low) * scale;
+        return t >= float(bins) ? bins - 1 : (t > 0.f ? uint32_t(t) : 0u);
+    };
+    const std::vector<uint64_t> counts = detail::reduce_rows<glm::vec4>(
+            size, size.width, std::vector<uint64_t>(5 * size_t(bins), 0),
+            [&](std::vector<uint64_t>& local, const glm::uvec3& start, glm::vec4* row) {
+                loader.load(int64_t(start.z) * size.height + start.y, row);
+                for (uint32_t x = 0; x < size.width; ++x) {
+                    const glm::vec4& p = row[x];
+                    for (int c = 0; c < 4; ++c) ++local[c * size_t(bins) + bin(p[c])];
+                    ++local[4 * size_t(bins) + bin(0.2126f * p.r + 0.7152f * p.g + 0.0722f * p.b)];
+                }
+            },
+            [](std::vector<uint64_t> a, const std::vector<uint64_t>& b) {
+                for (size_t i = 0; i < a.size(); ++i) a[i] += b[i];
+                return a;
+            });
+    for (size_t c = 0; c < 5; ++c) std::copy_n(counts.begin() + c * bins, bins, result.bins[c].begin());
+    return result;
+}
+}    // namespace
+
+float image_histogram::percentile(const channel c, const float p) const
+{
+    const auto&    counts = bins[c];
+    const uint64_t total  = std::accumulate(counts.begin(), counts.end(), uint64_t(0));
+    if (total == 0) return low;
+
+    const double target     = std::clamp(double(p), 0.0, 1.0) * double(total);
+    const float  width      = (high - low) / float(counts.size());
+    uint64_t     cumulative = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        if (counts[i] != 0 && double(cumulative + counts[i]) >= target)
+            return low + width * (float(i) + float((target - double(cumulative)) / double(counts[i])));
+        cumulative += counts[i];
+    }
+    return high;
+}
+
+image_statistics statistics(const host_image& image)
+{
+    return compute_statistics(image);
+}
+
+image_statistics statistics(const host_image_view& image)
+{
+    return compute_statistics(image);
+}
+
+image_histogram histogram(const host_image& image, const uint32_t bins, const float low, const float high)
+{
+    return compute_histogram(image, bins, low, high);
+}
+
+image_histogram histogram(const host_image_view& image, const uint32_t bins, const float low, const float high)
+{
+    return compute_histogram(image, bins, low, high);
+}
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,49 @@
+#pragma once
+#include "host_image.hpp"
+
+namespace gfx {
+inline namespace v1 {
+// Per-channel moments of all pixels of an image, loaded as floating-point values.
+struct image_statistics
+{
+    uint64_t   count = 0;
+    glm::dvec4 mean{0};
+    glm::dvec4 variance{0};      // Population variance of each channel.
+    glm::dmat3 covariance{0};    // Population covariance of the color channels.
+    glm::vec4  min{0};
+    glm::vec4  max{0};
+
+    glm::dvec4 sum() const noexcept { return mean * double(count); }
+    glm::dvec4 standard_deviation() const noexcept { return sqrt(variance); }
+};
+
+// Histograms of the color channels, alpha and the Rec. 709 luminance of the color channels, with equally wide bins
+// between low and high. Values outside of that range count for the first or last bin.
+struct image_histogram
+{
+    enum channel
+    {
+        r,
+        g,
+        b,
+        a,
+        luminance
+    };
+
+    float                                low  = 0.f;
+    float                                high = 1.f;
+    std::array<std::vector<uint64_t>, 5> bins;
+
+    // The value below which the fraction p of all values lies, interpolated linearly within the bin containing it.
+    float percentile(channel c, float p) const;
+};
+
+// Rows are reduced in parallel and their moments are merged pairwise, so the results do not depend on the number of
+// threads and stay accurate for large images.
+image_statistics statistics(const host_image& image);
+image_statistics statistics(const host_image_view& image);
+
+image_histogram histogram(const host_image& image, uint32_t bins = 256, float low = 0.f, float high = 1.f);
+image_histogram histogram(const host_image_view& image, uint32_t bins = 256, float low = 0.f, float high = 1.f);
+}    // namespace v1
+}    // namespace gfx
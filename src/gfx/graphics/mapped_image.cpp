@@ -0,0 +1,374 @@
+#include "mapped_image.hpp"
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gfx {
+inline namespace v1 {
+namespace {
+// Unmaps the whole pages within a byte range after a tile was copied, so that the resident memory stays bounded by the
+// tile cache. The data stays in the file or the page cache of the system.
+void release_pages(std::byte* data, size_t begin, size_t end)
+{
+#if !defined(_WIN32)
+    const auto page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    begin           = (begin + page - 1) / page * page;
+    end             = end / page * page;
+    if (begin < end) madvise(data + begin, end - begin, MADV_DONTNEED);
+#endif
+}
+}    // namespace
+
+mapped_image::mapped_image(const std::filesystem::path& path, const format fmt, const extent& size, const image_layout layout,
+                           const size_t cache_tiles)
+      : _format(fmt)
+      , _extent(size)
+      , _layout(layout)
+      , _tile_extent(size.depth > 1 ? extent(64, 64, 64) : extent(256, 256, 1))
+      , _tiles((size.width + _tile_extent.width - 1) / _tile_extent.width, (size.height + _tile_extent.height - 1) / _tile_extent.height,
+               (size.depth + _tile_extent.depth - 1) / _tile_extent.depth)
+      , _storage_element_size(format_element_size(fmt))
+      , _cache_tiles(std::max(cache_tiles, size_t(1)))
+{
+    const size_t pixels = layout == image_layout::linear ? _extent.count() : _tiles.count() * _tile_extent.count();
+    _size               = _storage_element_size * pixels;
+
+#if defined(_WIN32)
+    _file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_file == INVALID_HANDLE_VALUE) {
+        _file = nullptr;
+        throw std::runtime_error("Cannot open image file.");
+    }
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(_file, &file_size);
+    LARGE_INTEGER mapping_size;
+    mapping_size.QuadPart = std::max(static_cast<LONGLONG>(_size), file_size.QuadPart);
+    _mapping = CreateFileMappingW(_file, nullptr, PAGE_READWRITE, mapping_size.HighPart, mapping_size.LowPart, nullptr);
+    if (_mapping) _data = static_cast<std::byte*>(MapViewOfFile(_mapping, FILE_MAP_ALL_ACCESS, 0, 0, _size));
+    if (!_data) {
+        if (_mapping) CloseHandle(_mapping);
+        CloseHandle(_file);
+        throw std::runtime_error("Cannot map image file.");
+    }
+#else
+    _file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (_file < 0) throw std::runtime_error("Cannot open image file.");
+    struct stat info;
+    if (fstat(_file, &info) != 0 || (static_cast<size_t>(info.st_size) < _size && ftruncate(_file, static_cast<off_t>(_size)) != 0)) {
+        close(_file);
+        throw std::runtime_error("Cannot resize image file.");
+    }
+    void* const data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _file, 0);
+    if (data == MAP_FAILED) {
+        close(_file);
+        throw std::runtime_error("Cannot map image file.");
+    }
+    _data = static_cast<std::byte*>(data);
+#endif
+}
+
+mapped_image::~mapped_image()
+{
+    flush();
+#if defined(_WIN32)
+    UnmapViewOfFile(_data);
+    CloseHandle(_mapping);
+    CloseHandle(_file);
+#else
+    munmap(_data, _size);
+    close(_file);
+#endif
+}
+
+const extent& mapped_image::extents() const noexcept
+{
+    return _extent;
+}
+
+const extent& mapped_image::tile_extents() const noexcept
+{
+    return _tile_extent;
+}
+
+format mapped_image::pixel_format() const noexcept
+{
+    return _format;
+}
+
+image_layout mapped_image::layout() const noexcept
+{
+    return _layout;
+}
+
+size_t mapped_image::tile_index(const glm::uvec3& pixel) const noexcept
+{
+    const glm::uvec3 tile = pixel / _tile_extent.vec;
+    return (size_t(tile.z) * _tiles.height + tile.y) * _tiles.width + tile.x;
+}
+
+glm::uvec3 mapped_image::tile_origin(const size_t index) const noexcept
+{
+    const size_t tiles_per_slice = size_t(_tiles.width) * _tiles.height;
+    const auto   z               = uint32_t(index / tiles_per_slice);
+    const auto   y               = uint32_t(index % tiles_per_slice / _tiles.width);
+    const auto   x               = uint32_t(index % _tiles.width);
+    return glm::uvec3(x, y, z) * _tile_extent.vec;
+}
+
+host_image& mapped_image::tile(const size_t index, const bool modified) const
+{
+    if (_cache.empty() || _cache.front().index != index) {
+        if (const auto it = _cached.find(index); it != _cached.end()) {
+            _cache.splice(_cache.begin(), _cache, it->second);
+        } else {
+            // The least recently used tile is written back and its image reused for the new one.
+            if (_cache.size() >= _cache_tiles) {
+                cached_tile& last = _cache.back();
+                if (last.modified) write_tile(last);
+                _cached.erase(last.index);
+                _cache.splice(_cache.begin(), _cache, std::prev(_cache.end()));
+                _cache.front().index = index;
+            } else {
+                _cache.push_front(cached_tile{index, host_image(_format, _tile_extent), false});
+            }
+            _cached[index] = _cache.begin();
+            read_tile(_cache.front());
+        }
+    }
+    _cache.front().modified |= modified;
+    return _cache.front().image;
+}
+
+void mapped_image::read_tile(cached_tile& tile) const
+{
+    std::byte* const tile_data  = tile.image.storage().data();
+    const size_t     tile_bytes = _storage_element_size * _tile_extent.count();
+    if (_layout == image_layout::tiled) {
+        memcpy(tile_data, _data + tile.index * tile_bytes, tile_bytes);
+        release_pages(_data, tile.index * tile_bytes, (tile.index + 1) * tile_bytes);
+        return;
+    }
+
+    const glm::uvec3 origin = tile_origin(tile.index);
+    const glm::uvec3 size   = glm::min(_tile_extent.vec, _extent.vec - origin);
+    if (size != _tile_extent.vec) memset(tile_data, 0, tile_bytes);
+    for (uint32_t z = 0; z < size.z; ++z) {
+        for (uint32_t y = 0; y < size.y; ++y) {
+            const size_t pixel = (size_t(origin.z + z) * _extent.height + origin.y + y) * _extent.width + origin.x;
+            memcpy(tile_data + _storage_element_size * _tile_extent.linear({0, y, z}), _data + _storage_element_size * pixel,
+                   _storage_element_size * size.x);
+        }
+    }
+    release_rows(tile.index);
+}
+
+void mapped_image::write_tile(cached_tile& tile) const
+{
+    tile.modified                     = false;
+    const std::byte* const tile_data  = tile.image.storage().data();
+    const size_t           tile_bytes = _storage_element_size * _tile_extent.count();
+    if (_layout == image_layout::tiled) {
+        memcpy(_data + tile.index * tile_bytes, tile_data, tile_bytes);
+        release_pages(_data, tile.index * tile_bytes, (tile.index + 1) * tile_bytes);
+        return;
+    }
+
+    const glm::uvec3 origin = tile_origin(tile.index);
+    const glm::uvec3 size   = glm::min(_tile_extent.vec, _extent.vec - origin);
+    for (uint32_t z = 0; z < size.z; ++z) {
+        for (uint32_t y = 0; y < size.y; ++y) {
+            const size_t pixel = (size_t(origin.z + z) * _extent.height + origin.y + y) * _extent.width + origin.x;
+            memcpy(_data + _storage_element_size * pixel, tile_data + _storage_element_size * _tile_extent.linear({0, y, z}),
+                   _storage_element_size * size.x);
+        }
+    }
+    release_rows(tile.index);
+}
+
+// The rows of a tile in a linear file are interleaved with other tiles, so all pages between its first and last pixel
+// are released. Cached tiles are copies and do not depend on the mapping.
+void mapped_image::release_rows(const size_t index) const
+{
+    const glm::uvec3 origin = tile_origin(index);
+    const glm::uvec3 last   = glm::min(origin + _tile_extent.vec, _extent.vec) - 1u;
+    const size_t     begin  = (size_t(origin.z) * _extent.height + origin.y) * _extent.width + origin.x;
+    const size_t     end    = (size_t(last.z) * _extent.height + last.y) * _extent.width + last.x + 1;
+    release_pages(_data, _storage_element_size * begin, _storage_element_size * end);
+}
+
+void mapped_image::flush()
+{
+    for (auto& tile : _cache)
+        if (tile.modified) write_tile(tile);
+#if defined(_WIN32)
+    FlushViewOfFile(_data, 0);
+#else
+    msync(_data, _size, MS_SYNC);
+#endif
+}
+
+template<typename T>
+void mapped_image::load_row(const glm::uvec3& start, const uint32_t count, T* values) const
+{
+    for (uint32_t offset = 0; offset < count;) {
+        const glm::uvec3 pixel(start.x + offset, start.y, start.z);
+        const glm::uvec3 local  = pixel % _tile_extent.vec;
+        const uint32_t   length = std::min(count - offset, _tile_extent.width - local.x);
+        tile(tile_index(pixel), false).load_row(local, length, values + offset);
+        offset += length;
+    }
+}
+
+template<typename T>
+void mapped_image::store_row(const glm::uvec3& start, const uint32_t count, const T* values)
+{
+    for (uint32_t offset = 0; offset < count;) {
+        const glm::uvec3 pixel(start.x + offset, start.y, start.z);
+        const glm::uvec3 local  = pixel % _tile_extent.vec;
+        const uint32_t   length = std::min(count - offset, _tile_extent.width - local.x);
+        tile(tile_index(pixel), true).store_row(local, length, values + offset);
+        offset += length;
+    }
+}
+
+template void mapped_image::load_row(const glm::uvec3& start, uint32_t count, glm::vec4* values) const;
+template void mapped_image::load_row(const glm::uvec3& start, uint32_t count, glm::uvec4* values) const;
+template void mapped_image::load_row(const glm::uvec3& start, uint32_t count, glm::ivec4* values) const;
+template void mapped_image::store_row(const glm::uvec3& start, uint32_t count, const glm::vec4* values);
+template void mapped_image::store_row(const glm::uvec3& start, uint32_t count, const glm::uvec4* values);
+template void mapped_image::store_row(const glm::uvec3& start, uint32_t count, const glm::ivec4* values);
+
+glm::vec4 mapped_image::load(glm::uvec3 pixel) const
+{
+    pixel = _extent.clamp(pixel);
+    glm::vec4 value;
+    load_row(pixel, 1, &value);
+    return value;
+}
+
+glm::vec4 mapped_image::load_bilinear(const glm::vec3& pixel) const
+{
+    const auto       frac = fract(pixel);
+    const glm::ivec3 p00  = _extent.clamp(floor(pixel));
+    const glm::ivec3 p11  = _extent.clamp(ceil(pixel));
+
+    if (_extent.depth == 1) {
+        const auto m0y = mix(load({p00.x, p00.y, 0}), load({p00.x, p11.y, 0}), frac.y);
+        const auto m1y = mix(load({p11.x, p00.y, 0}), load({p11.x, p11.y, 0}), frac.y);
+        return mix(m0y, m1y, frac.x);
+    }
+
+    const auto m00z = mix(load(p00), load({p00.x, p00.y, p11.z}), frac.z);
+    const auto m01z = mix(load({p00.x, p11.y, p00.z}), load({p00.x, p11.y, p11.z}), frac.z);
+    const auto m10z = mix(load({p11.x, p00.y, p00.z}), load({p11.x, p00.y, p11.z}), frac.z);
+    const auto m11z = mix(load({p11.x, p11.y, p00.z}), load(p11), frac.z);
+
+    return mix(mix(m00z, m01z, frac.y), mix(m10z, m11z, frac.y), frac.x);
+}
+
+glm::uvec4 mapped_image::loadu(const glm::uvec3& pixel) const
+{
+    glm::uvec4 value;
+    load_row(pixel, 1, &value);
+    return value;
+}
+
+glm::ivec4 mapped_image::loadi(const glm::uvec3& pixel) const
+{
+    glm::ivec4 value;
+    load_row(pixel, 1, &value);
+    return value;
+}
+
+void mapped_image::store(const glm::uvec3& pixel, const glm::vec4& p)
+{
+    store_row(pixel, 1, &p);
+}
+
+void mapped_image::storeu(const glm::uvec3& pixel, const glm::uvec4& p)
+{
+    store_row(pixel, 1, &p);
+}
+
+void mapped_image::storei(const glm::uvec3& pixel, const glm::ivec4& p)
+{
+    store_row(pixel, 1, &p);
+}
+
+void mapped_image::convert(mapped_image& into) const
+{
+    if (into.extents() != _extent) throw std::invalid_argument("Cannot convert into a mapped image of different extents.");
+    if (&into == this) return;
+
+    // Both images have the same tiles, whatever the layout of their files.
+    for (size_t i = 0; i < _tiles.count(); ++i) {
+        host_image converted = tile(i, false).converted(into.pixel_format());
+        into.tile(i, true)   = std::move(converted);
+    }
+}
+
+void mapped_image::convolute(const image_filter& f, mapped_image& into) const
+{
+    convolute_tiles(f, f.extents().vec / 2u, into);
+}
+
+void mapped_image::convolute(const std::tuple<image_filter, image_filter, image_filter>& filters, mapped_image& into) const
+{
+    const glm::uvec3 border =
+        std::get<0>(filters).extents().vec / 2u + std::get<1>(filters).extents().vec / 2u + std::get<2>(filters).extents().vec / 2u;
+    convolute_tiles(filters, border, into);
+}
+
+// Every tile is convolved with a border of source pixels around it, clamped at the image edges, so the result matches
+// the convolution of the complete image.
+template<typename Filter>
+void mapped_image::convolute_tiles(const Filter& filter, const glm::uvec3& filter_border, mapped_image& into) const
+{
+    if (into.extents() != _extent) throw std::invalid_argument("Cannot convolute into a mapped image of different extents.");
+    if (&into == this) throw std::invalid_argument("Mapped images cannot be convoluted in place.");
+
+    // A border wider than the image only repeats the clamped edge, e.g. along z for 2D images.
+    const glm::uvec3       border = glm::min(filter_border, _extent.vec - 1u);
+    const glm::uvec3       padded_vec = _tile_extent.vec + 2u * border;
+    const extent           padded_size(padded_vec.x, padded_vec.y, padded_vec.z);
+    host_image             padded(rgba32f, padded_size);
+    host_image             result(rgba32f, padded_size);
+    std::vector<glm::vec4> row(padded_size.width);
+
+    const int last_x = int(_extent.width) - 1;
+    for (size_t i = 0; i < _tiles.count(); ++i) {
+        const glm::ivec3 origin = glm::ivec3(tile_origin(i)) - glm::ivec3(border);
+        const int        first  = std::clamp(origin.x, 0, last_x);
+        const int        last   = std::clamp(origin.x + int(padded_size.width) - 1, 0, last_x);
+        for (uint32_t z = 0; z < padded_size.depth; ++z) {
+            for (uint32_t y = 0; y < padded_size.height; ++y) {
+                const glm::ivec3 source = _extent.clamp({first, origin.y + int(y), origin.z + int(z)});
+                load_row(glm::uvec3(source), uint32_t(last - first + 1), &row[first - origin.x]);
+                std::fill(row.begin(), row.begin() + (first - origin.x), row[first - origin.x]);
+                std::fill(row.begin() + (last - origin.x + 1), row.end(), row[last - origin.x]);
+                padded.store_row({0, y, z}, padded_size.width, row.data());
+            }
+        }
+
+        padded.convolute(filter, result);
+        host_image& target = into.tile(i, true);
+        for (uint32_t z = 0; z < _tile_extent.depth; ++z) {
+            for (uint32_t y = 0; y < _tile_extent.height; ++y) {
+                result.load_row(glm::uvec3(0, y, z) + border, _tile_extent.width, row.data());
+                target.store_row({0, y, z}, _tile_extent.width, row.data());
+            }
+        }
+    }
+}
+}    // namespace v1
+}    // namespace gfx
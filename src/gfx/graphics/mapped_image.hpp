@@ -0,0 +1,103 @@
+#pragma once
+#include "host_image.hpp"
+#include <filesystem>
+#include <list>
+#include <unordered_map>
+
+namespace gfx {
+inline namespace v1 {
+// An image backed by a memory-mapped file, for data which does not fit into memory. The file holds the pixels like
+// host_image storage, either linearly (a headerless raw file) or as consecutive tiles of tile_extents() padded to whole
+// tiles. Tiles are unpacked into host_images on first access and kept in a least-recently-used cache of a fixed
+// number of tiles, modified ones are written back when they are evicted or flushed.
+// A mapped_image must not be accessed by several threads at once, the streaming operations work in parallel within
+// every tile.
+class mapped_image
+{
+public:
+    constexpr static size_t default_cache_tiles = 64;
+
+    // Maps the file, creating or growing it if it is smaller than the image. The file keeps any existing content.
+    mapped_image(const std::filesystem::path& path, format fmt, const extent& size, image_layout layout = image_layout::tiled,
+                 size_t cache_tiles = default_cache_tiles);
+    ~mapped_image();
+
+    mapped_image(const mapped_image& other) = delete;
+    mapped_image& operator=(const mapped_image& other) = delete;
+
+    const extent& extents() const noexcept;
+    const extent& tile_extents() const noexcept;
+    format        pixel_format() const noexcept;
+    image_layout  layout() const noexcept;
+
+    template<typename T>
+    void load_row(const glm::uvec3& start, uint32_t count, T* values) const;
+    template<typename T>
+    void store_row(const glm::uvec3& start, uint32_t count, const T* values);
+
+    glm::vec4  load(glm::uvec3 pixel) const;
+    glm::vec4  load_bilinear(const glm::vec3& pixel) const;
+    glm::uvec4 loadu(const glm::uvec3& pixel) const;
+    glm::ivec4 loadi(const glm::uvec3& pixel) const;
+    void       store(const glm::uvec3& pixel, const glm::vec4& p);
+    void       storeu(const glm::uvec3& pixel, const glm::uvec4& p);
+    void       storei(const glm::uvec3& pixel, const glm::ivec4& p);
+
+    // Writes all modified tiles back to the file.
+    void flush();
+
+    // Calls fun(origin, tile) for every tile in file order. Tiles at the border extend beyond the image. The mutable
+    // overload marks every tile as modified.
+    template<typename Fun>
+    void each_tile(Fun&& fun);
+    template<typename Fun>
+    void each_tile(Fun&& fun) const;
+
+    // Streaming versions of the host_image operations, which hold no more than the tile caches and one tile with a
+    // border of the filter size in memory. The into image must have the same extents and may have another layout.
+    void convert(mapped_image& into) const;
+    void convolute(const image_filter& f, mapped_image& into) const;
+    void convolute(const std::tuple<image_filter, image_filter, image_filter>& filters, mapped_image& into) const;
+
+private:
+    struct cached_tile
+    {
+        size_t     index;
+        host_image image;
+        bool       modified;
+    };
+
+    size_t      tile_index(const glm::uvec3& pixel) const noexcept;
+    glm::uvec3  tile_origin(size_t index) const noexcept;
+    host_image& tile(size_t index, bool modified) const;
+    void        read_tile(cached_tile& tile) const;
+    void        write_tile(cached_tile& tile) const;
+    void        release_rows(size_t index) const;
+    template<typename Filter>
+    void convolute_tiles(const Filter& filter, const glm::uvec3& border, mapped_image& into) const;
+
+    format       _format;
+    extent       _extent;
+    image_layout _layout;
+    extent       _tile_extent;
+    extent       _tiles;
+    size_t       _storage_element_size;
+    size_t       _cache_tiles;
+
+    std::byte* _data = nullptr;
+    size_t     _size = 0;
+#if defined(_WIN32)
+    void* _file    = nullptr;
+    void* _mapping = nullptr;
+#else
+    int _file = -1;
+#endif
+
+    // Most recently used tiles first.
+    mutable std::list<cached_tile>                                         _cache;
+    mutable std::unordered_map<size_t, std::list<cached_tile>::iterator> _cached;
+};
+}    // namespace v1
+}    // namespace gfx
+
+#include "mapped_image.inl"
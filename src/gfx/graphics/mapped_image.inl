@@ -0,0 +1,17 @@
+#pragma once
+
+namespace gfx {
+inline namespace v1 {
+template<typename Fun>
+void mapped_image::each_tile(Fun&& fun)
+{
+    for (size_t i = 0; i < _tiles.count(); ++i) fun(tile_origin(i), tile(i, true));
+}
+
+template<typename Fun>
+void mapped_image::each_tile(Fun&& fun) const
+{
+    for (size_t i = 0; i < _tiles.count(); ++i) fun(tile_origin(i), static_cast<const host_image&>(tile(i, false)));
+}
+}    // namespace v1
+}    // namespace gfx
@@ -101,43 +101,79 @@ void device_image_implementation::initialize(uint32_t layer_dimensions, format f
 }
 void device_image_implementation::fill_from(const host_image& image, uint32_t level, uint32_t layer)
 {
+    upload(image, level, layer);
+    glFinish();
+}
+
+void device_image_implementation::fill_from(const host_image_pyramid& pyramid, uint32_t layer)
+{
+    // All levels are uploaded before synchronizing once.
+    for (uint32_t level = 0; level < std::min(pyramid.levels(), _levels); ++level) upload(pyramid[level], level, layer);
+    glFinish();
+}
+
+void device_image_implementation::fill_from(const compressed_image& image, uint32_t level, uint32_t layer)
+{
+    // 2D array layers and 3D slices are both addressed by z.
+    const auto width  = std::max(_extent.width >> level, 1u);
+    const auto height = std::max(_extent.height >> level, 1u);
+    const auto depth  = _type == GL_TEXTURE_3D ? std::max(_extent.depth >> level, 1u) : 1u;
+    const auto z      = _type == GL_TEXTURE_3D ? 0u : layer;
+    const auto size   = static_cast<int>(format_element_size(_format) * image.blocks().width * image.blocks().height * depth);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, handle_cast<mygl::buffer>(image.storage()));
+    if (glCompressedTextureSubImage3D)
+        glCompressedTextureSubImage3D(_handle, level, 0, 0, z, width, height, depth, _internal_format, size, nullptr);
+    else
+    {
+        glBindTexture(_type, _handle);
+        glCompressedTexSubImage3D(_type, level, 0, 0, z, width, height, depth, _internal_format, size, nullptr);
+        glBindTexture(_type, mygl::texture::zero);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mygl::buffer::zero);
+    glFinish();
+}
+
+void device_image_implementation::upload(const host_image& image, uint32_t level, uint32_t layer)
+{
+    // Array layers are not part of the mip chain.
+    const auto width  = std::max(_extent.width >> level, 1u);
+    const auto height = _type == GL_TEXTURE_1D_ARRAY ? _extent.height : std::max(_extent.height >> level, 1u);
+    const auto depth  = _type == GL_TEXTURE_3D ? std::max(_extent.depth >> level, 1u) : _extent.depth;
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, handle_cast<mygl::buffer>(image.storage()));
     switch (_type)
     {
     case GL_TEXTURE_3D:
         if (glTextureSubImage3D)
-            glTextureSubImage3D(_handle, level, 0, 0, 0, _extent.width, _extent.height, _extent.depth, _external_format, _external_type,
-                                nullptr);
+            glTextureSubImage3D(_handle, level, 0, 0, 0, width, height, depth, _external_format, _external_type, nullptr);
         else
         {
             glBindTexture(_type, _handle);
-            glTexSubImage3D(_type, level, 0, 0, 0, _extent.width, _extent.height, _extent.depth, _external_format, _external_type, nullptr);
+            glTexSubImage3D(_type, level, 0, 0, 0, width, height, depth, _external_format, _external_type, nullptr);
             glBindTexture(_type, mygl::texture::zero);
         }
         break;
     case GL_TEXTURE_2D_ARRAY:
         if (glTextureSubImage3D)
-            glTextureSubImage3D(_handle, level, 0, 0, layer, _extent.width, _extent.height, 1, _external_format, _external_type, nullptr);
+            glTextureSubImage3D(_handle, level, 0, 0, layer, width, height, 1, _external_format, _external_type, nullptr);
         else
         {
             glBindTexture(_type, _handle);
-            glTexSubImage3D(_type, level, 0, 0, layer, _extent.width, _extent.height, 1, _external_format, _external_type, nullptr);
+            glTexSubImage3D(_type, level, 0, 0, layer, width, height, 1, _external_format, _external_type, nullptr);
             glBindTexture(_type, mygl::texture::zero);
         }
         break;
     case GL_TEXTURE_1D_ARRAY:
         if (glTextureSubImage3D)
-            glTextureSubImage2D(_handle, level, 0, layer, _extent.width, 1, _external_format, _external_type, nullptr);
+            glTextureSubImage2D(_handle, level, 0, layer, width, 1, _external_format, _external_type, nullptr);
         else
         {
             glBindTexture(_type, _handle);
-            glTexSubImage2D(_type, level, 0, layer, _extent.width, 1, _external_format, _external_type, nullptr);
+            glTexSubImage2D(_type, level, 0, layer, width, 1, _external_format, _external_type, nullptr);
             glBindTexture(_type, mygl::texture::zero);
         }
         break;
     }
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mygl::buffer::zero);
-    glFinish();
 }
 
 void device_image_implementation::fill_to(const host_image& image, uint32_t level, uint32_t layer)
@@ -20,11 +20,15 @@ public:
 
     void     initialize(uint32_t layer_dimensions, format format, const extent& size, uint32_t levels, sample_count samples) override;
     void     fill_from(const host_image& image, uint32_t level, uint32_t layer) override;
+    void     fill_from(const host_image_pyramid& pyramid, uint32_t layer) override;
+    void     fill_from(const compressed_image& image, uint32_t level, uint32_t layer) override;
     void     fill_to(const host_image& image, uint32_t level, uint32_t layer) override;
 	handle api_handle() override;
     void     generate_mipmaps() override;
 
 private:
+    void upload(const host_image& image, uint32_t level, uint32_t layer);
+
     movable_handle<mygl::texture> _handle;
     GLenum        _internal_format;
     GLenum        _external_format;
@@ -3,6 +3,12 @@
 namespace gfx {
 inline namespace v1 {
 namespace opengl {
+namespace {
+// From EXT_texture_compression_s3tc, which mygl does not load.
+constexpr GLenum compressed_rgba_s3tc_dxt1 = GLenum(0x83F1);
+constexpr GLenum compressed_rgba_s3tc_dxt5 = GLenum(0x83F3);
+}    // namespace
+
 format_info format_from(format format)
 {
     switch (format)
@@ -66,6 +72,14 @@ format_info format_from(format format)
 	case bgra8unorm: return {GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE, true, GL_COLOR_BUFFER_BIT};
 	case bgr8unorm: return {GL_RGB8, GL_BGR, GL_UNSIGNED_BYTE, true, GL_COLOR_BUFFER_BIT};
 
+    // Compressed formats are uploaded as they are.
+    case bc1unorm: return {compressed_rgba_s3tc_dxt1, GLenum(0), GLenum(0), true, GL_COLOR_BUFFER_BIT};
+    case bc3unorm: return {compressed_rgba_s3tc_dxt5, GLenum(0), GLenum(0), true, GL_COLOR_BUFFER_BIT};
+    case bc4unorm: return {GL_COMPRESSED_RED_RGTC1, GLenum(0), GLenum(0), true, GL_COLOR_BUFFER_BIT};
+    case bc5unorm: return {GL_COMPRESSED_RG_RGTC2, GLenum(0), GLenum(0), true, GL_COLOR_BUFFER_BIT};
+    case bc6hf: return {GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, GLenum(0), GLenum(0), false, GL_COLOR_BUFFER_BIT};
+    case bc7unorm: return {GL_COMPRESSED_RGBA_BPTC_UNORM, GLenum(0), GLenum(0), true, GL_COLOR_BUFFER_BIT};
+
     case d16unorm: return {GL_DEPTH_COMPONENT16, GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT, true, GL_DEPTH_BUFFER_BIT};
     case d24unorm: return {GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT_24_8, true, GL_DEPTH_BUFFER_BIT};
     case s8ui: return {GL_STENCIL_INDEX8, GL_STENCIL_INDEX, GL_UNSIGNED_BYTE, false, GL_STENCIL_BUFFER_BIT};
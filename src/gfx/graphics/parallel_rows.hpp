@@ -0,0 +1,55 @@
+#pragma once
+#include "host_image.hpp"
+#include <optional>
+#include <vector>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace gfx {
+inline namespace v1 {
+namespace detail {
+// Calls fun(start, buffer) for all rows of an image with the given extents in parallel, with a thread-local buffer
+// holding buffer_size values.
+template<typename T, typename Fun>
+void parallel_rows(const extent& size, const size_t buffer_size, Fun&& fun)
+{
+    const int64_t rows = int64_t(size.height) * size.depth;
+#pragma omp parallel
+    {
+        std::vector<T> buffer(buffer_size);
+#pragma omp for schedule(static)
+        for (int64_t r = 0; r < rows; ++r) fun(glm::uvec3(0, uint32_t(r % size.height), uint32_t(r / size.height)), buffer.data());
+    }
+}
+
+// Like parallel_rows, but fun(state, start, buffer) also gets a state, which every thread initializes from init. The
+// states are combined with combine(a, b) in the order of their rows, so init has to be neutral. Without OpenMP, all rows
+// update init itself.
+template<typename T, typename State, typename Fun, typename Combine>
+State reduce_rows(const extent& size, const size_t buffer_size, State init, Fun&& fun, Combine&& combine)
+{
+    const int64_t rows = int64_t(size.height) * size.depth;
+#if defined(_OPENMP)
+    // A static schedule gives every thread one range of consecutive rows, in the order of the thread numbers.
+    std::vector<std::optional<State>> states(omp_get_max_threads());
+#pragma omp parallel
+    {
+        State          state = init;
+        std::vector<T> buffer(buffer_size);
+#pragma omp for schedule(static)
+        for (int64_t r = 0; r < rows; ++r)
+            fun(state, glm::uvec3(0, uint32_t(r % size.height), uint32_t(r / size.height)), buffer.data());
+        states[omp_get_thread_num()] = std::move(state);
+    }
+    for (auto& state : states)
+        if (state) init = combine(std::move(init), std::move(*state));
+#else
+    std::vector<T> buffer(buffer_size);
+    for (int64_t r = 0; r < rows; ++r) fun(init, glm::uvec3(0, uint32_t(r % size.height), uint32_t(r / size.height)), buffer.data());
+#endif
+    return init;
+}
+}    // namespace detail
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,269 @@
+#include "pixel_conversion.hpp"
+#include "pixel_kernels.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GFX_CONVERSION_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define GFX_CONVERSION_AVX2 1
+#endif
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define GFX_CONVERSION_F16C 1
+#endif
+#if defined(GFX_CONVERSION_AVX2) || defined(GFX_CONVERSION_F16C)
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define GFX_CONVERSION_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace gfx {
+inline namespace v1 {
+namespace {
+// Converts the pixels which are left over by the vectorized loops.
+template<format From, format To>
+void convert_scalar(const std::byte* src, std::byte* dst, size_t count)
+{
+    using from_kernel = pixel_kernel<From>;
+    using to_kernel   = pixel_kernel<To>;
+    for (size_t i = 0; i < count; ++i) to_kernel::store(dst + i * to_kernel::size, from_kernel::load(src + i * from_kernel::size));
+}
+
+#if defined(GFX_CONVERSION_SSE2)
+// Rounds non-negative values half away from zero like glm::round, which _mm_cvtps_epi32 does not.
+inline __m128i round_positive(__m128 v)
+{
+    const __m128i truncated = _mm_cvttps_epi32(v);
+    const __m128  fraction  = _mm_sub_ps(v, _mm_cvtepi32_ps(truncated));
+    return _mm_sub_epi32(truncated, _mm_castps_si128(_mm_cmpge_ps(fraction, _mm_set1_ps(0.5f))));
+}
+
+inline __m128i unorm8(__m128 v)
+{
+    const __m128 clamped = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.f));
+    return round_positive(_mm_mul_ps(clamped, _mm_set1_ps(255.f)));
+}
+
+// Same bit manipulation as glm::packF2x11_1x10, with zero, infinity and NaN handled separately.
+template<int Shift, uint32_t ExponentMask, uint32_t MantissaMask>
+__m128i small_float(__m128 v)
+{
+    const __m128i bits   = _mm_castps_si128(v);
+    const __m128i biased = _mm_sub_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x7f800000)), _mm_set1_epi32(0x38000000));
+    __m128i       result = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(biased, Shift), _mm_set1_epi32(ExponentMask)),
+                                  _mm_and_si128(_mm_srli_epi32(bits, Shift), _mm_set1_epi32(MantissaMask)));
+
+    const __m128i zero = _mm_castps_si128(_mm_cmpeq_ps(v, _mm_setzero_ps()));
+    const __m128i nan  = _mm_castps_si128(_mm_cmpunord_ps(v, v));
+    const __m128i inf  = _mm_cmpeq_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x7fffffff)), _mm_set1_epi32(0x7f800000));
+    result             = _mm_andnot_si128(_mm_or_si128(zero, inf), result);
+    result             = _mm_or_si128(result, _mm_and_si128(inf, _mm_set1_epi32(ExponentMask)));
+    return _mm_and_si128(_mm_or_si128(result, nan), _mm_set1_epi32(ExponentMask | MantissaMask));
+}
+
+// 2^exponent for integer exponents in the normal float range.
+inline __m128 exp2i(__m128i exponent)
+{
+    return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(exponent, _mm_set1_epi32(127)), 23));
+}
+#endif
+
+void rgba8unorm_to_rgba32f(const std::byte* src, std::byte* dst, size_t count)
+{
+    size_t i = 0;
+#if defined(GFX_CONVERSION_AVX2)
+    const __m256 scale = _mm256_set1_ps(1.f / 255.f);
+    for (; i + 4 <= count; i += 4) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+        float* const  out   = reinterpret_cast<float*>(dst + 16 * i);
+        _mm256_storeu_ps(out, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes)), scale));
+        _mm256_storeu_ps(out + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8))), scale));
+    }
+#elif defined(GFX_CONVERSION_SSE2)
+    const __m128  scale = _mm_set1_ps(1.f / 255.f);
+    const __m128i zero  = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+        const __m128i lo    = _mm_unpacklo_epi8(bytes, zero);
+        const __m128i hi    = _mm_unpackhi_epi8(bytes, zero);
+        float* const  out   = reinterpret_cast<float*>(dst + 16 * i);
+        _mm_storeu_ps(out, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+        _mm_storeu_ps(out + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+        _mm_storeu_ps(out + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+        _mm_storeu_ps(out + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+    }
+#elif defined(GFX_CONVERSION_NEON)
+    const float32x4_t scale = vdupq_n_f32(1.f / 255.f);
+    for (; i + 4 <= count; i += 4) {
+        const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(src + 4 * i));
+        const uint16x8_t lo    = vmovl_u8(vget_low_u8(bytes));
+        const uint16x8_t hi    = vmovl_u8(vget_high_u8(bytes));
+        float* const     out   = reinterpret_cast<float*>(dst + 16 * i);
+        vst1q_f32(out, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), scale));
+        vst1q_f32(out + 4, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), scale));
+        vst1q_f32(out + 8, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), scale));
+        vst1q_f32(out + 12, vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), scale));
+    }
+#endif
+    convert_scalar<rgba8unorm, rgba32f>(src + 4 * i, dst + 16 * i, count - i);
+}
+
+void rgba32f_to_rgba8unorm(const std::byte* src, std::byte* dst, size_t count)
+{
+    size_t i = 0;
+#if defined(GFX_CONVERSION_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        const float*  in = reinterpret_cast<const float*>(src + 16 * i);
+        const __m128i lo = _mm_packs_epi32(unorm8(_mm_loadu_ps(in)), unorm8(_mm_loadu_ps(in + 4)));
+        const __m128i hi = _mm_packs_epi32(unorm8(_mm_loadu_ps(in + 8)), unorm8(_mm_loadu_ps(in + 12)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), _mm_packus_epi16(lo, hi));
+    }
+#elif defined(GFX_CONVERSION_NEON)
+    const float32x4_t scale = vdupq_n_f32(255.f);
+    const float32x4_t zero  = vdupq_n_f32(0.f);
+    const float32x4_t one   = vdupq_n_f32(1.f);
+    for (; i + 4 <= count; i += 4) {
+        const float* in = reinterpret_cast<const float*>(src + 16 * i);
+        uint32x4_t   c[4];
+        // vcvtaq rounds half away from zero like glm::round.
+        for (int j = 0; j < 4; ++j) c[j] = vcvtaq_u32_f32(vmulq_f32(vminq_f32(vmaxq_f32(vld1q_f32(in + 4 * j), zero), one), scale));
+        const uint16x8_t lo = vcombine_u16(vmovn_u32(c[0]), vmovn_u32(c[1]));
+        const uint16x8_t hi = vcombine_u16(vmovn_u32(c[2]), vmovn_u32(c[3]));
+        vst1q_u8(reinterpret_cast<uint8_t*>(dst + 4 * i), vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+    }
+#endif
+    convert_scalar<rgba32f, rgba8unorm>(src + 16 * i, dst + 4 * i, count - i);
+}
+
+void rgba32f_to_rgba16f(const std::byte* src, std::byte* dst, size_t count)
+{
+    size_t i = 0;
+#if defined(GFX_CONVERSION_F16C)
+    for (; i + 2 <= count; i += 2) {
+        const __m256 v = _mm256_loadu_ps(reinterpret_cast<const float*>(src + 16 * i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8 * i), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+    }
+#elif defined(GFX_CONVERSION_NEON)
+    for (; i < count; ++i) {
+        const float32x4_t v = vld1q_f32(reinterpret_cast<const float*>(src + 16 * i));
+        vst1_u16(reinterpret_cast<uint16_t*>(dst + 8 * i), vreinterpret_u16_f16(vcvt_f16_f32(v)));
+    }
+#endif
+    convert_scalar<rgba32f, rgba16f>(src + 16 * i, dst + 8 * i, count - i);
+}
+
+void rgba16f_to_rgba32f(const std::byte* src, std::byte* dst, size_t count)
+{
+    size_t i = 0;
+#if defined(GFX_CONVERSION_F16C)
+    for (; i + 2 <= count; i += 2) {
+        const __m128i halfs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8 * i));
+        _mm256_storeu_ps(reinterpret_cast<float*>(dst + 16 * i), _mm256_cvtph_ps(halfs));
+    }
+#elif defined(GFX_CONVERSION_NEON)
+    for (; i < count; ++i) {
+        const uint16x4_t halfs = vld1_u16(reinterpret_cast<const uint16_t*>(src + 8 * i));
+        vst1q_f32(reinterpret_cast<float*>(dst + 16 * i), vcvt_f32_f16(vreinterpret_f16_u16(halfs)));
+    }
+#endif
+    convert_scalar<rgba16f, rgba32f>(src + 8 * i, dst + 16 * i, count - i);
+}
+
+void rgba32f_to_r11g11b10f(const std::byte* src, std::byte* dst, size_t count)
+{
+    size_t i = 0;
+#if defined(GFX_CONVERSION_SSE2)
+    for (; i + 4 <= count; i += 4) {
+        const float* in = reinterpret_cast<const float*>(src + 16 * i);
+        __m128       r  = _mm_loadu_ps(in);
+        __m128       g  = _mm_loadu_ps(in + 4);
+        __m128       b  = _mm_loadu_ps(in + 8);
+        __m128       a  = _mm_loadu_ps(in + 12);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+
+        const __m128i packed = _mm_or_si128(_mm_or_si128(small_float<17, 0x7c0, 0x3f>(r), _mm_slli_epi32(small_float<17, 0x7c0, 0x3f>(g), 11)),
+                                            _mm_slli_epi32(small_float<18, 0x3e0, 0x1f>(b), 22));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), packed);
+    }
+#endif
+    convert_scalar<rgba32f, r11g11b10f>(src + 16 * i, dst + 4 * i, count - i);
+}
+
+void rgba32f_to_rgb9e5(const std::byte* src, std::byte* dst, size_t count)
+{
+    size_t i = 0;
+#if defined(GFX_CONVERSION_SSE2)
+    // Same steps as glm::packF3x9_E1x5, the power-of-two divisions are exact multiplications.
+    const __m128 max_value = _mm_set1_ps(0.5f * 65536.f);
+    const __m128 zero      = _mm_setzero_ps();
+    const __m128 half      = _mm_set1_ps(0.5f);
+    for (; i + 4 <= count; i += 4) {
+        const float* in = reinterpret_cast<const float*>(src + 16 * i);
+        __m128       r  = _mm_loadu_ps(in);
+        __m128       g  = _mm_loadu_ps(in + 4);
+        __m128       b  = _mm_loadu_ps(in + 8);
+        __m128       a  = _mm_loadu_ps(in + 12);
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+        r = _mm_min_ps(_mm_max_ps(r, zero), max_value);
+        g = _mm_min_ps(_mm_max_ps(g, zero), max_value);
+        b = _mm_min_ps(_mm_max_ps(b, zero), max_value);
+
+        const __m128  max_color = _mm_max_ps(r, _mm_max_ps(g, b));
+        const __m128i log2      = _mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(max_color), 23), _mm_set1_epi32(127));
+        const __m128i too_small = _mm_cmplt_epi32(log2, _mm_set1_epi32(-16));
+        const __m128i exponent_p =
+                _mm_add_epi32(_mm_or_si128(_mm_and_si128(too_small, _mm_set1_epi32(-16)), _mm_andnot_si128(too_small, log2)),
+                              _mm_set1_epi32(16));
+
+        const __m128  max_shared = _mm_cvtepi32_ps(
+                _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(max_color, exp2i(_mm_sub_epi32(_mm_set1_epi32(24), exponent_p))), half)));
+        const __m128i exponent =
+                _mm_sub_epi32(exponent_p, _mm_castps_si128(_mm_cmpeq_ps(max_shared, _mm_set1_ps(512.f))));
+        const __m128 scale = exp2i(_mm_sub_epi32(_mm_set1_epi32(24), exponent));
+
+        const __m128i cr = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(r, scale), half));
+        const __m128i cg = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(g, scale), half));
+        const __m128i cb = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(b, scale), half));
+        const __m128i packed =
+                _mm_or_si128(_mm_or_si128(cr, _mm_slli_epi32(cg, 9)), _mm_or_si128(_mm_slli_epi32(cb, 18), _mm_slli_epi32(exponent, 27)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), packed);
+    }
+#endif
+    convert_scalar<rgba32f, rgb9e5>(src + 16 * i, dst + 4 * i, count - i);
+}
+
+// Image files are mostly decoded to RGB, so these only append an opaque alpha channel to each pixel.
+void rgb8unorm_to_rgba8unorm(const std::byte* src, std::byte* dst, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        memcpy(dst + 4 * i, src + 3 * i, 3);
+        dst[4 * i + 3] = std::byte(0xff);
+    }
+}
+
+void rgb32f_to_rgba32f(const std::byte* src, std::byte* dst, size_t count)
+{
+    constexpr float one = 1.f;
+    for (size_t i = 0; i < count; ++i) {
+        memcpy(dst + 16 * i, src + 12 * i, 12);
+        memcpy(dst + 16 * i + 12, &one, sizeof(one));
+    }
+}
+}    // namespace
+
+pixel_conversion_fun find_pixel_conversion(const format from, const format to) noexcept
+{
+    if (from == rgba8unorm && to == rgba32f) return &rgba8unorm_to_rgba32f;
+    if (from == rgba32f && to == rgba8unorm) return &rgba32f_to_rgba8unorm;
+    if (from == rgba32f && to == rgba16f) return &rgba32f_to_rgba16f;
+    if (from == rgba16f && to == rgba32f) return &rgba16f_to_rgba32f;
+    if (from == rgba32f && to == r11g11b10f) return &rgba32f_to_r11g11b10f;
+    if (from == rgba32f && to == rgb9e5) return &rgba32f_to_rgb9e5;
+    if (from == rgb8unorm && to == rgba8unorm) return &rgb8unorm_to_rgba8unorm;
+    if (from == rgb32f && to == rgba32f) return &rgb32f_to_rgba32f;
+    return nullptr;
+}
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,14 @@
+#pragma once
+#include "formats.hpp"
+#include <cstddef>
+
+namespace gfx {
+inline namespace v1 {
+// Converts count consecutive pixels from one format to another.
+using pixel_conversion_fun = void (*)(const std::byte* src, std::byte* dst, size_t count);
+
+// Returns a vectorized conversion between two formats, or nullptr if there is none for the format pair. The results are
+// the same as decoding and encoding each pixel with pixel_kernel.
+pixel_conversion_fun find_pixel_conversion(format from, format to) noexcept;
+}    // namespace v1
+}    // namespace gfx
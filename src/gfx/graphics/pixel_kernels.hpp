@@ -0,0 +1,332 @@
+#pragma once
+#include "formats.hpp"
+#include <cstring>
+#include <glm/ext.hpp>
+#include <glm/gtc/packing.hpp>
+#include <limits>
+
+namespace gfx {
+inline namespace v1 {
+// Load and store functions for one pixel format, resolved at compile time. Normalized and floating-point formats use
+// glm::vec4 values, unsigned and signed integer formats use glm::uvec4 and glm::ivec4 values. Missing components are
+// loaded as zero, missing alpha components of non-integer formats as one.
+template<format Format>
+struct pixel_kernel;
+
+namespace detail {
+template<typename V, glm::length_t L, typename T, glm::qualifier Q>
+V expand(const glm::vec<L, T, Q>& v, typename V::value_type fill, typename V::value_type alpha)
+{
+    V result(fill, fill, fill, alpha);
+    for (glm::length_t i = 0; i < L; ++i) result[i] = typename V::value_type(v[i]);
+    return result;
+}
+
+template<glm::length_t L, typename V>
+glm::vec<L, typename V::value_type> shrink(const V& v)
+{
+    glm::vec<L, typename V::value_type> result;
+    for (glm::length_t i = 0; i < L; ++i) result[i] = v[i];
+    return result;
+}
+
+template<typename T>
+T read(const std::byte* src)
+{
+    T value;
+    memcpy(&value, src, sizeof(T));
+    return value;
+}
+
+template<typename T>
+void write(std::byte* dst, const T& value)
+{
+    memcpy(dst, &value, sizeof(T));
+}
+
+template<typename T, glm::length_t L>
+struct unorm_kernel
+{
+    using value_type            = glm::vec4;
+    constexpr static size_t size = sizeof(T) * L;
+
+    static value_type load(const std::byte* src)
+    {
+        return expand<value_type>(glm::vec<L, float>(read<glm::vec<L, T>>(src)) * (1.f / std::numeric_limits<T>::max()), 0.f, 1.f);
+    }
+    static void store(std::byte* dst, const value_type& v)
+    {
+        write(dst, glm::vec<L, T>(glm::round(glm::clamp(shrink<L>(v), 0.f, 1.f) * float(std::numeric_limits<T>::max()))));
+    }
+};
+
+template<typename T, glm::length_t L>
+struct snorm_kernel
+{
+    using value_type            = glm::vec4;
+    constexpr static size_t size = sizeof(T) * L;
+
+    static value_type load(const std::byte* src)
+    {
+        const auto v = glm::vec<L, float>(read<glm::vec<L, T>>(src)) * (1.f / std::numeric_limits<T>::max());
+        return expand<value_type>(glm::clamp(v, -1.f, 1.f), 0.f, 1.f);
+    }
+    static void store(std::byte* dst, const value_type& v)
+    {
+        write(dst, glm::vec<L, T>(glm::round(glm::clamp(shrink<L>(v), -1.f, 1.f) * float(std::numeric_limits<T>::max()))));
+    }
+};
+
+template<typename T, glm::length_t L, typename Value>
+struct integer_kernel
+{
+    using value_type            = Value;
+    constexpr static size_t size = sizeof(T) * L;
+
+    static value_type load(const std::byte* src) { return expand<value_type>(read<glm::vec<L, T>>(src), 0, 0); }
+    static void       store(std::byte* dst, const value_type& v) { write(dst, glm::vec<L, T>(shrink<L>(v))); }
+};
+
+template<glm::length_t L>
+struct float_kernel
+{
+    using value_type            = glm::vec4;
+    constexpr static size_t size = sizeof(float) * L;
+
+    static value_type load(const std::byte* src) { return expand<value_type>(read<glm::vec<L, float>>(src), 0.f, 1.f); }
+    static void       store(std::byte* dst, const value_type& v) { write(dst, shrink<L>(v)); }
+};
+
+// Rounds to nearest even like the F16C and NEON conversions, glm::packHalf truncates. NaNs stay quiet NaNs.
+inline uint16_t pack_half(const float value)
+{
+    uint32_t bits = read<uint32_t>(reinterpret_cast<const std::byte*>(&value));
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    bits &= 0x7fffffff;
+
+    uint32_t half;
+    if (bits >= 0x47800000)
+    {
+        // At least 2^16, infinity or NaN.
+        half = bits > 0x7f800000 ? 0x7e00 | ((bits >> 13) & 0x3ff) : 0x7c00;
+    }
+    else if (bits < 0x38800000)
+    {
+        // Subnormal halfs are rounded by the float addition, 0.5 aligns the mantissa to their precision.
+        const float shifted = read<float>(reinterpret_cast<const std::byte*>(&bits)) + 0.5f;
+        half                = read<uint32_t>(reinterpret_cast<const std::byte*>(&shifted)) - 0x3f000000;
+    }
+    else
+    {
+        // Rebiases the exponent and rounds the dropped mantissa bits, carries overflow into the exponent.
+        half = (bits + 0xc8000fff + ((bits >> 13) & 1)) >> 13;
+    }
+    return uint16_t(sign | half);
+}
+
+inline float unpack_half(const uint16_t half)
+{
+    const uint32_t sign     = uint32_t(half & 0x8000) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1f;
+    const uint32_t mantissa = half & 0x3ff;
+    if (exponent == 0) return (sign ? -1.f : 1.f) * float(mantissa) * (1.f / 16777216.f);
+
+    const uint32_t bits = exponent == 0x1f ? sign | 0x7f800000 | (mantissa << 13) | (mantissa ? 0x400000 : 0)
+                                           : sign | ((exponent + 112) << 23) | (mantissa << 13);
+    return read<float>(reinterpret_cast<const std::byte*>(&bits));
+}
+
+template<glm::length_t L>
+struct half_kernel
+{
+    using value_type            = glm::vec4;
+    constexpr static size_t size = sizeof(uint16_t) * L;
+
+    static value_type load(const std::byte* src)
+    {
+        const auto         halfs = read<glm::vec<L, uint16_t>>(src);
+        glm::vec<L, float> v;
+        for (glm::length_t i = 0; i < L; ++i) v[i] = unpack_half(halfs[i]);
+        return expand<value_type>(v, 0.f, 1.f);
+    }
+    static void store(std::byte* dst, const value_type& v)
+    {
+        glm::vec<L, uint16_t> halfs;
+        for (glm::length_t i = 0; i < L; ++i) halfs[i] = pack_half(v[i]);
+        write(dst, halfs);
+    }
+};
+
+template<typename Packed, typename Unpacked, Unpacked (*Unpack)(Packed), Packed (*Pack)(const Unpacked&)>
+struct packed_kernel
+{
+    using value_type            = glm::vec4;
+    constexpr static size_t size = sizeof(Packed);
+
+    static value_type load(const std::byte* src) { return expand<value_type>(Unpack(read<Packed>(src)), 0.f, 1.f); }
+    static void       store(std::byte* dst, const value_type& v) { write(dst, Pack(Unpacked(v))); }
+};
+
+template<glm::length_t L>
+struct bgr_kernel
+{
+    using value_type            = glm::vec4;
+    constexpr static size_t size = L;
+
+    static value_type load(const std::byte* src)
+    {
+        const auto v = unorm_kernel<uint8_t, L>::load(src);
+        return value_type(v.b, v.g, v.r, v.a);
+    }
+    static void store(std::byte* dst, const value_type& v) { unorm_kernel<uint8_t, L>::store(dst, value_type(v.b, v.g, v.r, v.a)); }
+};
+}    // namespace detail
+
+// clang-format off
+template<> struct pixel_kernel<r8unorm> : detail::unorm_kernel<uint8_t, 1> {};
+template<> struct pixel_kernel<rg8unorm> : detail::unorm_kernel<uint8_t, 2> {};
+template<> struct pixel_kernel<rgb8unorm> : detail::unorm_kernel<uint8_t, 3> {};
+template<> struct pixel_kernel<rgba8unorm> : detail::unorm_kernel<uint8_t, 4> {};
+template<> struct pixel_kernel<r16unorm> : detail::unorm_kernel<uint16_t, 1> {};
+template<> struct pixel_kernel<rg16unorm> : detail::unorm_kernel<uint16_t, 2> {};
+template<> struct pixel_kernel<rgb16unorm> : detail::unorm_kernel<uint16_t, 3> {};
+template<> struct pixel_kernel<rgba16unorm> : detail::unorm_kernel<uint16_t, 4> {};
+
+template<> struct pixel_kernel<r8snorm> : detail::snorm_kernel<int8_t, 1> {};
+template<> struct pixel_kernel<rg8snorm> : detail::snorm_kernel<int8_t, 2> {};
+template<> struct pixel_kernel<rgb8snorm> : detail::snorm_kernel<int8_t, 3> {};
+template<> struct pixel_kernel<rgba8snorm> : detail::snorm_kernel<int8_t, 4> {};
+template<> struct pixel_kernel<r16snorm> : detail::snorm_kernel<int16_t, 1> {};
+template<> struct pixel_kernel<rg16snorm> : detail::snorm_kernel<int16_t, 2> {};
+template<> struct pixel_kernel<rgb16snorm> : detail::snorm_kernel<int16_t, 3> {};
+template<> struct pixel_kernel<rgba16snorm> : detail::snorm_kernel<int16_t, 4> {};
+
+template<> struct pixel_kernel<r8u> : detail::integer_kernel<uint8_t, 1, glm::uvec4> {};
+template<> struct pixel_kernel<rg8u> : detail::integer_kernel<uint8_t, 2, glm::uvec4> {};
+template<> struct pixel_kernel<rgb8u> : detail::integer_kernel<uint8_t, 3, glm::uvec4> {};
+template<> struct pixel_kernel<rgba8u> : detail::integer_kernel<uint8_t, 4, glm::uvec4> {};
+template<> struct pixel_kernel<r16u> : detail::integer_kernel<uint16_t, 1, glm::uvec4> {};
+template<> struct pixel_kernel<rg16u> : detail::integer_kernel<uint16_t, 2, glm::uvec4> {};
+template<> struct pixel_kernel<rgb16u> : detail::integer_kernel<uint16_t, 3, glm::uvec4> {};
+template<> struct pixel_kernel<rgba16u> : detail::integer_kernel<uint16_t, 4, glm::uvec4> {};
+template<> struct pixel_kernel<r32u> : detail::integer_kernel<uint32_t, 1, glm::uvec4> {};
+template<> struct pixel_kernel<rg32u> : detail::integer_kernel<uint32_t, 2, glm::uvec4> {};
+template<> struct pixel_kernel<rgb32u> : detail::integer_kernel<uint32_t, 3, glm::uvec4> {};
+template<> struct pixel_kernel<rgba32u> : detail::integer_kernel<uint32_t, 4, glm::uvec4> {};
+
+template<> struct pixel_kernel<r8i> : detail::integer_kernel<int8_t, 1, glm::ivec4> {};
+template<> struct pixel_kernel<rg8i> : detail::integer_kernel<int8_t, 2, glm::ivec4> {};
+template<> struct pixel_kernel<rgb8i> : detail::integer_kernel<int8_t, 3, glm::ivec4> {};
+template<> struct pixel_kernel<rgba8i> : detail::integer_kernel<int8_t, 4, glm::ivec4> {};
+template<> struct pixel_kernel<r16i> : detail::integer_kernel<int16_t, 1, glm::ivec4> {};
+template<> struct pixel_kernel<rg16i> : detail::integer_kernel<int16_t, 2, glm::ivec4> {};
+template<> struct pixel_kernel<rgb16i> : detail::integer_kernel<int16_t, 3, glm::ivec4> {};
+template<> struct pixel_kernel<rgba16i> : detail::integer_kernel<int16_t, 4, glm::ivec4> {};
+template<> struct pixel_kernel<r32i> : detail::integer_kernel<int32_t, 1, glm::ivec4> {};
+template<> struct pixel_kernel<rg32i> : detail::integer_kernel<int32_t, 2, glm::ivec4> {};
+template<> struct pixel_kernel<rgb32i> : detail::integer_kernel<int32_t, 3, glm::ivec4> {};
+template<> struct pixel_kernel<rgba32i> : detail::integer_kernel<int32_t, 4, glm::ivec4> {};
+
+template<> struct pixel_kernel<r16f> : detail::half_kernel<1> {};
+template<> struct pixel_kernel<rg16f> : detail::half_kernel<2> {};
+template<> struct pixel_kernel<rgb16f> : detail::half_kernel<3> {};
+template<> struct pixel_kernel<rgba16f> : detail::half_kernel<4> {};
+template<> struct pixel_kernel<r32f> : detail::float_kernel<1> {};
+template<> struct pixel_kernel<rg32f> : detail::float_kernel<2> {};
+template<> struct pixel_kernel<rgb32f> : detail::float_kernel<3> {};
+template<> struct pixel_kernel<rgba32f> : detail::float_kernel<4> {};
+
+template<> struct pixel_kernel<rgb5a1unorm> : detail::packed_kernel<glm::uint16, glm::vec4, glm::unpackUnorm3x5_1x1, glm::packUnorm3x5_1x1> {};
+template<> struct pixel_kernel<rgb10a2unorm> : detail::packed_kernel<glm::uint32, glm::vec4, glm::unpackUnorm3x10_1x2, glm::packUnorm3x10_1x2> {};
+template<> struct pixel_kernel<rgb10a2snorm> : detail::packed_kernel<glm::uint32, glm::vec4, glm::unpackSnorm3x10_1x2, glm::packSnorm3x10_1x2> {};
+template<> struct pixel_kernel<r11g11b10f> : detail::packed_kernel<glm::uint32, glm::vec3, glm::unpackF2x11_1x10, glm::packF2x11_1x10> {};
+template<> struct pixel_kernel<rgb9e5> : detail::packed_kernel<glm::uint32, glm::vec3, glm::unpackF3x9_E1x5, glm::packF3x9_E1x5> {};
+template<> struct pixel_kernel<r5g6b5unorm> : detail::packed_kernel<glm::uint16, glm::vec3, glm::unpackUnorm1x5_1x6_1x5, glm::packUnorm1x5_1x6_1x5> {};
+
+template<> struct pixel_kernel<bgr8unorm> : detail::bgr_kernel<3> {};
+template<> struct pixel_kernel<bgra8unorm> : detail::bgr_kernel<4> {};
+// clang-format on
+
+// Calls fun(pixel_kernel<Format>{}) with the kernel of the given format. Dispatching once per operation instead of once
+// per pixel lets the compiler inline the kernel into the loops of fun. Returns false for formats without a kernel.
+template<typename Fun>
+bool dispatch_format(format fmt, Fun&& fun)
+{
+    switch (fmt)
+    {
+    case r8unorm: fun(pixel_kernel<r8unorm>{}); return true;
+    case rg8unorm: fun(pixel_kernel<rg8unorm>{}); return true;
+    case rgb8unorm: fun(pixel_kernel<rgb8unorm>{}); return true;
+    case rgba8unorm: fun(pixel_kernel<rgba8unorm>{}); return true;
+    case r16unorm: fun(pixel_kernel<r16unorm>{}); return true;
+    case rg16unorm: fun(pixel_kernel<rg16unorm>{}); return true;
+    case rgb16unorm: fun(pixel_kernel<rgb16unorm>{}); return true;
+    case rgba16unorm: fun(pixel_kernel<rgba16unorm>{}); return true;
+
+    case r8snorm: fun(pixel_kernel<r8snorm>{}); return true;
+    case rg8snorm: fun(pixel_kernel<rg8snorm>{}); return true;
+    case rgb8snorm: fun(pixel_kernel<rgb8snorm>{}); return true;
+    case rgba8snorm: fun(pixel_kernel<rgba8snorm>{}); return true;
+    case r16snorm: fun(pixel_kernel<r16snorm>{}); return true;
+    case rg16snorm: fun(pixel_kernel<rg16snorm>{}); return true;
+    case rgb16snorm: fun(pixel_kernel<rgb16snorm>{}); return true;
+    case rgba16snorm: fun(pixel_kernel<rgba16snorm>{}); return true;
+
+    case r8u: fun(pixel_kernel<r8u>{}); return true;
+    case rg8u: fun(pixel_kernel<rg8u>{}); return true;
+    case rgb8u: fun(pixel_kernel<rgb8u>{}); return true;
+    case rgba8u: fun(pixel_kernel<rgba8u>{}); return true;
+    case r16u: fun(pixel_kernel<r16u>{}); return true;
+    case rg16u: fun(pixel_kernel<rg16u>{}); return true;
+    case rgb16u: fun(pixel_kernel<rgb16u>{}); return true;
+    case rgba16u: fun(pixel_kernel<rgba16u>{}); return true;
+    case r32u: fun(pixel_kernel<r32u>{}); return true;
+    case rg32u: fun(pixel_kernel<rg32u>{}); return true;
+    case rgb32u: fun(pixel_kernel<rgb32u>{}); return true;
+    case rgba32u: fun(pixel_kernel<rgba32u>{}); return true;
+
+    case r8i: fun(pixel_kernel<r8i>{}); return true;
+    case rg8i: fun(pixel_kernel<rg8i>{}); return true;
+    case rgb8i: fun(pixel_kernel<rgb8i>{}); return true;
+    case rgba8i: fun(pixel_kernel<rgba8i>{}); return true;
+    case r16i: fun(pixel_kernel<r16i>{}); return true;
+    case rg16i: fun(pixel_kernel<rg16i>{}); return true;
+    case rgb16i: fun(pixel_kernel<rgb16i>{}); return true;
+    case rgba16i: fun(pixel_kernel<rgba16i>{}); return true;
+    case r32i: fun(pixel_kernel<r32i>{}); return true;
+    case rg32i: fun(pixel_kernel<rg32i>{}); return true;
+    case rgb32i: fun(pixel_kernel<rgb32i>{}); return true;
+    case rgba32i: fun(pixel_kernel<rgba32i>{}); return true;
+
+    case r16f: fun(pixel_kernel<r16f>{}); return true;
+    case rg16f: fun(pixel_kernel<rg16f>{}); return true;
+    case rgb16f: fun(pixel_kernel<rgb16f>{}); return true;
+    case rgba16f: fun(pixel_kernel<rgba16f>{}); return true;
+    case r32f: fun(pixel_kernel<r32f>{}); return true;
+    case rg32f: fun(pixel_kernel<rg32f>{}); return true;
+    case rgb32f: fun(pixel_kernel<rgb32f>{}); return true;
+    case rgba32f: fun(pixel_kernel<rgba32f>{}); return true;
+
+    case rgb5a1unorm: fun(pixel_kernel<rgb5a1unorm>{}); return true;
+    case rgb10a2unorm: fun(pixel_kernel<rgb10a2unorm>{}); return true;
+    case rgb10a2snorm: fun(pixel_kernel<rgb10a2snorm>{}); return true;
+    case r11g11b10f: fun(pixel_kernel<r11g11b10f>{}); return true;
+    case rgb9e5: fun(pixel_kernel<rgb9e5>{}); return true;
+    case r5g6b5unorm: fun(pixel_kernel<r5g6b5unorm>{}); return true;
+
+    case bgr8unorm: fun(pixel_kernel<bgr8unorm>{}); return true;
+    case bgra8unorm: fun(pixel_kernel<bgra8unorm>{}); return true;
+    default: return false;
+    }
+}
+
+// Returns whether the pixels of the given format are loaded and stored as values of type T.
+template<typename T>
+bool has_value_type(format fmt)
+{
+    bool result = false;
+    dispatch_format(fmt, [&](auto kernel) { result = std::is_same_v<typename decltype(kernel)::value_type, T>; });
+    return result;
+}
+}    // namespace v1
+}    // namespace gfx
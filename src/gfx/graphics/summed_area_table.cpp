@@ -0,0 +1,189 @@
+#include "summed_area_table.hpp"
+#include "image_resampling.hpp"
+
+namespace gfx {
+inline namespace v1 {
+namespace {
+// Columns summed by one task, so that every task runs along whole cache lines of consecutive rows.
+constexpr uint32_t column_block = 256;
+
+// Tables have a leading row and column of zeros in every slice, so that rectangles never need a special case at the
+// borders. Slices are not padded, as most images have only one.
+size_t table_row(const extent& size)
+{
+    return size_t(size.width) + 1;
+}
+
+size_t table_slice(const extent& size)
+{
+    return table_row(size) * (size_t(size.height) + 1);
+}
+
+// Adds every row of a slice to the next one, in parallel over blocks of columns of all slices.
+void sum_columns(std::vector<glm::dvec4>& table, const extent& size)
+{
+    const size_t  row    = table_row(size);
+    const int64_t blocks = int64_t((row + column_block - 1) / column_block);
+#pragma omp parallel for schedule(static)
+    for (int64_t task = 0; task < blocks * size.depth; ++task) {
+        glm::dvec4*  slice = &table[table_slice(size) * size_t(task / blocks)];
+        const size_t begin = size_t(task % blocks) * column_block;
+        const size_t end   = std::min(begin + column_block, row);
+        for (uint32_t y = 1; y <= size.height; ++y)
+            for (size_t x = begin; x < end; ++x) slice[y * row + x] += slice[(y - 1) * row + x];
+    }
+}
+
+// Adds every slice to the next one, in parallel over blocks of the values of a slice.
+void sum_slices(std::vector<glm::dvec4>& table, const extent& size)
+{
+    const size_t  slice  = table_slice(size);
+    const int64_t blocks = int64_t((slice + column_block - 1) / column_block);
+#pragma omp parallel for schedule(static)
+    for (int64_t task = 0; task < blocks; ++task) {
+        const size_t begin = size_t(task) * column_block;
+        const size_t end   = std::min(begin + column_block, slice);
+        for (uint32_t z = 1; z < size.depth; ++z)
+            for (size_t i = begin; i < end; ++i) table[z * slice + i] += table[(z - 1) * slice + i];
+    }
+}
+
+// Rows are loaded and summed in parallel, then the row sums are summed along y and z.
+void build_tables(const detail::row_loader& loader, std::vector<glm::dvec4>& sums, std::vector<glm::dvec4>* squares)
+{
+    const extent& size = loader.extents();
+    const size_t  row  = table_row(size);
+    sums.assign(table_slice(size) * size.depth, glm::dvec4(0));
+    if (squares) squares->assign(sums.size(), glm::dvec4(0));
+
+    detail::parallel_rows<glm::vec4>(size, size.width, [&](const glm::uvec3& start, glm::vec4* pixels) {
+        loader.load(int64_t(start.z) * size.height + start.y, pixels);
+        const size_t first = table_slice(size) * start.z + row * (size_t(start.y) + 1) + 1;
+        glm::dvec4   sum(0);
+        for (uint32_t x = 0; x < size.width; ++x) sums[first + x] = sum += glm::dvec4(pixels[x]);
+        if (!squares) return;
+        glm::dvec4 square_sum(0);
+        for (uint32_t x = 0; x < size.width; ++x) {
+            const glm::dvec4 p(pixels[x]);
+            (*squares)[first + x] = square_sum += p * p;
+        }
+    });
+
+    for (auto* table : {&sums, squares}) {
+        if (!table) continue;
+        sum_columns(*table, size);
+        sum_slices(*table, size);
+    }
+}
+
+void check_format(const format fmt)
+{
+    if (!has_value_type<glm::vec4>(fmt))
+        throw std::invalid_argument("Summed-area tables are only built for images of normalized and floating-point formats.");
+}
+
+template<typename Image>
+host_image blur_image(const Image& image, const glm::uvec3& radius)
+{
+    const summed_area_table table(image);
+    const extent&           size = image.extents();
+    host_image              result(image.pixel_format(), size);
+    detail::parallel_rows<glm::vec4>(size, size.width, [&](const glm::uvec3& start, glm::vec4* row) {
+        table.box_means(start, size.width, radius, row);
+        result.store_row(start, size.width, row);
+    });
+    return result;
+}
+}    // namespace
+
+summed_area_table::summed_area_table(const host_image& image, const bool with_squares) : _extent(image.extents())
+{
+    check_format(image.pixel_format());
+    build_tables(detail::row_loader(image, color_space::linear), _sums, with_squares ? &_squares : nullptr);
+}
+
+summed_area_table::summed_area_table(const host_image_view& image, const bool with_squares) : _extent(image.extents())
+{
+    check_format(image.pixel_format());
+    build_tables(detail::row_loader(image, color_space::linear), _sums, with_squares ? &_squares : nullptr);
+}
+
+glm::dvec4 summed_area_table::rectangle(const std::vector<glm::dvec4>& table, const uint32_t z, const glm::uvec3& min,
+                                        const glm::uvec3& max) const noexcept
+{
+    const size_t      row   = table_row(_extent);
+    const glm::dvec4* slice = &table[table_slice(_extent) * z];
+    return slice[max.y * row + max.x] - slice[max.y * row + min.x] - slice[min.y * row + max.x] + slice[min.y * row + min.x];
+}
+
+glm::dvec4 summed_area_table::sum(const glm::uvec3& min, glm::uvec3 max) const noexcept
+{
+    max = glm::min(max, _extent.vec);
+    if (min.x >= max.x || min.y >= max.y || min.z >= max.z) return glm::dvec4(0);
+    const glm::dvec4 sum = rectangle(_sums, max.z - 1, min, max);
+    return min.z == 0 ? sum : sum - rectangle(_sums, min.z - 1, min, max);
+}
+
+glm::dvec4 summed_area_table::mean(const glm::uvec3& min, glm::uvec3 max) const noexcept
+{
+    max = glm::min(max, _extent.vec);
+    if (min.x >= max.x || min.y >= max.y || min.z >= max.z) return glm::dvec4(0);
+    return sum(min, max) / double(uint64_t(max.x - min.x) * (max.y - min.y) * (max.z - min.z));
+}
+
+glm::dvec4 summed_area_table::variance(const glm::uvec3& min, glm::uvec3 max) const
+{
+    if (!has_squares()) throw std::invalid_argument("Variances need a summed-area table with squares.");
+    max = glm::min(max, _extent.vec);
+    if (min.x >= max.x || min.y >= max.y || min.z >= max.z) return glm::dvec4(0);
+
+    const double     count  = double(uint64_t(max.x - min.x) * (max.y - min.y) * (max.z - min.z));
+    glm::dvec4       square = rectangle(_squares, max.z - 1, min, max);
+    if (min.z != 0) square -= rectangle(_squares, min.z - 1, min, max);
+    const glm::dvec4 mean   = sum(min, max) / count;
+    return glm::max(square / count - mean * mean, glm::dvec4(0));
+}
+
+void summed_area_table::box_means(const glm::uvec3& start, const uint32_t count, const glm::uvec3& radius,
+                                  glm::vec4* means) const noexcept
+{
+    const glm::uvec3 min = start - glm::min(start, radius);
+    const glm::uvec3 max = glm::min(start + radius + 1u, _extent.vec);
+    const size_t     row = table_row(_extent);
+
+    // The sums of the slices up to max.z - 1 minus the ones up to min.z - 1, at the first and last row of the boxes.
+    const glm::dvec4* top    = &_sums[table_slice(_extent) * (max.z - 1) + row * min.y];
+    const glm::dvec4* bottom = top + row * (max.y - min.y);
+    const glm::dvec4* front  = min.z == 0 ? nullptr : &_sums[table_slice(_extent) * (min.z - 1) + row * min.y];
+    const double      rows   = double(max.y - min.y) * (max.z - min.z);
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t x     = start.x + i;
+        const uint32_t x0    = x - std::min(x, radius.x);
+        const uint32_t x1    = std::min(x + radius.x + 1, _extent.width);
+        glm::dvec4     sum   = bottom[x1] - bottom[x0] - top[x1] + top[x0];
+        if (front) sum -= front[row * (max.y - min.y) + x1] - front[row * (max.y - min.y) + x0] - front[x1] + front[x0];
+        means[i] = glm::vec4(sum / (rows * (x1 - x0)));
+    }
+}
+
+bool summed_area_table::has_squares() const noexcept
+{
+    return !_squares.empty();
+}
+
+const extent& summed_area_table::extents() const noexcept
+{
+    return _extent;
+}
+
+host_image box_blur(const host_image& image, const glm::uvec3& radius)
+{
+    return blur_image(image, radius);
+}
+
+host_image box_blur(const host_image_view& image, const glm::uvec3& radius)
+{
+    return blur_image(image, radius);
+}
+}    // namespace v1
+}    // namespace gfx
@@ -0,0 +1,41 @@
+#pragma once
+#include "host_image.hpp"
+
+namespace gfx {
+inline namespace v1 {
+// Sums of all pixels from the origin up to every pixel, loaded as linear floating-point values and summed in double,
+// so that the sum, mean and variance of any box of pixels cost eight lookups, independently of its size. The sums of
+// the squared pixels are only kept if they are needed for variances.
+class summed_area_table
+{
+public:
+    explicit summed_area_table(const host_image& image, bool with_squares = false);
+    explicit summed_area_table(const host_image_view& image, bool with_squares = false);
+
+    // Boxes span the pixels from min up to, but excluding, max, and are clipped to the extents of the image.
+    glm::dvec4 sum(const glm::uvec3& min, glm::uvec3 max) const noexcept;
+    glm::dvec4 mean(const glm::uvec3& min, glm::uvec3 max) const noexcept;
+    // The population variance of each channel, for tables with squares.
+    glm::dvec4 variance(const glm::uvec3& min, glm::uvec3 max) const;
+    // The means of the boxes reaching radius pixels away from count pixels of a row, starting at start. The boxes share
+    // their rows and slices, so only their columns are looked up for every pixel.
+    void box_means(const glm::uvec3& start, uint32_t count, const glm::uvec3& radius, glm::vec4* means) const noexcept;
+
+    bool          has_squares() const noexcept;
+    const extent& extents() const noexcept;
+
+private:
+    // Sums of the rectangle from min to max in the slices up to z.
+    glm::dvec4 rectangle(const std::vector<glm::dvec4>& table, uint32_t z, const glm::uvec3& min, const glm::uvec3& max) const noexcept;
+
+    extent                  _extent;
+    std::vector<glm::dvec4> _sums;
+    std::vector<glm::dvec4> _squares;
+};
+
+// Replaces every pixel by the mean of the pixels at most radius pixels away on each axis, using a summed-area table.
+// Boxes are clipped at the borders. The result has the format of the image and a linear layout.
+host_image box_blur(const host_image& image, const glm::uvec3& radius);
+host_image box_blur(const host_image_view& image, const glm::uvec3& radius);
+}    // namespace v1
+}    // namespace gfx
@@ -41,6 +41,13 @@ VkFormat get_format(format f)
 	case bgr8unorm: return VK_FORMAT_B8G8R8_UNORM;
 	case bgra8unorm: return VK_FORMAT_B8G8R8A8_UNORM;
 
+    case bc1unorm: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    case bc3unorm: return VK_FORMAT_BC3_UNORM_BLOCK;
+    case bc4unorm: return VK_FORMAT_BC4_UNORM_BLOCK;
+    case bc5unorm: return VK_FORMAT_BC5_UNORM_BLOCK;
+    case bc6hf: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+    case bc7unorm: return VK_FORMAT_BC7_UNORM_BLOCK;
+
     case rgb5a1unorm: return VK_FORMAT_R5G5B5A1_UNORM_PACK16;
     case rgb10a2unorm: return VK_FORMAT_A2R10G10B10_UNORM_PACK32;
     case rgb10a2snorm: return VK_FORMAT_A2R10G10B10_SNORM_PACK32;
@@ -130,6 +137,15 @@ void device_image_implementation::initialize(uint32_t layer_dimensions, format f
 		img_create.usage = (as_attachment ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : 0) |
 			VK_IMAGE_USAGE_SAMPLED_BIT;
         break;
+    case bc1unorm:
+    case bc3unorm:
+    case bc4unorm:
+    case bc5unorm:
+    case bc6hf:
+    case bc7unorm:
+        // Compressed images can only be filled by transfers.
+        img_create.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        break;
     default:
         img_create.usage = (as_attachment ? VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT : 0) |
 			VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT;
@@ -145,6 +161,17 @@ void device_image_implementation::initialize(uint32_t layer_dimensions, format f
 }
 
 void device_image_implementation::fill_from(const host_image& image, uint32_t level, uint32_t layer)
+{
+    fill_from(handle_cast<VkBuffer>(image.storage()), level, layer);
+}
+
+void device_image_implementation::fill_from(const compressed_image& image, uint32_t level, uint32_t layer)
+{
+    // Buffer to image copies of compressed formats take the extents in pixels, like for all other formats.
+    fill_from(handle_cast<VkBuffer>(image.storage()), level, layer);
+}
+
+void device_image_implementation::fill_from(const VkBuffer storage, uint32_t level, uint32_t layer)
 {
     movable_handle<VkCommandBuffer>   cmd;
     init<VkCommandBufferAllocateInfo> cmdalloc{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
@@ -179,7 +206,6 @@ void device_image_implementation::fill_from(const host_image& image, uint32_t le
     copy.imageSubresource.baseArrayLayer = layer;
     copy.imageSubresource.layerCount     = 1;
     copy.imageSubresource.mipLevel       = level;
-    const VkBuffer storage               = handle_cast<VkBuffer>(image.storage());
     vkCmdCopyBufferToImage(cmd, storage, _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
 
     imembarr.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
@@ -200,6 +226,67 @@ void device_image_implementation::fill_from(const host_image& image, uint32_t le
     vkFreeCommandBuffers(_device, _transfer_pool, 1, &cmd);
 }
 
+void device_image_implementation::fill_from(const host_image_pyramid& pyramid, uint32_t layer)
+{
+    movable_handle<VkCommandBuffer>   cmd;
+    init<VkCommandBufferAllocateInfo> cmdalloc{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    cmdalloc.commandBufferCount = 1;
+    cmdalloc.commandPool        = _transfer_pool;
+    cmdalloc.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	check_result(vkAllocateCommandBuffers(_device, &cmdalloc, &cmd));
+
+    init<VkCommandBufferBeginInfo> beg{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    beg.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	check_result(vkBeginCommandBuffer(cmd, &beg));
+
+    // All levels are copied with one command buffer and a single submission.
+    const u32                  levels = std::min(pyramid.levels(), _levels);
+    init<VkImageMemoryBarrier> imembarr{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+    imembarr.srcAccessMask                   = 0;
+    imembarr.dstAccessMask                   = VK_ACCESS_TRANSFER_WRITE_BIT;
+    imembarr.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    imembarr.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+    imembarr.image                           = _image;
+    imembarr.oldLayout                       = VK_IMAGE_LAYOUT_UNDEFINED;
+    imembarr.newLayout                       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    imembarr.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+    imembarr.subresourceRange.baseArrayLayer = layer;
+    imembarr.subresourceRange.layerCount     = 1;
+    imembarr.subresourceRange.baseMipLevel   = 0;
+    imembarr.subresourceRange.levelCount     = levels;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr,
+                         0, nullptr, 1, &imembarr);
+
+    const auto clm = [](uint32_t i) -> u32 { return static_cast<u32>(std::max(i, 1u)); };
+    for (u32 level = 0; level < levels; ++level) {
+        init<VkBufferImageCopy> copy;
+        copy.imageExtent = VkExtent3D{clm(_extent.width >> level), clm(_extent.height >> level), clm(_extent.depth >> level)};
+        copy.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        copy.imageSubresource.baseArrayLayer = layer;
+        copy.imageSubresource.layerCount     = 1;
+        copy.imageSubresource.mipLevel       = level;
+        const VkBuffer storage               = handle_cast<VkBuffer>(pyramid[level].storage());
+        vkCmdCopyBufferToImage(cmd, storage, _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+    }
+
+    imembarr.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    imembarr.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    imembarr.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    imembarr.newLayout     = VK_IMAGE_LAYOUT_GENERAL;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_DEPENDENCY_BY_REGION_BIT, 0, nullptr,
+                         0, nullptr, 1, &imembarr);
+
+	check_result(vkEndCommandBuffer(cmd));
+    init<VkSubmitInfo> submit{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submit.commandBufferCount = 1;
+    submit.pCommandBuffers    = &cmd;
+
+	check_result(vkQueueSubmit(_transfer_queue, 1, &submit, _transfer_fence));
+	check_result(vkWaitForFences(_device, 1, &_transfer_fence, true, std::numeric_limits<uint64_t>::max()));
+	check_result(vkResetFences(_device, 1, &_transfer_fence));
+    vkFreeCommandBuffers(_device, _transfer_pool, 1, &cmd);
+}
+
 void device_image_implementation::fill_to(const host_image& image, uint32_t level, uint32_t layer)
 {
     movable_handle<VkCommandBuffer>   cmd;
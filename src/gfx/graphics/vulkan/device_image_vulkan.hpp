@@ -17,11 +17,15 @@ public:
 
     void     initialize(uint32_t layer_dimensions, format format, const extent& size, uint32_t levels, sample_count samples) override;
     void     fill_from(const host_image& image, uint32_t level, uint32_t layer) override;
+    void     fill_from(const host_image_pyramid& pyramid, uint32_t layer) override;
+    void     fill_from(const compressed_image& image, uint32_t level, uint32_t layer) override;
     void     fill_to(const host_image& image, uint32_t level, uint32_t layer) override;
     std::any api_handle() override;
     void     generate_mipmaps() override;
 
 private:
+    void fill_from(VkBuffer storage, uint32_t level, uint32_t layer);
+
     VkDevice                _device = nullptr;
     movable_handle<VkImage> _image  = nullptr;
     VkExtent3D              _extent = {1, 1, 1};
@@ -0,0 +1,702 @@
+#include "catch.hpp"
+#include <gfx/ecs/defaults/hierarchy.hpp>
+#include <gfx/ecs/ecs.hpp>
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+
+namespace {
+struct position : gfx::ecs::component<position>
+{
+    position(float x = 0.f) : x(x) {}
+    float x;
+};
+
+struct velocity : gfx::ecs::component<velocity>
+{
+    velocity(float v = 0.f) : v(v) {}
+    float v;
+};
+
+// Long enough to be allocated, so copies from destroyed labels are caught by the sanitizers.
+struct label : gfx::ecs::component<label>
+{
+    label(std::string text = {}) : text(std::move(text)) {}
+    std::string text;
+};
+
+// Moves every position by its velocity and records the size of every chunk it was given.
+struct move_system : gfx::ecs::system
+{
+    move_system(size_t chunk_size, bool thread_safe)
+    {
+        add_component_type<position>();
+        add_component_type<velocity>();
+        set_chunk_size(chunk_size);
+        if (thread_safe) set_options(gfx::ecs::system_option::thread_safe);
+    }
+
+    void update_batch(double delta, const gfx::ecs::component_batch& batch) const override
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            chunks.push_back(batch.size());
+        }
+        for (size_t i = 0; i < batch.size(); ++i) batch.get<position>(0, i).x += batch.get<velocity>(1, i).v;
+    }
+
+    mutable std::mutex          mutex;
+    mutable std::vector<size_t> chunks;
+};
+
+gfx::transform_component translation(float x, float y)
+{
+    gfx::transform_component t;
+    t.value = gfx::transform(glm::vec3(x, y, 0));
+    return t;
+}
+
+gfx::parent_component parent(gfx::ecs::entity_handle e)
+{
+    gfx::parent_component p;
+    p.parent = e;
+    return p;
+}
+}    // namespace
+
+TEST_CASE("Chunked systems", "[ecs]")
+{
+    gfx::ecs::ecs ecs;
+    std::vector<gfx::ecs::entity> entities;
+    for (int i = 0; i < 2500; ++i) entities.push_back(ecs.create_entity(position(float(i)), velocity(1.f)));
+
+    SECTION("Thread-safe systems process every entity exactly once, in chunks of at most the chunk size.")
+    {
+        move_system            system(1000, true);
+        gfx::ecs::system_list list;
+        list.add(system);
+        ecs.update(0.0, list);
+
+        std::sort(system.chunks.begin(), system.chunks.end());
+        REQUIRE(system.chunks == std::vector<size_t>{500, 1000, 1000});
+        for (int i = 0; i < 2500; ++i) REQUIRE(entities[i].get<position>()->x == float(i + 1));
+    }
+
+    SECTION("Other systems get the same chunks.")
+    {
+        move_system            system(1000, false);
+        gfx::ecs::system_list list;
+        list.add(system);
+        ecs.update(0.0, list);
+
+        REQUIRE(system.chunks == std::vector<size_t>{1000, 1000, 500});
+        for (int i = 0; i < 2500; ++i) REQUIRE(entities[i].get<position>()->x == float(i + 1));
+    }
+}
+
+TEST_CASE("Component batches", "[ecs]")
+{
+    gfx::ecs::ecs ecs;
+    for (int i = 0; i < 100; ++i) ecs.create_entity(position(float(i)));
+
+    // Doubles all positions through the contiguous column of the batch.
+    struct scale_system : gfx::ecs::system
+    {
+        scale_system() { add_component_type<position>(); }
+        void update_batch(double delta, const gfx::ecs::component_batch& batch) const override
+        {
+            REQUIRE(batch.contiguous(0));
+            REQUIRE(!batch.has_rows());
+            for (auto& p : batch.span<position>(0)) p.x *= 2.f;
+            for (size_t i = 0; i < batch.size(); ++i) REQUIRE(&batch.get<position>(0, i) == &batch.span<position>(0)[i]);
+            count += batch.size();
+        }
+        mutable size_t count = 0;
+    } system;
+
+    gfx::ecs::system_list list;
+    list.add(system);
+    ecs.update(0.0, list);
+    REQUIRE(system.count == 100);
+
+    struct sum_system : gfx::ecs::system
+    {
+        sum_system() { add_component_type<position>(); }
+        void update(double delta, gfx::ecs::component_base** components) const override
+        {
+            sum += components[0]->as<position>().x;
+        }
+        mutable float sum = 0.f;
+    } sum;
+
+    SECTION("The default update_batch forwards every entity to update.")
+    {
+        gfx::ecs::system_list sums;
+        sums.add(sum);
+        ecs.update(0.0, sums);
+        REQUIRE(sum.sum == 2.f * 99.f * 100.f / 2.f);
+    }
+}
+
+TEST_CASE("Generational entity handles", "[ecs]")
+{
+    gfx::ecs::ecs ecs;
+    const gfx::ecs::entity_handle first = ecs.create_entity(position(1.f));
+    ecs.delete_entities({&first, 1});
+
+    SECTION("Handles of deleted entities are invalid, even if their slot is reused.")
+    {
+        REQUIRE(!ecs.valid(first));
+        const gfx::ecs::entity_handle second = ecs.create_entity(position(2.f));
+        REQUIRE(second.index == first.index);
+        REQUIRE(second.generation != first.generation);
+        REQUIRE(ecs.valid(second));
+        REQUIRE(!ecs.valid(first));
+        REQUIRE(ecs.get_component<position>(first) == nullptr);
+        REQUIRE(ecs.get_component<position>(second)->x == 2.f);
+        REQUIRE(ecs.entity_count() == 1);
+    }
+}
+
+TEST_CASE("Sparse component storage", "[ecs]")
+{
+    gfx::ecs::component_storage storage(position::id);
+    std::vector<gfx::ecs::entity_handle> handles;
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        handles.push_back({i * 3, 1});
+        const position p{float(i)};
+        storage.emplace(handles.back(), &p, 1);
+    }
+
+    SECTION("Components are found by their entities.")
+    {
+        REQUIRE(storage.size() == 10);
+        for (uint32_t i = 0; i < 10; ++i) REQUIRE(storage.get(handles[i])->as<position>().x == float(i));
+        REQUIRE(!storage.contains({1, 1}));
+        REQUIRE(!storage.contains({3, 2}));
+    }
+
+    SECTION("Removing a component moves the last one into the gap.")
+    {
+        REQUIRE(storage.remove(handles[2], 2));
+        REQUIRE(!storage.remove(handles[2], 2));
+        REQUIRE(storage.size() == 9);
+        REQUIRE(storage.at(2)->as<position>().x == 9.f);
+        REQUIRE(storage.at(2)->entity == handles[9]);
+        for (uint32_t i = 0; i < 10; ++i)
+            if (i != 2) REQUIRE(storage.get(handles[i])->as<position>().x == float(i));
+        REQUIRE(storage.get(handles[2]) == nullptr);
+    }
+
+    SECTION("Components are replaced by copies of themselves and of the last component.")
+    {
+        gfx::ecs::component_storage labels(label::id);
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            const label l("a label which does not fit into a small string, number " + std::to_string(i));
+            labels.emplace(handles[i], &l, 1);
+        }
+
+        labels.emplace(handles[0], labels.get(handles[0]), 2);
+        REQUIRE(labels.size() == 3);
+        REQUIRE(labels.get(handles[0])->as<label>().text.back() == '0');
+
+        const auto* replaced = labels.emplace(handles[0], labels.get(handles[2]), 3);
+        REQUIRE(labels.size() == 3);
+        REQUIRE(replaced == labels.get(handles[0]));
+        REQUIRE(replaced->as<label>().text.back() == '2');
+        REQUIRE(replaced->added_tick == 3);
+        REQUIRE(labels.get(handles[2])->as<label>().text.back() == '2');
+        REQUIRE(labels.get(handles[1])->as<label>().text.back() == '1');
+    }
+}
+
+TEST_CASE("Command buffers", "[ecs]")
+{
+    gfx::ecs::ecs            ecs;
+    gfx::ecs::command_buffer commands;
+
+    SECTION("Recorded commands are applied by execute.")
+    {
+        const gfx::ecs::entity_handle e = ecs.create_entity(position(1.f));
+        commands.create_entity(position(2.f), velocity(3.f));
+        commands.add_components(e, velocity(4.f));
+        commands.remove_components<position>(e);
+        REQUIRE(ecs.entity_count() == 1);
+
+        ecs.execute(commands);
+        REQUIRE(commands.empty());
+        REQUIRE(ecs.entity_count() == 2);
+        REQUIRE(!ecs.has_component<position>(e));
+        REQUIRE(ecs.get_component<velocity>(e)->v == 4.f);
+
+        commands.delete_entity(e);
+        ecs.execute(commands);
+        REQUIRE(!ecs.valid(e));
+        REQUIRE(ecs.entity_count() == 1);
+    }
+
+    SECTION("Listeners may record into the buffer being executed.")
+    {
+        struct recording_listener : gfx::ecs::listener
+        {
+            recording_listener(gfx::ecs::command_buffer& commands) : commands(commands)
+            {
+                add_component_id(position::id);
+                set_options(gfx::ecs::listener_option::immediate);
+            }
+            void on_add(gfx::ecs::entity e) override { commands.add_components(e, velocity(5.f)); }
+            gfx::ecs::command_buffer& commands;
+        } listener(commands);
+        ecs.add_listener(listener);
+
+        commands.create_entity(position(1.f));
+        ecs.execute(commands);
+        REQUIRE(ecs.entity_count() == 1);
+        REQUIRE(!commands.empty());
+
+        ecs.execute(commands);
+        REQUIRE(commands.empty());
+        ecs.remove_listener(listener);
+    }
+
+    SECTION("Systems record into the deferred buffer, which is executed after each system.")
+    {
+        std::vector<gfx::ecs::entity> entities;
+        for (int i = 0; i < 10; ++i) entities.push_back(ecs.create_entity(position(float(i))));
+        struct spawn_system : gfx::ecs::system
+        {
+            spawn_system(gfx::ecs::ecs& ecs) : ecs(ecs)
+            {
+                add_component_type<position>();
+                set_chunk_size(3);
+                set_options(gfx::ecs::system_option::thread_safe);
+            }
+            void update(double delta, gfx::ecs::component_base** components) const override
+            {
+                ecs.deferred().add_components(components[0]->entity, velocity(components[0]->as<position>().x));
+            }
+            gfx::ecs::ecs& ecs;
+        } system(ecs);
+
+        gfx::ecs::system_list list;
+        list.add(system);
+        ecs.update(0.0, list);
+        REQUIRE(ecs.deferred().empty());
+        for (int i = 0; i < 10; ++i) REQUIRE(entities[i].get<velocity>()->v == float(i));
+    }
+}
+
+TEST_CASE("Listeners", "[ecs]")
+{
+    // Counts the notifications and the runs in which they were delivered.
+    struct counting_listener : gfx::ecs::listener
+    {
+        counting_listener() { add_component_id(position::id); }
+        void on_add_batch(gfx::span<const gfx::ecs::entity> entities) override
+        {
+            ++add_runs;
+            added += entities.size();
+        }
+        void on_remove_batch(gfx::span<const gfx::ecs::entity> entities) override { removed += entities.size(); }
+        void on_add_component(gfx::ecs::entity e, gfx::ecs::id_t id) override { ++added_components; }
+        void on_remove_component(gfx::ecs::entity e, gfx::ecs::id_t id) override
+        {
+            // Immediate listeners still see the component that is being removed.
+            if (options().has(gfx::ecs::listener_option::immediate)) REQUIRE(e.has<position>());
+            ++removed_components;
+        }
+        ptrdiff_t add_runs = 0, added = 0, removed = 0, added_components = 0, removed_components = 0;
+    };
+
+    gfx::ecs::ecs     ecs;
+    counting_listener listener;
+    ecs.add_listener(listener);
+
+    SECTION("Notifications are queued until they are flushed and delivered in runs.")
+    {
+        auto entities = ecs.create_entities(100, position(0.f));
+        ecs.create_entity(velocity(0.f));
+        REQUIRE(listener.added == 0);
+
+        ecs.flush_notifications();
+        REQUIRE(listener.added == 100);
+        REQUIRE(listener.add_runs == 1);
+
+        entities[0].remove<position>();
+        ecs.delete_entities({std::vector<gfx::ecs::entity_handle>(entities.begin() + 1, entities.end())});
+        ecs.flush_notifications();
+        REQUIRE(listener.removed_components == 1);
+        REQUIRE(listener.removed == 99);
+    }
+
+    SECTION("Immediate listeners are notified on every structural change.")
+    {
+        struct immediate_listener : counting_listener
+        {
+            immediate_listener() { set_options(gfx::ecs::listener_option::immediate); }
+        } immediate;
+        ecs.add_listener(immediate);
+
+        ecs.create_entity(position(0.f));
+        REQUIRE(immediate.added == 1);
+        gfx::ecs::entity e = ecs.create_entity(velocity(0.f));
+        REQUIRE(immediate.added == 1);
+        e.add(position(1.f));
+        REQUIRE(immediate.added_components == 1);
+        e.remove<position>();
+        REQUIRE(immediate.removed_components == 1);
+        REQUIRE(listener.removed_components == 0);
+        ecs.remove_listener(immediate);
+    }
+    ecs.remove_listener(listener);
+}
+
+TEST_CASE("Change ticks and removals", "[ecs]")
+{
+    gfx::ecs::ecs ecs;
+    auto          entities = ecs.create_entities(10, position(0.f));
+
+    // Counts the entities whose position changed and the ones that lost it.
+    struct tracking_system : gfx::ecs::system
+    {
+        tracking_system()
+        {
+            add_component_type<position>(gfx::ecs::component_flag::changed);
+            track_removed(position::id);
+        }
+        void update(double delta, gfx::ecs::component_base** components) const override { ++changed; }
+        void update_removed(double delta, gfx::ecs::id_t id, gfx::span<const gfx::ecs::entity_handle> entities) const override
+        {
+            removed += entities.size();
+        }
+        mutable ptrdiff_t changed = 0, removed = 0;
+    } system;
+    gfx::ecs::system_list list;
+    list.add(system);
+
+    SECTION("Systems only see the changes since their last run.")
+    {
+        ecs.update(0.0, list);
+        REQUIRE(system.changed == 10);
+
+        entities[3].mark_changed<position>();
+        entities[4].get<position>()->x = 1.f;
+        ecs.update(0.0, list);
+        REQUIRE(system.changed == 12);
+
+        ecs.update(0.0, list);
+        REQUIRE(system.changed == 12);
+    }
+
+    SECTION("Removals are reported once to tracking systems.")
+    {
+        ecs.update(0.0, list);
+        entities[0].remove<position>();
+        entities[1].remove<position>();
+        ecs.update(0.0, list);
+        REQUIRE(system.removed == 2);
+        ecs.next_frame();
+        ecs.update(0.0, list);
+        REQUIRE(system.removed == 2);
+    }
+
+    SECTION("Removals are not logged if no system tracks them.")
+    {
+        gfx::ecs::component_storage storage(position::id);
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            const position p;
+            storage.emplace({i, 0}, &p, i);
+            storage.remove({i, 0}, i);
+        }
+        REQUIRE(storage.removed_since(0).size() == 0);
+
+        storage.request_removals(0);
+        const position p;
+        storage.emplace({0, 1}, &p, 1);
+        storage.remove({0, 1}, 1);
+        REQUIRE(storage.removed_since(0).size() == 1);
+    }
+
+    SECTION("The removal log stays bounded when the tracking system is not updated anymore.")
+    {
+        ecs.update(0.0, list);
+        for (int frame = 0; frame < 100; ++frame)
+        {
+            for (auto& e : ecs.create_entities(100, position(0.f))) e.remove<position>();
+            ecs.next_frame();
+        }
+        const position p;
+        gfx::ecs::entity e = ecs.create_entity(p);
+        e.remove<position>();
+        ecs.update(0.0, list);
+        REQUIRE(system.removed == 0);
+    }
+}
+
+TEST_CASE("Paged component storage", "[ecs]")
+{
+    gfx::ecs::component_storage storage(position::id);
+    const size_t                capacity = storage.page_capacity();
+    REQUIRE(capacity != 0);
+    REQUIRE((capacity & (capacity - 1)) == 0);
+
+    const position p0{0.f};
+    auto* const    first = storage.emplace({0, 0}, &p0, 0);
+
+    SECTION("Growing the storage does not move components.")
+    {
+        for (uint32_t i = 1; i < 3 * capacity + 7; ++i)
+        {
+            const position p{float(i)};
+            storage.emplace({i, 0}, &p, 0);
+        }
+        REQUIRE(storage.at(0) == first);
+        REQUIRE(first->as<position>().x == 0.f);
+        REQUIRE(storage.at(3 * capacity)->as<position>().x == float(3 * capacity));
+
+        SECTION("Contiguous runs end at page boundaries.")
+        {
+            REQUIRE(storage.contiguous_end(0, storage.size()) == capacity);
+            REQUIRE(storage.contiguous_end(capacity + 3, storage.size()) == 2 * capacity);
+            REQUIRE(storage.contiguous_end(3 * capacity, storage.size()) == storage.size());
+            REQUIRE(storage.contiguous_end(5, 9) == 9);
+            for (size_t i = 1; i < capacity; ++i)
+                REQUIRE(reinterpret_cast<std::byte*>(storage.at(i)) - reinterpret_cast<std::byte*>(storage.at(i - 1)) == ptrdiff_t(storage.stride()));
+        }
+
+        SECTION("Removing components keeps the others where they are, apart from the moved last one.")
+        {
+            auto* const second = storage.at(1);
+            for (uint32_t i = 2; i < 3 * capacity + 7; ++i) storage.remove({i, 0}, 0);
+            storage.shrink_to_fit();
+            REQUIRE(storage.size() == 2);
+            REQUIRE(storage.at(0) == first);
+            REQUIRE(storage.at(1) == second);
+            REQUIRE(storage.get({1, 0})->as<position>().x == 1.f);
+        }
+    }
+}
+
+TEST_CASE("Queries", "[ecs]")
+{
+    gfx::ecs::ecs ecs;
+    auto          entities = ecs.create_entities(100, position(1.f), velocity(2.f));
+    ecs.create_entities(10, position(3.f));
+
+    SECTION("Queries are shared and kept up to date.")
+    {
+        auto& q = ecs.register_query({position::id, velocity::id});
+        REQUIRE(&q == &ecs.register_query({position::id, velocity::id}));
+        REQUIRE(q.size() == 100);
+
+        auto& optional = ecs.register_query({position::id, velocity::id}, {{}, gfx::ecs::component_flag::optional});
+        REQUIRE(&optional != &q);
+        REQUIRE(optional.size() == 110);
+
+        entities[0].remove<velocity>();
+        REQUIRE(q.size() == 99);
+        REQUIRE(!q.contains(entities[0]));
+        REQUIRE(optional.contains(entities[0]));
+        REQUIRE(optional.get(1, entities[0]) == nullptr);
+        entities[0].add(velocity(4.f));
+        REQUIRE(q.contains(entities[0]));
+        REQUIRE(q.get(1, entities[0])->as<velocity>().v == 4.f);
+    }
+
+    SECTION("Batches of entities created together have contiguous columns.")
+    {
+        struct column_system : gfx::ecs::system
+        {
+            column_system()
+            {
+                add_component_type<position>();
+                add_component_type<velocity>();
+            }
+            void update_batch(double delta, const gfx::ecs::component_batch& batch) const override
+            {
+                REQUIRE(batch.contiguous(0));
+                REQUIRE(batch.contiguous(1));
+                const auto positions  = batch.span<position>(0);
+                const auto velocities = batch.span<velocity>(1);
+                for (ptrdiff_t i = 0; i < positions.size(); ++i) positions[i].x += velocities[i].v;
+            }
+        } system;
+        gfx::ecs::system_list list;
+        list.add(system);
+        ecs.update(0.0, list);
+        for (auto& e : entities) REQUIRE(e.get<position>()->x == 3.f);
+    }
+
+    SECTION("Cached queries of systems do not outlive their ecs.")
+    {
+        move_system           system(1024, false);
+        gfx::ecs::system_list list;
+        list.add(system);
+        ecs.update(0.0, list);
+
+        std::optional<gfx::ecs::ecs> other;
+        for (int i = 0; i < 2; ++i)
+        {
+            other.emplace();
+            auto e = other->create_entity(position(0.f), velocity(float(i + 1)));
+            other->update(0.0, list);
+            REQUIRE(e.get<position>()->x == float(i + 1));
+            other.reset();
+        }
+    }
+}
+
+TEST_CASE("Transform hierarchies", "[ecs]")
+{
+    gfx::ecs::ecs            ecs;
+    gfx::transform_hierarchy hierarchy(ecs);
+    auto                     root       = ecs.create_entity(translation(1, 0));
+    auto                     child      = ecs.create_entity(translation(2, 0), parent(root));
+    auto                     grandchild = ecs.create_entity(translation(0, 3), parent(child));
+    auto                     other      = ecs.create_entity(position(0.f));
+    hierarchy.update();
+
+    SECTION("World matrices compose the transforms of all ancestors.")
+    {
+        REQUIRE((*hierarchy.world_matrix(root))[3] == glm::vec4(1, 0, 0, 1));
+        REQUIRE((*hierarchy.world_matrix(child))[3] == glm::vec4(3, 0, 0, 1));
+        REQUIRE((*hierarchy.world_matrix(grandchild))[3] == glm::vec4(3, 3, 0, 1));
+        REQUIRE(hierarchy.index_of(other) == gfx::transform_hierarchy::npos);
+        REQUIRE(hierarchy.world_matrix(other) == nullptr);
+
+        // Parents come before their children.
+        REQUIRE(hierarchy.index_of(root) < hierarchy.index_of(child));
+        REQUIRE(hierarchy.index_of(child) < hierarchy.index_of(grandchild));
+        REQUIRE(hierarchy.entities().size() == 3);
+    }
+
+    SECTION("Changed transforms update their subtrees.")
+    {
+        root.get<gfx::transform_component>()->value = gfx::transform(glm::vec3(5, 0, 0));
+        hierarchy.update();
+        REQUIRE((*hierarchy.world_matrix(grandchild))[3] == glm::vec4(7, 3, 0, 1));
+    }
+
+    SECTION("Reassigned parents are picked up.")
+    {
+        grandchild.get<gfx::parent_component>()->parent = root;
+        hierarchy.update();
+        REQUIRE((*hierarchy.world_matrix(grandchild))[3] == glm::vec4(1, 3, 0, 1));
+
+        grandchild.remove<gfx::parent_component>();
+        hierarchy.update();
+        REQUIRE((*hierarchy.world_matrix(grandchild))[3] == glm::vec4(0, 3, 0, 1));
+    }
+
+    SECTION("Cycles are broken.")
+    {
+        root.add(parent(grandchild));
+        hierarchy.update();
+        REQUIRE(hierarchy.entities().size() == 3);
+    }
+}
+
+namespace {
+struct name_component : gfx::ecs::component<name_component>
+{
+    std::string name;
+};
+
+void save_name(gfx::ecs::snapshot_writer& out, const gfx::ecs::component_base* component)
+{
+    const auto& name = component->as<name_component>().name;
+    out.write(uint32_t(name.size()));
+    out.write(name.data(), name.size());
+}
+
+gfx::ecs::component_base* load_name(gfx::ecs::snapshot_reader& in, void* memory)
+{
+    uint32_t    size = 0;
+    std::string name;
+    if (!in.read(size) || size > 1024) return nullptr;
+    name.resize(size);
+    if (!in.read(name.data(), size)) return nullptr;
+    auto* const component = new (memory) name_component;
+    component->name       = std::move(name);
+    return component;
+}
+}    // namespace
+
+TEST_CASE("Snapshots", "[ecs]")
+{
+    static const bool registered = gfx::ecs::register_serializer(name_component::id, &save_name, &load_name);
+    REQUIRE(registered);
+
+    gfx::ecs::ecs ecs;
+    auto          root  = ecs.create_entity(translation(1, 0), position(1.f));
+    auto          child = ecs.create_entity(translation(2, 0), parent(root));
+    name_component name;
+    name.name = "child";
+    child.add(name);
+    ecs.create_entities(100, position(2.f), velocity(3.f));
+
+    std::stringstream stream;
+    ecs.save_snapshot(stream);
+    const std::string data = stream.str();
+
+    SECTION("Snapshots are restored into new entities with remapped references.")
+    {
+        gfx::ecs::ecs loaded;
+        loaded.create_entity(position(0.f));
+        const auto entities = loaded.load_snapshot(stream);
+        REQUIRE(entities.size() == 102);
+        REQUIRE(loaded.entity_count() == 103);
+
+        REQUIRE(entities[0].get<position>()->x == 1.f);
+        REQUIRE(entities[1].get<name_component>()->name == "child");
+        REQUIRE(entities[1].get<gfx::parent_component>()->parent == gfx::ecs::entity_handle(entities[0]));
+        REQUIRE(!entities[1].has<position>());
+        REQUIRE(entities[101].get<velocity>()->v == 3.f);
+        REQUIRE(loaded.register_query({position::id, velocity::id}).size() == 100);
+
+        gfx::transform_hierarchy hierarchy(loaded);
+        hierarchy.update();
+        REQUIRE((*hierarchy.world_matrix(entities[1]))[3] == glm::vec4(3, 0, 0, 1));
+    }
+
+    SECTION("Snapshots are loaded from memory.")
+    {
+        gfx::ecs::ecs loaded;
+        const auto    entities = loaded.load_snapshot({reinterpret_cast<const std::byte*>(data.data()), ptrdiff_t(data.size())});
+        REQUIRE(entities.size() == 102);
+        REQUIRE(entities[1].get<name_component>()->name == "child");
+    }
+
+    SECTION("Truncated snapshots create nothing.")
+    {
+        gfx::ecs::ecs loaded;
+        auto          kept = loaded.create_entity(position(5.f));
+        for (size_t size = 0; size < data.size(); size += 7)
+        {
+            const auto entities = loaded.load_snapshot({reinterpret_cast<const std::byte*>(data.data()), ptrdiff_t(size)});
+            REQUIRE(entities.empty());
+            REQUIRE(loaded.entity_count() == 1);
+        }
+        REQUIRE(kept.get<position>()->x == 5.f);
+        REQUIRE(loaded.register_query({position::id}).size() == 1);
+        REQUIRE(loaded.load_snapshot({reinterpret_cast<const std::byte*>(data.data()), ptrdiff_t(data.size())}).size() == 102);
+    }
+
+    SECTION("Corrupt entity counts fail without allocating them.")
+    {
+        std::string corrupt = data.substr(0, 2 * sizeof(uint32_t));
+        const uint64_t count = ~0ull >> 8;
+        corrupt.append(reinterpret_cast<const char*>(&count), sizeof(count));
+        corrupt.append(data, 2 * sizeof(uint32_t) + sizeof(uint64_t), std::string::npos);
+
+        gfx::ecs::ecs loaded;
+        std::stringstream in(corrupt);
+        REQUIRE(loaded.load_snapshot(in).empty());
+        REQUIRE(loaded.entity_count() == 0);
+    }
+}
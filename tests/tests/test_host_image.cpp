@@ -1,6 +1,9 @@
 #include "catch.hpp"
 #include <gfx/gfx.hpp>
+#include <gfx/graphics/pixel_conversion.hpp>
+#include <gfx/graphics/pixel_kernels.hpp>
 #include <glm/glm.hpp>
+#include <random>
 
 struct context_provider
 {
@@ -127,6 +130,22 @@ TEST_CASE_METHOD(context_provider, "Image operations", "[image]")
         REQUIRE(iimage.loadu(pixel) == glm::uvec4(2 * ((((0 + 10) - 3) * 4) / 2)));
     }
 
+    SECTION("Chained expressions")
+    {
+        gfx::himage mean(gfx::rgba32f, gfx::extent(1, 1, 1));
+        mean.store({0, 0, 0}, glm::vec4(0.5f));
+
+        static_assert(std::is_same_v<decltype(base * 2.f + base), gfx::himage>);
+        gfx::himage result = (gfx::lazy(base) - mean) * 2.f + base;
+        REQUIRE(result.load(pixel) == (base.load(pixel) - 0.5f) * 2.f + base.load(pixel));
+        REQUIRE(result.load({0, 0, 0}) == glm::vec4(-1.f));
+
+        const std::byte* storage = result.storage().data();
+        result = gfx::lazy(result) * 0.5f + base;
+        REQUIRE(result.storage().data() == storage);
+        REQUIRE(result.load({0, 0, 0}) == glm::vec4(-0.5f));
+    }
+
     // Remaining cases
 }
 
@@ -148,4 +167,622 @@ TEST_CASE_METHOD(context_provider, "Image conversion", "[image]")
 
     REQUIRE(base.converted(gfx::rgba8unorm) == rgba8);
     REQUIRE(base.converted(gfx::rgb9e5) == rgb9e5);
-}
\ No newline at end of file
+}
+
+TEST_CASE_METHOD(context_provider, "Image pixel visitors", "[image]")
+{
+    const gfx::extent size(10, 4, 7);
+
+    SECTION("Visiting with a runtime format equals storing each pixel.")
+    {
+        gfx::himage visited(gfx::rgba8unorm, size);
+        gfx::himage stored(gfx::rgba8unorm, size);
+        visited.visit_pixels([](const glm::uvec3& pixel, auto& value) {
+            using value_type = std::decay_t<decltype(value)>;
+            value            = value_type(pixel.x, pixel.y, pixel.z, 1) / value_type(10);
+        });
+        stored.each_pixel([&](const glm::uvec3& pixel) { stored.store(pixel, glm::vec4(pixel.x, pixel.y, pixel.z, 1) / 10.f); });
+        REQUIRE(visited == stored);
+    }
+
+    SECTION("Visiting with a compile-time format.")
+    {
+        gfx::himage image(gfx::r32u, size);
+        image.visit_pixels<gfx::r32u>([](const glm::uvec3& pixel, glm::uvec4& value) { value.x = pixel.x + pixel.y; });
+
+        uint32_t sum = 0;
+        const auto& view = image;
+        view.visit_pixels<gfx::r32u>([&](const glm::uvec3& pixel, const glm::uvec4& value) { sum += value.x; });
+        REQUIRE(sum == size.depth * (size.height * 45 + size.width * 6));
+    }
+}
+
+TEST_CASE_METHOD(context_provider, "Image convolution", "[image]")
+{
+    const gfx::extent size(13, 9, 1);
+    gfx::himage       image(gfx::rgba32f, size);
+    image.each_pixel([&](const glm::uvec3& pixel) { image.store(pixel, glm::vec4((pixel.x * 7 + pixel.y * 3) % 11, pixel.x, pixel.y, 1)); });
+
+    const auto [gauss_x, gauss_y, gauss_z] = gfx::image_filter::gauss_separable(5, 1.f);
+    gfx::image_filter gauss_xy(gfx::extent(5, 5, 1));
+    for (uint32_t y = 0; y < 5; ++y)
+        for (uint32_t x = 0; x < 5; ++x) gauss_xy[{x, y, 0}] = gauss_x[{x, 0, 0}] * gauss_y[{0, y, 0}];
+    REQUIRE(gauss_xy.separated().has_value());
+
+    // Reference result with clamped borders.
+    gfx::himage expected(gfx::rgba32f, size);
+    expected.each_pixel([&](const glm::uvec3& pixel) {
+        glm::vec4 sum{0};
+        for (int y = -2; y <= 2; ++y)
+            for (int x = -2; x <= 2; ++x)
+                sum += image.load(glm::uvec3(size.clamp(glm::ivec3(pixel) + glm::ivec3(x, y, 0)))) * gauss_xy[glm::uvec3(x + 2, y + 2, 0)];
+        expected.store(pixel, sum);
+    });
+
+    const auto near = [&](const gfx::himage& result) {
+        bool equal = true;
+        result.each_pixel([&](const glm::uvec3& pixel) {
+            equal &= glm::all(glm::lessThan(glm::abs(result.load(pixel) - expected.load(pixel)), glm::vec4(1e-4f)));
+        });
+        return equal;
+    };
+
+    SECTION("Separable 2D filter")
+    {
+        gfx::himage result(gfx::rgba32f, size);
+        image.convolute(gauss_xy, result);
+        REQUIRE(near(result));
+    }
+
+    SECTION("Separate passes")
+    {
+        gfx::himage result = image;
+        result.convolute(gauss_x);
+        result.convolute(gauss_y);
+        REQUIRE(near(result));
+    }
+
+    SECTION("Non-separable filter")
+    {
+        gfx::image_filter cross(gfx::extent(3, 3, 1));
+        cross[{1, 0, 0}] = cross[{0, 1, 0}] = cross[{2, 1, 0}] = cross[{1, 2, 0}] = 1.f;
+        REQUIRE(!cross.separated().has_value());
+
+        gfx::himage result(gfx::rgba32f, size);
+        image.convolute(cross, result);
+        const glm::vec4 sum = image.load({0, 1, 0}) + image.load({1, 0, 0}) + image.load({2, 1, 0}) + image.load({1, 2, 0});
+        REQUIRE(result.load({1, 1, 0}) == sum);
+    }
+
+    SECTION("Filter tuples quantize once")
+    {
+        gfx::image_filter cross(gfx::extent(3, 3, 1));
+        cross[{1, 0, 0}] = cross[{0, 1, 0}] = cross[{2, 1, 0}] = cross[{1, 2, 0}] = 0.25f;
+        const std::tuple filters(cross, gauss_x, gauss_y);
+
+        gfx::himage unorm(gfx::rgba8unorm, size);
+        unorm.each_pixel([&](const glm::uvec3& pixel) { unorm.store(pixel, glm::vec4((pixel.x * 7 + pixel.y * 3) % 11, pixel.x, pixel.y, 11) / 11.f); });
+        gfx::himage floats = unorm.converted(gfx::rgba32f);
+        floats.convolute(filters);
+
+        gfx::himage result(gfx::rgba8unorm, size);
+        unorm.convolute(filters, result);
+        gfx::himage quantized(gfx::rgba8unorm, size);
+        quantized.each_pixel([&](const glm::uvec3& pixel) { quantized.store(pixel, floats.load(pixel)); });
+        REQUIRE(result == quantized);
+    }
+}
+
+TEST_CASE_METHOD(context_provider, "Image pyramid", "[image]")
+{
+    SECTION("Box filtering averages blocks of pixels.")
+    {
+        gfx::himage image(gfx::rgba32f, gfx::extent(4, 4));
+        image.each_pixel([&](const glm::uvec3& pixel) { image.store(pixel, glm::vec4(pixel.x + 4 * pixel.y, 0, 0, 1)); });
+
+        const gfx::host_image_pyramid pyramid(image);
+        REQUIRE(pyramid.levels() == 3);
+        REQUIRE(pyramid[1].load({1, 0, 0}).x == 4.5f);
+        REQUIRE(pyramid[2].load({0, 0, 0}).x == 7.5f);
+    }
+
+    SECTION("3D images are halved along all axes.")
+    {
+        const gfx::himage             volume(gfx::rgba16f, gfx::extent(9, 7, 5));
+        const gfx::host_image_pyramid pyramid(volume, gfx::mip_filter::lanczos);
+        REQUIRE(pyramid.levels() == 4);
+        REQUIRE(pyramid[1].extents() == gfx::extent(4, 3, 2));
+        REQUIRE(pyramid[3].extents() == gfx::extent(1, 1, 1));
+    }
+
+    SECTION("sRGB colors are filtered in linear space.")
+    {
+        gfx::himage image(gfx::rgba8unorm, gfx::extent(2, 1));
+        image.store({1, 0, 0}, glm::vec4(1));
+
+        const gfx::host_image_pyramid pyramid(image, gfx::mip_filter::box, gfx::color_space::srgb);
+        REQUIRE(pyramid[1].load({0, 0, 0}).x == Approx(188 / 255.f));
+        REQUIRE(pyramid[1].load({0, 0, 0}).w == Approx(128 / 255.f));
+    }
+}
+
+TEST_CASE_METHOD(context_provider, "Image layouts", "[image]")
+{
+    gfx::himage linear(gfx::rgba32f, gfx::extent(13, 7, 5));
+    linear.each_pixel([&](const glm::uvec3& pixel) { linear.store(pixel, glm::vec4(pixel.x, pixel.y, pixel.z, 1)); });
+    const gfx::himage tiled = linear.with_layout(gfx::image_layout::tiled);
+
+    SECTION("Pixels are accessed independently of the layout.")
+    {
+        REQUIRE(tiled.layout() == gfx::image_layout::tiled);
+        REQUIRE(tiled == linear);
+        REQUIRE(tiled.load({12, 6, 4}) == glm::vec4(12, 6, 4, 1));
+        REQUIRE(tiled.load_bilinear({2.5f, 3.5f, 1.5f}) == linear.load_bilinear({2.5f, 3.5f, 1.5f}));
+    }
+
+    SECTION("Operations keep the layout.")
+    {
+        gfx::himage flipped = tiled;
+        flipped.flip_vertically();
+        REQUIRE(flipped.load({3, 0, 2}) == glm::vec4(3, 6, 2, 1));
+
+        const gfx::himage converted = tiled.converted(gfx::rgba16f);
+        REQUIRE(converted.layout() == gfx::image_layout::tiled);
+        REQUIRE(converted == linear.converted(gfx::rgba16f));
+
+        // No conversion kernel exists for these formats.
+        const gfx::himage unnormalized = tiled.converted(gfx::rg16unorm);
+        REQUIRE(unnormalized.layout() == gfx::image_layout::tiled);
+        REQUIRE(unnormalized == linear.converted(gfx::rg16unorm));
+    }
+
+    SECTION("Layouts are converted in bulk.")
+    {
+        const gfx::himage back = tiled.with_layout(gfx::image_layout::linear);
+        REQUIRE(back.storage().size() == linear.storage().size());
+        REQUIRE(memcmp(back.storage().data(), linear.storage().data(), linear.storage().size()) == 0);
+    }
+}
+
+TEST_CASE_METHOD(context_provider, "Mapped images", "[image]")
+{
+    const auto  path = std::filesystem::temp_directory_path() / "gfx_test_mapped_image";
+    gfx::himage image(gfx::rgba32f, gfx::extent(300, 260));
+    image.each_pixel([&](const glm::uvec3& pixel) { image.store(pixel, glm::vec4(pixel.x, pixel.y, 0, 1) / 300.f); });
+
+    SECTION("Pixels are written to and read from the file.")
+    {
+        {
+            gfx::mapped_image mapped(path, gfx::rgba32f, image.extents(), gfx::image_layout::linear, 1);
+            image.each_pixel([&](const glm::uvec3& pixel) { mapped.store(pixel, image.load(pixel)); });
+        }
+        REQUIRE(std::filesystem::file_size(path) == image.storage().size());
+
+        const gfx::mapped_image mapped(path, gfx::rgba32f, image.extents(), gfx::image_layout::linear, 1);
+        REQUIRE(mapped.load({299, 259, 0}) == image.load({299, 259, 0}));
+        REQUIRE(mapped.load_bilinear({255.5f, 3.25f, 0}) == image.load_bilinear({255.5f, 3.25f, 0}));
+    }
+
+    SECTION("Streaming operations match the in-memory ones.")
+    {
+        gfx::mapped_image mapped(path, gfx::rgba32f, image.extents(), gfx::image_layout::tiled, 2);
+        image.each_pixel([&](const glm::uvec3& pixel) { mapped.store(pixel, image.load(pixel)); });
+
+        const auto        gauss = gfx::image_filter::gauss_separable(5, 1.f);
+        gfx::mapped_image result(path.string() + "_result", gfx::rgba16f, image.extents(), gfx::image_layout::tiled, 2);
+        mapped.convolute(gauss, result);
+        gfx::himage expected = image.converted(gfx::rgba16f);
+        image.convolute(gauss, expected);
+        expected.each_pixel([&](const glm::uvec3& pixel) { REQUIRE(result.load(pixel) == expected.load(pixel)); });
+    }
+    std::filesystem::remove(path);
+    std::filesystem::remove(path.string() + "_result");
+}
+
+TEST_CASE_METHOD(context_provider, "Image resizing", "[image]")
+{
+    SECTION("Shrinking by two with a box filter averages pixel pairs.")
+    {
+        gfx::himage image(gfx::r32f, gfx::extent(4, 2));
+        image.each_pixel([&](const glm::uvec3& pixel) { image.store(pixel, glm::vec4(pixel.x + 4 * pixel.y)); });
+        const gfx::himage half = image.resized(gfx::extent(2, 1), gfx::resample_filter::box);
+        REQUIRE(half.extents() == gfx::extent(2, 1));
+        REQUIRE(half.load({0, 0, 0}).x == 2.5f);
+        REQUIRE(half.load({1, 0, 0}).x == 4.5f);
+    }
+
+    SECTION("Enlarging with a triangle filter interpolates linearly.")
+    {
+        gfx::himage image(gfx::r32f, gfx::extent(2, 1));
+        image.store({1, 0, 0}, glm::vec4(1));
+        const gfx::himage twice = image.resized(gfx::extent(4, 1), gfx::resample_filter::triangle);
+        REQUIRE(twice.load({0, 0, 0}).x == Approx(0.f));
+        REQUIRE(twice.load({1, 0, 0}).x == Approx(0.25f));
+        REQUIRE(twice.load({2, 0, 0}).x == Approx(0.75f));
+        REQUIRE(twice.load({3, 0, 0}).x == Approx(1.f));
+    }
+
+    SECTION("sRGB colors are averaged as linear values and constant images stay constant.")
+    {
+        gfx::himage image(gfx::rgba8unorm, gfx::extent(64, 64));
+        image.each_pixel([&](const glm::uvec3& pixel) { image.store(pixel, glm::vec4((pixel.x + pixel.y) % 2, 128 / 255.f, 0, 1)); });
+        for (const auto filter : {gfx::resample_filter::box, gfx::resample_filter::mitchell, gfx::resample_filter::lanczos}) {
+            const gfx::himage small = image.resized(gfx::extent(8, 8), filter, gfx::color_space::srgb);
+            REQUIRE(glm::round(small.load({3, 4, 0}) * 255.f) == glm::vec4(188, 128, 0, 255));
+        }
+    }
+}
+
+TEST_CASE_METHOD(context_provider, "Image compression", "[image]")
+{
+    gfx::himage image(gfx::rgba32f, gfx::extent(30, 18));
+    image.each_pixel([&](const glm::uvec3& pixel) { image.store(pixel, glm::vec4(pixel.x / 29.f, 0.5f, 1.f - pixel.x / 29.f, pixel.y / 17.f)); });
+    const auto max_error = [&](const gfx::himage& decoded, const int channels) {
+        float error = 0.f;
+        image.each_pixel([&](const glm::uvec3& pixel) {
+            for (int c = 0; c < channels; ++c) error = std::max(error, std::abs(decoded.load(pixel)[c] - image.load(pixel)[c]));
+        });
+        return error;
+    };
+
+    SECTION("Blocks take a fraction of the uncompressed size and decode close to the original.")
+    {
+        const gfx::compressed_image bc7(image, gfx::bc7unorm, gfx::compression_quality::high);
+        REQUIRE(bc7.blocks() == gfx::extent(8, 5));
+        REQUIRE(bc7.storage().size() == 16 * 8 * 5);
+        REQUIRE(bc7.decompressed().pixel_format() == gfx::rgba8unorm);
+        REQUIRE(max_error(bc7.decompressed(), 4) < 0.03f);
+
+        for (const auto quality : {gfx::compression_quality::fast, gfx::compression_quality::normal, gfx::compression_quality::high}) {
+            REQUIRE(max_error(gfx::compressed_image(image, gfx::bc3unorm, quality).decompressed(), 4) < 0.05f);
+            REQUIRE(max_error(gfx::compressed_image(image, gfx::bc5unorm, quality).decompressed(), 2) < 0.01f);
+        }
+    }
+
+    SECTION("BC1 keeps transparent pixels.")
+    {
+        const gfx::himage decoded = gfx::compressed_image(image, gfx::bc1unorm).decompressed();
+        REQUIRE(decoded.load({3, 0, 0}).a == 0.f);
+        REQUIRE(decoded.load({3, 17, 0}).a == 1.f);
+    }
+
+    SECTION("BC6H stores values above one.")
+    {
+        gfx::himage hdr(gfx::rgba16f, gfx::extent(8, 8));
+        hdr.each_pixel([&](const glm::uvec3& pixel) { hdr.store(pixel, glm::vec4(glm::vec3(1, 0.5f, 0.25f) * (4.f + pixel.x), 1)); });
+        const gfx::himage decoded = gfx::compressed_image(hdr, gfx::bc6hf).decompressed();
+        hdr.each_pixel([&](const glm::uvec3& pixel) { REQUIRE(decoded.load(pixel).r == Approx(hdr.load(pixel).r).epsilon(0.03)); });
+    }
+}
+
+TEST_CASE_METHOD(context_provider, "Image views", "[image]")
+{
+    gfx::himage image(gfx::rgba32f, gfx::extent(6, 5));
+    image.each_pixel([&](const glm::uvec3& pixel) { image.store(pixel, glm::vec4(pixel.x, pixel.y, 0, 1)); });
+
+    SECTION("Views of sub-rectangles read the pixels of the image without copying them.")
+    {
+        const gfx::host_image_view view = image.view({2, 1, 0}, gfx::extent(3, 2));
+        REQUIRE(!view.is_contiguous());
+        REQUIRE(view.data() == image.storage().data() + 4 * sizeof(float) * (6 + 2));
+        REQUIRE(view.load({0, 0, 0}) == glm::vec4(2, 1, 0, 1));
+        REQUIRE(view.subview({1, 1, 0}, gfx::extent(2, 1)).load({1, 0, 0}) == glm::vec4(4, 2, 0, 1));
+
+        const gfx::himage copy(view);
+        REQUIRE(copy.extents() == gfx::extent(3, 2));
+        copy.each_pixel([&](const glm::uvec3& pixel) { REQUIRE(copy.load(pixel) == image.load(pixel + glm::uvec3(2, 1, 0))); });
+    }
+
+    SECTION("Views of foreign memory are converted in one pass.")
+    {
+        const gfx::host_buffer<uint8_t> rgb{255, 0, 51, 0, 255, 102, 0, 0, 0, 0, 0, 0};
+        const gfx::host_image_view      view(gfx::rgb8unorm, gfx::extent(2, 2), rgb.data());
+        const gfx::himage               converted = view.converted(gfx::rgba32f);
+        REQUIRE(glm::round(converted.load({0, 0, 0}) * 255.f) == glm::vec4(255, 0, 51, 255));
+        REQUIRE(glm::round(converted.load({1, 0, 0}) * 255.f) == glm::vec4(0, 255, 102, 255));
+        REQUIRE(view.converted(gfx::rgb8unorm).storage().size() == rgb.size());
+    }
+
+    SECTION("Algorithms give the same results for views and images.")
+    {
+        const auto [gauss_x, gauss_y, gauss_z] = gfx::image_filter::gauss_separable(3, 1.f);
+        gfx::himage from_image(gfx::rgba32f, image.extents());
+        gfx::himage from_view(gfx::rgba32f, image.extents());
+        image.convolute(gauss_x, from_image);
+        image.view().convolute(gauss_x, from_view);
+        REQUIRE(from_image == from_view);
+        REQUIRE(image.resized(gfx::extent(3, 2)) == image.view().resized(gfx::extent(3, 2)));
+        REQUIRE_THROWS_AS(image.with_layout(gfx::image_layout::tiled).view(), std::invalid_argument);
+    }
+}
+
+TEST_CASE_METHOD(context_provider, "Image statistics", "[image]")
+{
+    gfx::himage image(gfx::rgba32f, gfx::extent(150, 7, 3));
+    image.each_pixel([&](const glm::uvec3& pixel) {
+        const float t = float((pixel.x * 37 + pixel.y * 11 + pixel.z * 5) % 101) / 100.f;
+        image.store(pixel, glm::vec4(t, 1.f - t, 0.5f * t + 0.25f, pixel.x % 2));
+    });
+
+    SECTION("Moments match a direct computation in double precision.")
+    {
+        glm::dvec4 sum(0);
+        image.each_pixel([&](const glm::uvec3& pixel) { sum += glm::dvec4(image.load(pixel)); });
+        const glm::dvec4 mean = sum / double(image.extents().count());
+        glm::dvec4       squares(0);
+        double           rg = 0;
+        image.each_pixel([&](const glm::uvec3& pixel) {
+            const glm::dvec4 d = glm::dvec4(image.load(pixel)) - mean;
+            squares += d * d;
+            rg += d.r * d.g;
+        });
+
+        const gfx::image_statistics stats = gfx::statistics(image);
+        REQUIRE(stats.count == image.extents().count());
+        for (int c = 0; c < 4; ++c) {
+            REQUIRE(stats.mean[c] == Approx(mean[c]));
+            REQUIRE(stats.variance[c] == Approx(squares[c] / double(stats.count)));
+        }
+        REQUIRE(stats.covariance[0][1] == Approx(rg / double(stats.count)));
+        REQUIRE(stats.covariance[0][0] == Approx(stats.variance.r));
+        REQUIRE(stats.min == glm::vec4(0, 0, 0.25f, 0));
+        REQUIRE(stats.max == glm::vec4(1, 1, 0.75f, 1));
+
+        const gfx::image_statistics tiled = gfx::statistics(image.with_layout(gfx::image_layout::tiled));
+        REQUIRE(tiled.mean == stats.mean);
+        REQUIRE(tiled.variance == stats.variance);
+    }
+
+    SECTION("Histograms count the values of every channel and give percentiles.")
+    {
+        const gfx::image_histogram histogram = gfx::histogram(image.view({0, 0, 0}, gfx::extent(4, 1)), 4);
+        REQUIRE(histogram.bins[gfx::image_histogram::a] == (std::vector<uint64_t>{2, 0, 0, 2}));
+        REQUIRE(histogram.bins[gfx::image_histogram::luminance].size() == 4);
+        REQUIRE(histogram.percentile(gfx::image_histogram::a, 0.5f) == Approx(0.25f));
+        REQUIRE(histogram.percentile(gfx::image_histogram::a, 1.f) == Approx(1.f));
+        REQUIRE_THROWS_AS(gfx::histogram(image, 0), std::invalid_argument);
+    }
+}
+
+TEST_CASE_METHOD(context_provider, "Image iteration policies", "[image]")
+{
+    const gfx::himage image(gfx::r32f, gfx::extent(37, 11, 3));
+    const auto        policies = {gfx::execution_policy::sequential, gfx::execution_policy::parallel,
+                           gfx::execution_policy::parallel_vectorized};
+
+    SECTION("Every pixel and every row is visited once.")
+    {
+        for (const auto policy : policies) {
+            std::vector<int> visits(image.extents().count(), 0);
+            image.each_pixel(policy, [&](const glm::uvec3& pixel) { ++visits[image.extents().linear(pixel)]; });
+            REQUIRE(std::count(visits.begin(), visits.end(), 1) == int(visits.size()));
+
+            std::vector<int> rows(11 * 3, 0);
+            image.each_row(policy, [&](const glm::uvec3& start, const uint32_t width) {
+                REQUIRE(start.x == 0);
+                REQUIRE(width == 37);
+                ++rows[start.z * 11 + start.y];
+            });
+            REQUIRE(std::count(rows.begin(), rows.end(), 1) == int(rows.size()));
+        }
+    }
+
+    SECTION("Reductions combine the states of all threads.")
+    {
+        const auto sum = [](const uint64_t a, const uint64_t b) { return a + b; };
+        for (const auto policy : policies) {
+            const uint64_t pixels = image.reduce_pixels(
+                    policy, uint64_t(0), [](uint64_t& s, const glm::uvec3& pixel) { s += pixel.x + 100 * pixel.y + 10000 * pixel.z; }, sum);
+            REQUIRE(pixels == 11 * 3 * (36 * 37 / 2) + 37 * 3 * 100 * (10 * 11 / 2) + 37 * 11 * 10000 * 3);
+
+            const std::vector<uint32_t> first_rows = image.reduce_rows(
+                    policy, std::vector<uint32_t>{}, [](std::vector<uint32_t>& s, const glm::uvec3& start, uint32_t) { s.push_back(start.y); },
+                    [](std::vector<uint32_t> a, const std::vector<uint32_t>& b) {
+                        a.insert(a.end(), b.begin(), b.end());
+                        return a;
+                    });
+            REQUIRE(first_rows.size() == 33);
+            REQUIRE(std::is_sorted(first_rows.begin(), first_rows.begin() + 11));
+        }
+    }
+}
+
+TEST_CASE_METHOD(context_provider, "Summed-area tables", "[image]")
+{
+    gfx::himage image(gfx::rg32f, gfx::extent(23, 9, 4));
+    image.each_pixel([&](const glm::uvec3& pixel) {
+        const float t = float((pixel.x * 13 + pixel.y * 7 + pixel.z * 3) % 17) / 16.f;
+        image.store(pixel, glm::vec4(t, pixel.y, 0, 1));
+    });
+    const auto box = [&](const glm::uvec3& min, const glm::uvec3& max) {
+        glm::dvec4 sum(0);
+        glm::dvec4 squares(0);
+        double     count = 0;
+        image.each_pixel([&](const glm::uvec3& p) {
+            if (p.x >= min.x && p.y >= min.y && p.z >= min.z && p.x < max.x && p.y < max.y && p.z < max.z) {
+                const glm::dvec4 v(image.load(p));
+                sum += v;
+                squares += v * v;
+                ++count;
+            }
+        });
+        return std::make_tuple(sum, sum / count, squares / count - (sum / count) * (sum / count));
+    };
+
+    SECTION("Box queries match direct sums.")
+    {
+        const gfx::summed_area_table table(image, true);
+        for (const auto& [min, max] : {std::pair(glm::uvec3(0), glm::uvec3(23, 9, 4)), std::pair(glm::uvec3(3, 2, 1), glm::uvec3(17, 5, 3)),
+                                       std::pair(glm::uvec3(22, 0, 3), glm::uvec3(100, 1, 100))}) {
+            const auto [sum, mean, variance] = box(min, max);
+            for (int c = 0; c < 2; ++c) {
+                REQUIRE(table.sum(min, max)[c] == Approx(sum[c]));
+                REQUIRE(table.mean(min, max)[c] == Approx(mean[c]));
+                REQUIRE(table.variance(min, max)[c] == Approx(variance[c]).margin(1e-9));
+            }
+        }
+        REQUIRE(table.sum(glm::uvec3(5, 5, 0), glm::uvec3(5, 9, 4)) == glm::dvec4(0));
+        REQUIRE_THROWS_AS(gfx::summed_area_table(image).variance(glm::uvec3(0), glm::uvec3(1)), std::invalid_argument);
+    }
+
+    SECTION("Box blurs average the clipped boxes around every pixel.")
+    {
+        const gfx::himage blurred = gfx::box_blur(image, glm::uvec3(2, 1, 0));
+        REQUIRE(blurred.pixel_format() == gfx::rg32f);
+        for (const glm::uvec3 p : {glm::uvec3(0, 0, 0), glm::uvec3(10, 4, 2), glm::uvec3(22, 8, 3)}) {
+            const glm::uvec3 min(p.x - std::min(p.x, 2u), p.y - std::min(p.y, 1u), p.z);
+            const glm::dvec4 mean = std::get<1>(box(min, p + glm::uvec3(3, 2, 1)));
+            REQUIRE(blurred.load(p).r == Approx(mean.r));
+            REQUIRE(blurred.load(p).g == Approx(mean.g));
+        }
+    }
+}
+
+TEST_CASE_METHOD(context_provider, "Feature detection", "[image]")
+{
+    gfx::himage image(gfx::rgba8unorm, gfx::extent(150, 100));
+    image.each_pixel([&](const glm::uvec3& pixel) {
+        const bool inside = pixel.x >= 40 && pixel.x < 110 && pixel.y >= 30 && pixel.y < 70;
+        image.store(pixel, inside ? glm::vec4(1) : glm::vec4(0, 0, 0, 1));
+    });
+    const std::vector<glm::ivec2> corners{{40, 30}, {109, 30}, {40, 69}, {109, 69}};
+    const auto                    find_corners = [&](const std::vector<gfx::feature>& features) {
+        REQUIRE(features.size() == 4);
+        for (const auto& corner : corners) {
+            REQUIRE(std::count_if(features.begin(), features.end(), [&](const gfx::feature& f) {
+                        const glm::ivec2 d = glm::abs(glm::ivec2(f.position) - corner);
+                        return d.x <= 1 && d.y <= 1;
+                    }) == 1);
+        }
+        for (size_t i = 1; i < features.size(); ++i) REQUIRE(features[i - 1].response >= features[i].response);
+    };
+
+    SECTION("Corners of a rectangle are found by both responses.")
+    {
+        gfx::feature_options options;
+        options.threshold          = 0.1f;
+        options.suppression_radius = 5;
+        find_corners(gfx::detect_features(image, options));
+
+        options.response = gfx::corner_response::shi_tomasi;
+        find_corners(gfx::detect_features(image, options));
+    }
+
+    SECTION("Results do not depend on the layout and can be limited to the strongest features.")
+    {
+        gfx::feature_options options;
+        options.threshold          = 0.1f;
+        options.suppression_radius = 5;
+        const std::vector<gfx::feature> linear = gfx::detect_features(image, options);
+        const std::vector<gfx::feature> tiled  = gfx::detect_features(image.with_layout(gfx::image_layout::tiled), options);
+        REQUIRE(linear.size() == tiled.size());
+        for (size_t i = 0; i < linear.size(); ++i) {
+            REQUIRE(linear[i].position == tiled[i].position);
+            REQUIRE(linear[i].response == tiled[i].response);
+        }
+
+        options.max_features = 2;
+        const std::vector<gfx::feature> strongest = gfx::detect_features(image.view(), options);
+        REQUIRE(strongest.size() == 2);
+        REQUIRE(strongest[0].position == linear[0].position);
+        REQUIRE(strongest[1].position == linear[1].position);
+        REQUIRE_THROWS_AS(gfx::detect_features(gfx::himage(gfx::r32u, gfx::extent(4, 4))), std::invalid_argument);
+    }
+}
+
+namespace {
+// Compares a vectorized conversion to converting each pixel with pixel_kernel, for all counts up to the pixel count so
+// that the tails of the vectorized loops are covered. NaNs only have to be NaNs in both results.
+template<gfx::format From, gfx::format To>
+bool same_as_scalar(const std::vector<std::byte>& src)
+{
+    using from_kernel     = gfx::pixel_kernel<From>;
+    using to_kernel       = gfx::pixel_kernel<To>;
+    const auto    convert = gfx::find_pixel_conversion(From, To);
+    const size_t  count   = src.size() / from_kernel::size;
+    if (!convert) return false;
+
+    std::vector<std::byte> fast(count * to_kernel::size);
+    std::vector<std::byte> scalar(count * to_kernel::size);
+    for (size_t i = 0; i < count; ++i) to_kernel::store(&scalar[i * to_kernel::size], from_kernel::load(&src[i * from_kernel::size]));
+    for (size_t n = 0; n <= count; n = n < 17 ? n + 1 : std::max(count, n + 1))
+    {
+        std::fill(fast.begin(), fast.end(), std::byte(0xcd));
+        convert(src.data(), fast.data(), n);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const std::byte* a = &fast[i * to_kernel::size];
+            const std::byte* b = &scalar[i * to_kernel::size];
+            if (i >= n)
+            {
+                // Pixels after the converted ones are never written.
+                if (std::any_of(a, a + to_kernel::size, [](std::byte x) { return x != std::byte(0xcd); })) return false;
+                continue;
+            }
+            if (memcmp(a, b, to_kernel::size) == 0) continue;
+            const auto va = to_kernel::load(a);
+            const auto vb = to_kernel::load(b);
+            for (int c = 0; c < 4; ++c)
+                if (!(va[c] == vb[c] || (std::isnan(va[c]) && std::isnan(vb[c])))) return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+std::vector<std::byte> bytes_of(const std::vector<T>& values)
+{
+    std::vector<std::byte> result(values.size() * sizeof(T));
+    memcpy(result.data(), values.data(), result.size());
+    return result;
+}
+}    // namespace
+
+TEST_CASE_METHOD(context_provider, "Pixel conversion kernels", "[image]")
+{
+    // Rounding edges of all target formats, values out of their ranges, subnormal floats and halfs, and infinities.
+    std::vector<float> floats{0.f,        -0.f,          1.f,           -1.f,          0.5f,           0.185425f,     0.5f / 255.f,
+                              1.5f / 255.f, 254.5f / 255.f, 2.f,         65504.f,        65519.f,       65520.f,       1e6f,
+                              -1e6f,      1e-40f,        -1e-40f,       1.17549435e-38f, 5.96046448e-8f, 2.98023224e-8f, 8.94069672e-8f,
+                              6.1e-5f,    6.09755516e-5f, 1e-20f,       3e38f,          std::numeric_limits<float>::infinity(),
+                              -std::numeric_limits<float>::infinity()};
+    std::mt19937                          random(5);
+    std::uniform_real_distribution<float> distribution(-0.25f, 1.25f);
+    for (int i = 0; i < 1000; ++i) floats.push_back(distribution(random));
+    std::vector<float> with_nan = floats;
+    for (int i = 0; i < 16; ++i)
+    {
+        const uint32_t bits = 0x7f800001u + uint32_t(random() % 0x7fffff) + (i % 2 ? 0x80000000u : 0u);
+        float          nan;
+        memcpy(&nan, &bits, sizeof(nan));
+        with_nan.insert(with_nan.begin() + 5 * i, nan);
+    }
+
+    std::vector<uint8_t> bytes(4 * 301);
+    for (auto& b : bytes) b = uint8_t(random());
+    std::vector<uint16_t> halfs(4 * 301);
+    for (size_t i = 0; i < halfs.size(); ++i) halfs[i] = uint16_t(i < 65536 / 64 ? i * 64 + i % 64 : random());
+
+    SECTION("Vectorized conversions give the same results as the per-pixel kernels.")
+    {
+        REQUIRE((same_as_scalar<gfx::rgba8unorm, gfx::rgba32f>(bytes_of(bytes))));
+        REQUIRE((same_as_scalar<gfx::rgba32f, gfx::rgba8unorm>(bytes_of(floats))));
+        REQUIRE((same_as_scalar<gfx::rgba32f, gfx::rgba16f>(bytes_of(with_nan))));
+        REQUIRE((same_as_scalar<gfx::rgba16f, gfx::rgba32f>(bytes_of(halfs))));
+        REQUIRE((same_as_scalar<gfx::rgba32f, gfx::r11g11b10f>(bytes_of(with_nan))));
+        REQUIRE((same_as_scalar<gfx::rgba32f, gfx::rgb9e5>(bytes_of(floats))));
+        REQUIRE((same_as_scalar<gfx::rgb8unorm, gfx::rgba8unorm>(bytes_of(bytes))));
+        REQUIRE((same_as_scalar<gfx::rgb32f, gfx::rgba32f>(bytes_of(with_nan))));
+    }
+
+    SECTION("Halfs are rounded to nearest even.")
+    {
+        gfx::himage image(gfx::rgba16f, gfx::extent(1, 1));
+        image.store({0, 0, 0}, glm::vec4(0.185425f, 1.f + 1.f / 2048.f, 1.f + 3.f / 2048.f, 65520.f));
+        const glm::vec4 value = image.load({0, 0, 0});
+        REQUIRE(value.x == 0.1854248046875f);
+        REQUIRE(value.y == 1.f);
+        REQUIRE(value.z == 1.f + 2.f / 1024.f);
+        REQUIRE(std::isinf(value.w));
+    }
+}